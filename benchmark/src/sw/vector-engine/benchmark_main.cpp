@@ -0,0 +1,97 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "sw/vector-engine/errors.h"
+#include "sw/vector-engine/logger.h"
+#include "utils.h"
+#include "pipeline_benchmark.h"
+#include "skew_benchmark.h"
+#include "insert_benchmark.h"
+#include "hnsw_benchmark.h"
+#include "ivf_pq_benchmark.h"
+#include "concurrent_insert_benchmark.h"
+#include "pq_scan_benchmark.h"
+#include "sq8_benchmark.h"
+
+namespace {
+
+template <typename Benchmark>
+void run_benchmark(const sw::vengine::benchmark::BenchmarkOptions &opts) {
+    Benchmark benchmark(opts);
+    benchmark.run();
+}
+
+using BenchmarkFunc = void (*)(const sw::vengine::benchmark::BenchmarkOptions &);
+
+// pair<name, benchmark>, and options of each benchmark are documented in its header.
+const std::vector<std::pair<std::string, BenchmarkFunc>> BENCHMARKS = {
+    {"pipeline", run_benchmark<sw::vengine::benchmark::PipelineBenchmark>},
+    {"skew", run_benchmark<sw::vengine::benchmark::SkewBenchmark>},
+    {"insert", run_benchmark<sw::vengine::benchmark::InsertBenchmark>},
+    {"hnsw", run_benchmark<sw::vengine::benchmark::HnswBenchmark>},
+    {"ivf_pq", run_benchmark<sw::vengine::benchmark::IvfPqBenchmark>},
+    {"concurrent_insert", run_benchmark<sw::vengine::benchmark::ConcurrentInsertBenchmark>},
+    {"pq_scan", run_benchmark<sw::vengine::benchmark::PqScanBenchmark>},
+    {"sq8", run_benchmark<sw::vengine::benchmark::Sq8Benchmark>}
+};
+
+void print_help() {
+    std::cerr << "Usage: vector-engine-benchmark <benchmark name> [--option value]...\n";
+    std::cerr << "Benchmarks:\n";
+    for (const auto &benchmark : BENCHMARKS) {
+        std::cerr << "    " << benchmark.first << "\n";
+    }
+}
+
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        print_help();
+        return 1;
+    }
+
+    std::string name = argv[1];
+
+    try {
+        sw::vengine::LoggerOptions logger_opts;
+        logger_opts.path = "logs/vector-engine-benchmark.log";
+        sw::vengine::Logger::instance().init(logger_opts);
+
+        sw::vengine::benchmark::BenchmarkOptions opts(argc, argv, 2);
+
+        for (const auto &[benchmark_name, benchmark] : BENCHMARKS) {
+            if (name == benchmark_name) {
+                benchmark(opts);
+                return 0;
+            }
+        }
+
+        print_help();
+        return 1;
+    } catch (const sw::vengine::Error &e) {
+        std::cerr << "Benchmark failed: " << e.what() << std::endl;
+        return 1;
+    } catch (const std::exception &e) {
+        std::cerr << "Benchmark failed with unexpected exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
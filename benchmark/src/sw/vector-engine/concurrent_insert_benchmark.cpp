@@ -0,0 +1,110 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#include "concurrent_insert_benchmark.h"
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include "sw/vector-engine/errors.h"
+#include "sw/vector-engine/vector_collection.h"
+
+namespace sw::vengine::benchmark {
+
+ConcurrentInsertBenchmark::ConcurrentInsertBenchmark(const BenchmarkOptions &opts) :
+    _vectors(opts.get("vectors", std::size_t(100000))),
+    _dim(opts.get("dim", std::size_t(128))),
+    _clusters(opts.get("clusters", std::size_t(100))),
+    _queries(opts.get("queries", std::size_t(1000))),
+    _k(opts.get("k", std::size_t(10))),
+    _max_threads(opts.get("max-threads", std::size_t(16))) {
+    if (_vectors == 0 || _dim == 0 || _k == 0 || _max_threads == 0) {
+        throw Error("vectors, dim, k and max-threads must be positive");
+    }
+
+    _index_opts.type = IndexType::HNSW;
+}
+
+void ConcurrentInsertBenchmark::run() {
+    auto vecs = clustered_vectors(_vectors, _dim, _clusters, 1);
+    auto queries = clustered_vectors(_queries, _dim, _clusters, 2);
+
+    VectorCollection exact(_dim);
+    add_vectors(exact, vecs);
+    auto neighbors = exact_neighbors(exact, queries, _k);
+
+    std::cout << "vectors: " << _vectors << ", dim: " << _dim << ", clusters: " << _clusters
+                << ", hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << std::setw(8) << "threads"
+                << std::setw(14) << "inserts/s"
+                << std::setw(10) << "speedup"
+                << std::setw(12) << "recall@" + std::to_string(_k) << std::endl;
+
+    double base = 0;
+    for (std::size_t threads = 1; threads <= _max_threads; threads *= 2) {
+        auto result = _run(threads, vecs, queries, neighbors);
+        if (threads == 1) {
+            base = result.inserts_per_second;
+        }
+
+        std::cout << std::fixed
+                    << std::setw(8) << threads
+                    << std::setw(14) << std::setprecision(0) << result.inserts_per_second
+                    << std::setw(10) << std::setprecision(2) << result.inserts_per_second / base
+                    << std::setw(12) << std::setprecision(4) << result.recall << std::endl;
+    }
+}
+
+ConcurrentInsertBenchmark::Result ConcurrentInsertBenchmark::_run(std::size_t threads,
+        const std::vector<float> &vecs,
+        const std::vector<float> &queries,
+        const std::vector<std::unordered_set<std::string>> &neighbors) const {
+    // Keys are built before the measurement.
+    std::vector<std::string> keys;
+    keys.reserve(_vectors);
+    for (std::size_t idx = 0; idx != _vectors; ++idx) {
+        keys.push_back(std::to_string(idx));
+    }
+
+    VectorCollection collection(_dim, Metric::L2, _index_opts);
+
+    // Each thread inserts an interleaved share of vectors, so that all threads
+    // grow the same regions of the graph at the same time.
+    auto start = Clock::now();
+    std::vector<std::thread> inserters;
+    for (std::size_t thread = 0; thread != threads; ++thread) {
+        inserters.emplace_back([&, thread]() {
+            for (auto idx = thread; idx < _vectors; idx += threads) {
+                collection.add(keys[idx], vecs.data() + idx * _dim);
+            }
+        });
+    }
+
+    for (auto &inserter : inserters) {
+        inserter.join();
+    }
+    auto seconds = elapsed_seconds(start);
+
+    SearchOptions opts;
+    opts.k = _k;
+
+    Result result;
+    result.inserts_per_second = _vectors / seconds;
+    result.recall = measure_search(collection, queries, opts, neighbors).recall;
+
+    return result;
+}
+
+}
@@ -0,0 +1,75 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#ifndef SW_VECTOR_ENGINE_BENCHMARK_CONCURRENT_INSERT_BENCHMARK_H
+#define SW_VECTOR_ENGINE_BENCHMARK_CONCURRENT_INSERT_BENCHMARK_H
+
+#include <cstddef>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "sw/vector-engine/index.h"
+#include "utils.h"
+
+namespace sw::vengine::benchmark {
+
+// Bulk load an HNSW collection of synthetic clustered data from 1, 2, 4, ... threads,
+// which insert concurrently, and report insert throughput, speedup over a single
+// thread, and recall@k of the final index, which shouldn't drop with more threads.
+//
+// Options:
+//     --vectors: number of vectors, default 100000
+//     --dim: dimension of vectors, default 128
+//     --clusters: number of clusters, default 100
+//     --queries: number of queries, default 1000
+//     --k: number of neighbors, default 10
+//     --max-threads: max number of inserting threads, default 16
+class ConcurrentInsertBenchmark {
+public:
+    explicit ConcurrentInsertBenchmark(const BenchmarkOptions &opts);
+
+    void run();
+
+private:
+    struct Result {
+        double inserts_per_second = 0;
+
+        double recall = 0;
+    };
+
+    Result _run(std::size_t threads,
+                const std::vector<float> &vecs,
+                const std::vector<float> &queries,
+                const std::vector<std::unordered_set<std::string>> &neighbors) const;
+
+    std::size_t _vectors = 0;
+
+    std::size_t _dim = 0;
+
+    std::size_t _clusters = 0;
+
+    std::size_t _queries = 0;
+
+    std::size_t _k = 0;
+
+    std::size_t _max_threads = 0;
+
+    IndexOptions _index_opts;
+};
+
+}
+
+#endif // end SW_VECTOR_ENGINE_BENCHMARK_CONCURRENT_INSERT_BENCHMARK_H
@@ -0,0 +1,84 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#include "hnsw_benchmark.h"
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "sw/vector-engine/errors.h"
+#include "sw/vector-engine/vector_collection.h"
+
+namespace sw::vengine::benchmark {
+
+HnswBenchmark::HnswBenchmark(const BenchmarkOptions &opts) :
+    _vectors(opts.get("vectors", std::size_t(100000))),
+    _dim(opts.get("dim", std::size_t(128))),
+    _clusters(opts.get("clusters", std::size_t(100))),
+    _queries(opts.get("queries", std::size_t(1000))),
+    _k(opts.get("k", std::size_t(10))),
+    _ef(opts.get("ef", std::size_t(0))) {
+    if (_vectors == 0 || _dim == 0 || _k == 0) {
+        throw Error("vectors, dim and k must be positive");
+    }
+
+    _index_opts.type = IndexType::HNSW;
+    _index_opts.m = opts.get("m", _index_opts.m);
+    _index_opts.ef_construction = opts.get("ef-construction", _index_opts.ef_construction);
+}
+
+void HnswBenchmark::run() {
+    auto vecs = clustered_vectors(_vectors, _dim, _clusters, 1);
+    auto queries = clustered_vectors(_queries, _dim, _clusters, 2);
+
+    VectorCollection exact(_dim);
+    add_vectors(exact, vecs);
+    auto neighbors = exact_neighbors(exact, queries, _k);
+
+    VectorCollection hnsw(_dim, Metric::L2, _index_opts);
+    auto start = Clock::now();
+    add_vectors(hnsw, vecs);
+    auto seconds = elapsed_seconds(start);
+
+    SearchOptions opts;
+    opts.k = _k;
+
+    std::cout << "vectors: " << _vectors << ", dim: " << _dim << ", clusters: " << _clusters
+                << ", m: " << _index_opts.m << ", ef_construction: " << _index_opts.ef_construction << std::endl;
+    std::cout << std::fixed << std::setprecision(0)
+                << "build: " << seconds << "s, " << _vectors / seconds << " inserts/s, "
+                << hnsw.memory_usage() / _vectors << " bytes/vector" << std::endl;
+    std::cout << "FLAT: " << measure_search(exact, queries, opts, neighbors).qps << " qps" << std::endl;
+
+    std::cout << std::setw(8) << "ef"
+                << std::setw(12) << "qps"
+                << std::setw(12) << "recall@" + std::to_string(_k) << std::endl;
+
+    std::vector<std::size_t> efs = {10, 20, 40, 80, 160, 320};
+    if (_ef != 0) {
+        efs = {_ef};
+    }
+
+    for (auto ef : efs) {
+        opts.ef = ef;
+        auto stats = measure_search(hnsw, queries, opts, neighbors);
+        std::cout << std::setw(8) << ef
+                    << std::setw(12) << std::setprecision(0) << stats.qps
+                    << std::setw(12) << std::setprecision(4) << stats.recall << std::endl;
+    }
+}
+
+}
@@ -0,0 +1,63 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#ifndef SW_VECTOR_ENGINE_BENCHMARK_HNSW_BENCHMARK_H
+#define SW_VECTOR_ENGINE_BENCHMARK_HNSW_BENCHMARK_H
+
+#include <cstddef>
+#include "sw/vector-engine/index.h"
+#include "utils.h"
+
+namespace sw::vengine::benchmark {
+
+// Build an HNSW collection of synthetic clustered data, and report recall@k and
+// single thread QPS of each ef, where the exact neighbors are found by FLAT.
+//
+// Options:
+//     --vectors: number of vectors, default 100000
+//     --dim: dimension of vectors, default 128
+//     --clusters: number of clusters, default 100
+//     --queries: number of queries, default 1000
+//     --k: number of neighbors, default 10
+//     --m: max number of neighbors of a node, default 16
+//     --ef-construction: size of the candidate list when inserting, default 200
+//     --ef: size of the candidate list when searching, and 0 runs 10, 20, 40, 80, 160 and 320, default 0
+class HnswBenchmark {
+public:
+    explicit HnswBenchmark(const BenchmarkOptions &opts);
+
+    void run();
+
+private:
+    std::size_t _vectors = 0;
+
+    std::size_t _dim = 0;
+
+    std::size_t _clusters = 0;
+
+    std::size_t _queries = 0;
+
+    std::size_t _k = 0;
+
+    std::size_t _ef = 0;
+
+    IndexOptions _index_opts;
+};
+
+}
+
+#endif // end SW_VECTOR_ENGINE_BENCHMARK_HNSW_BENCHMARK_H
@@ -0,0 +1,97 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#include "insert_benchmark.h"
+#include <iomanip>
+#include <iostream>
+#include "sw/vector-engine/errors.h"
+#include "sw/vector-engine/vector_collection.h"
+
+namespace sw::vengine::benchmark {
+
+InsertBenchmark::InsertBenchmark(const BenchmarkOptions &opts) :
+    _vectors(opts.get("vectors", std::size_t(100000))),
+    _dim(opts.get("dim", std::size_t(128))) {
+    if (_vectors == 0 || _dim == 0) {
+        throw Error("vectors and dim must be positive");
+    }
+
+    _index_opts.type = parse_index_type(opts.get("index", std::string("FLAT")));
+
+    auto type = opts.get("type", std::string());
+    if (type.empty()) {
+        _types = {ElementType::FLOAT32, ElementType::FLOAT16, ElementType::BFLOAT16};
+    } else {
+        _types = {parse_element_type(type)};
+    }
+}
+
+void InsertBenchmark::run() {
+    std::cout << "vectors: " << _vectors << ", dim: " << _dim
+                << ", index: " << to_string(_index_opts.type)
+                << ", raw bytes/vector: " << _dim * sizeof(float) << std::endl;
+    std::cout << std::setw(8) << "type"
+                << std::setw(14) << "inserts/s"
+                << std::setw(14) << "bytes/vector"
+                << std::setw(14) << "vs raw"
+                << std::setw(16) << "after reuse" << std::endl;
+
+    for (auto type : _types) {
+        _run(type);
+    }
+}
+
+void InsertBenchmark::_run(ElementType type) {
+    auto vecs = random_vectors(_vectors, _dim);
+
+    // Keys are built before the measurement.
+    std::vector<std::string> keys;
+    keys.reserve(_vectors * 3 / 2);
+    for (std::size_t idx = 0; idx != keys.capacity(); ++idx) {
+        keys.push_back(std::to_string(idx));
+    }
+
+    VectorCollection collection(_dim, Metric::L2, _index_opts, type);
+
+    auto start = Clock::now();
+    for (std::size_t idx = 0; idx != _vectors; ++idx) {
+        collection.add(keys[idx], vecs.data() + idx * _dim);
+    }
+    auto seconds = elapsed_seconds(start);
+
+    auto bytes = static_cast<double>(collection.memory_usage()) / _vectors;
+
+    // Remove every other vector, and add them back with new keys.
+    for (std::size_t idx = 0; idx < _vectors; idx += 2) {
+        collection.remove(keys[idx]);
+    }
+
+    for (std::size_t idx = 0; idx < _vectors; idx += 2) {
+        collection.add(keys[_vectors + idx / 2], vecs.data() + idx * _dim);
+    }
+
+    auto reused = static_cast<double>(collection.memory_usage()) / collection.size();
+
+    std::cout << std::fixed << std::setprecision(0)
+                << std::setw(8) << to_string(type)
+                << std::setw(14) << _vectors / seconds
+                << std::setw(14) << bytes
+                << std::setw(14) << std::setprecision(2) << bytes / (_dim * sizeof(float))
+                << std::setw(16) << std::setprecision(0) << reused << std::endl;
+}
+
+}
@@ -0,0 +1,60 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#ifndef SW_VECTOR_ENGINE_BENCHMARK_INSERT_BENCHMARK_H
+#define SW_VECTOR_ENGINE_BENCHMARK_INSERT_BENCHMARK_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "sw/vector-engine/element_type.h"
+#include "sw/vector-engine/index.h"
+#include "utils.h"
+
+namespace sw::vengine::benchmark {
+
+// Insert random vectors into a VectorCollection, and report insert throughput and
+// memory per vector, compared with the raw float32 vector. Then half of the vectors
+// are removed and added again with new keys, which reuses ids of removed ones,
+// and memory shouldn't grow.
+//
+// Options:
+//     --vectors: number of vectors, default 100000
+//     --dim: dimension of vectors, default 128
+//     --index: index type, default FLAT
+//     --type: element type, and empty runs FP32, FP16 and BF16, default empty
+class InsertBenchmark {
+public:
+    explicit InsertBenchmark(const BenchmarkOptions &opts);
+
+    void run();
+
+private:
+    void _run(ElementType type);
+
+    std::size_t _vectors = 0;
+
+    std::size_t _dim = 0;
+
+    IndexOptions _index_opts;
+
+    std::vector<ElementType> _types;
+};
+
+}
+
+#endif // end SW_VECTOR_ENGINE_BENCHMARK_INSERT_BENCHMARK_H
@@ -0,0 +1,116 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#include "ivf_pq_benchmark.h"
+#include <iomanip>
+#include <iostream>
+#include "sw/vector-engine/errors.h"
+#include "sw/vector-engine/vector_collection.h"
+
+namespace sw::vengine::benchmark {
+
+IvfPqBenchmark::IvfPqBenchmark(const BenchmarkOptions &opts) :
+    _vectors(opts.get("vectors", std::size_t(100000))),
+    _dim(opts.get("dim", std::size_t(128))),
+    _clusters(opts.get("clusters", std::size_t(100))),
+    _queries(opts.get("queries", std::size_t(1000))),
+    _k(opts.get("k", std::size_t(10))),
+    _nlist(opts.get("nlist", std::size_t(256))),
+    _pq_m(opts.get("pq-m", std::size_t(16))),
+    _rerank(opts.get("rerank", std::size_t(4))) {
+    if (_vectors == 0 || _dim == 0 || _k == 0 || _nlist == 0) {
+        throw Error("vectors, dim, k and nlist must be positive");
+    }
+
+    if (_pq_m == 0 || _dim % _pq_m != 0) {
+        throw Error("pq-m must divide dim");
+    }
+}
+
+void IvfPqBenchmark::run() {
+    auto vecs = clustered_vectors(_vectors, _dim, _clusters, 1);
+    auto queries = clustered_vectors(_queries, _dim, _clusters, 2);
+
+    VectorCollection exact(_dim);
+    add_vectors(exact, vecs);
+    auto neighbors = exact_neighbors(exact, queries, _k);
+
+    SearchOptions opts;
+    opts.k = _k;
+
+    std::cout << "vectors: " << _vectors << ", dim: " << _dim << ", clusters: " << _clusters
+                << ", nlist: " << _nlist << ", pq_m: " << _pq_m << std::endl;
+    std::cout << std::fixed << std::setprecision(0)
+                << "FLAT: " << exact.memory_usage() / _vectors << " bytes/vector, "
+                << measure_search(exact, queries, opts, neighbors).qps << " qps" << std::endl;
+
+    IndexOptions index_opts;
+    index_opts.type = IndexType::IVF;
+    index_opts.nlist = _nlist;
+    _run("IVF", index_opts, vecs, queries, neighbors);
+
+    index_opts.type = IndexType::IVF_PQ;
+    index_opts.pq_m = _pq_m;
+    for (std::size_t bits : {8, 4}) {
+        index_opts.pq_bits = bits;
+
+        index_opts.rerank = 0;
+        _run("IVF_PQ" + std::to_string(bits), index_opts, vecs, queries, neighbors);
+
+        if (_rerank != 0) {
+            index_opts.rerank = _rerank;
+            _run("IVF_PQ" + std::to_string(bits) + " RERANK " + std::to_string(_rerank),
+                    index_opts, vecs, queries, neighbors);
+        }
+    }
+}
+
+void IvfPqBenchmark::_run(const std::string &name,
+                            const IndexOptions &index_opts,
+                            const std::vector<float> &vecs,
+                            const std::vector<float> &queries,
+                            const std::vector<std::unordered_set<std::string>> &neighbors) const {
+    VectorCollection collection(_dim, Metric::L2, index_opts);
+
+    // It's trained by the add that reaches enough vectors.
+    auto start = Clock::now();
+    add_vectors(collection, vecs);
+    auto seconds = elapsed_seconds(start);
+
+    std::cout << std::fixed << std::setprecision(0)
+                << name << ": build " << std::setprecision(1) << seconds << "s, "
+                << std::setprecision(0) << collection.memory_usage() / _vectors << " bytes/vector" << std::endl;
+    std::cout << std::setw(8) << "nprobe"
+                << std::setw(12) << "qps"
+                << std::setw(12) << "recall@" + std::to_string(_k) << std::endl;
+
+    SearchOptions opts;
+    opts.k = _k;
+    for (std::size_t nprobe : {1, 4, 16, 64}) {
+        if (nprobe > _nlist) {
+            break;
+        }
+
+        opts.nprobe = nprobe;
+        auto stats = measure_search(collection, queries, opts, neighbors);
+        std::cout << std::setw(8) << nprobe
+                    << std::setw(12) << std::setprecision(0) << stats.qps
+                    << std::setw(12) << std::setprecision(4) << stats.recall << std::endl;
+    }
+}
+
+}
@@ -0,0 +1,75 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#ifndef SW_VECTOR_ENGINE_BENCHMARK_IVF_PQ_BENCHMARK_H
+#define SW_VECTOR_ENGINE_BENCHMARK_IVF_PQ_BENCHMARK_H
+
+#include <cstddef>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "sw/vector-engine/index.h"
+#include "utils.h"
+
+namespace sw::vengine::benchmark {
+
+// Build IVF and IVF_PQ collections of synthetic clustered data, with 8-bit and 4-bit
+// codes, and with and without re-ranking. Report memory per vector, and recall@k and
+// single thread QPS of each nprobe, where the exact neighbors are found by FLAT.
+//
+// Options:
+//     --vectors: number of vectors, default 100000
+//     --dim: dimension of vectors, default 128
+//     --clusters: number of clusters, default 100
+//     --queries: number of queries, default 1000
+//     --k: number of neighbors, default 10
+//     --nlist: number of inverted lists, default 256
+//     --pq-m: number of sub-quantizers, which must divide dim, default 16
+//     --rerank: re-rank factor of the re-ranking runs, default 4
+class IvfPqBenchmark {
+public:
+    explicit IvfPqBenchmark(const BenchmarkOptions &opts);
+
+    void run();
+
+private:
+    void _run(const std::string &name,
+                const IndexOptions &index_opts,
+                const std::vector<float> &vecs,
+                const std::vector<float> &queries,
+                const std::vector<std::unordered_set<std::string>> &neighbors) const;
+
+    std::size_t _vectors = 0;
+
+    std::size_t _dim = 0;
+
+    std::size_t _clusters = 0;
+
+    std::size_t _queries = 0;
+
+    std::size_t _k = 0;
+
+    std::size_t _nlist = 0;
+
+    std::size_t _pq_m = 0;
+
+    std::size_t _rerank = 0;
+};
+
+}
+
+#endif // end SW_VECTOR_ENGINE_BENCHMARK_IVF_PQ_BENCHMARK_H
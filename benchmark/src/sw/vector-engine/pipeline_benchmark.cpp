@@ -0,0 +1,165 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#include "pipeline_benchmark.h"
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "sw/vector-engine/errors.h"
+#include "resp_client.h"
+
+namespace sw::vengine::benchmark {
+
+PipelineBenchmark::PipelineBenchmark(const BenchmarkOptions &opts) :
+    _host(opts.get("host", std::string("127.0.0.1"))),
+    _port(static_cast<int>(opts.get("port", std::size_t(7777)))),
+    _connections(opts.get("connections", std::size_t(16))),
+    _requests(opts.get("requests", std::size_t(200000))),
+    _pipeline(opts.get("pipeline", std::size_t(0))),
+    _server_pid(opts.get("server-pid", std::size_t(0))) {
+    if (_connections == 0) {
+        throw Error("number of connections must be positive");
+    }
+}
+
+void PipelineBenchmark::run() {
+    std::cout << "connections: " << _connections << ", requests: " << _requests << std::endl;
+    std::cout << std::setw(10) << "pipeline"
+                << std::setw(14) << "replies/s"
+                << std::setw(14) << "p50 (us)"
+                << std::setw(14) << "p99 (us)"
+                << std::setw(14) << "reads/reply"
+                << std::setw(14) << "writes/reply" << std::endl;
+
+    if (_pipeline != 0) {
+        _run(_pipeline);
+    } else {
+        const std::size_t depths[] = {1, 4, 16, 64};
+        for (auto pipeline : depths) {
+            _run(pipeline);
+        }
+    }
+}
+
+void PipelineBenchmark::_run(std::size_t pipeline) {
+    auto batches = (_requests / _connections + pipeline - 1) / pipeline;
+
+    std::string batch;
+    auto ping = resp_command({"PING"});
+    for (std::size_t idx = 0; idx != pipeline; ++idx) {
+        batch += ping;
+    }
+
+    // Connect before the measurement.
+    std::vector<std::unique_ptr<RespClient>> clients;
+    for (std::size_t idx = 0; idx != _connections; ++idx) {
+        clients.push_back(std::make_unique<RespClient>(_host, _port));
+    }
+
+    // Round-trip time of each batch in microseconds.
+    std::vector<std::vector<double>> latencies(_connections);
+    std::vector<std::size_t> errors(_connections, 0);
+
+    auto syscalls = _server_syscalls();
+    auto start = Clock::now();
+
+    std::vector<std::thread> threads;
+    for (std::size_t idx = 0; idx != _connections; ++idx) {
+        threads.emplace_back([&, idx]() {
+            auto &client = *clients[idx];
+            auto &latency = latencies[idx];
+            latency.reserve(batches);
+            try {
+                for (std::size_t round = 0; round != batches; ++round) {
+                    auto sent = Clock::now();
+                    client.send(batch);
+                    errors[idx] += client.recv(pipeline);
+                    latency.push_back(elapsed_seconds(sent) * 1e6);
+                }
+            } catch (const Error &e) {
+                std::cerr << "connection " << idx << " failed: " << e.what() << std::endl;
+                errors[idx] += 1;
+            }
+        });
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    auto seconds = elapsed_seconds(start);
+    auto [reads, writes] = _server_syscalls();
+    reads -= syscalls.first;
+    writes -= syscalls.second;
+
+    std::vector<double> samples;
+    std::size_t error_num = 0;
+    for (std::size_t idx = 0; idx != _connections; ++idx) {
+        samples.insert(samples.end(), latencies[idx].begin(), latencies[idx].end());
+        error_num += errors[idx];
+    }
+
+    if (error_num != 0) {
+        throw Error("failed requests: " + std::to_string(error_num));
+    }
+
+    double replies = static_cast<double>(batches * pipeline * _connections);
+    std::cout << std::fixed << std::setprecision(2)
+                << std::setw(10) << pipeline
+                << std::setw(14) << std::setprecision(0) << replies / seconds
+                << std::setw(14) << percentile(samples, 50)
+                << std::setw(14) << percentile(samples, 99)
+                << std::setprecision(4);
+    if (_server_pid != 0) {
+        std::cout << std::setw(14) << reads / replies
+                    << std::setw(14) << writes / replies;
+    } else {
+        std::cout << std::setw(14) << "-" << std::setw(14) << "-";
+    }
+    std::cout << std::endl;
+}
+
+std::pair<std::size_t, std::size_t> PipelineBenchmark::_server_syscalls() const {
+    if (_server_pid == 0) {
+        return {0, 0};
+    }
+
+    auto path = "/proc/" + std::to_string(_server_pid) + "/io";
+    std::ifstream file(path);
+    if (!file) {
+        throw Error("failed to open " + path);
+    }
+
+    std::size_t reads = 0;
+    std::size_t writes = 0;
+    std::string name;
+    std::size_t val = 0;
+    while (file >> name >> val) {
+        if (name == "syscr:") {
+            reads = val;
+        } else if (name == "syscw:") {
+            writes = val;
+        }
+    }
+
+    return {reads, writes};
+}
+
+}
@@ -0,0 +1,69 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#ifndef SW_VECTOR_ENGINE_BENCHMARK_PIPELINE_BENCHMARK_H
+#define SW_VECTOR_ENGINE_BENCHMARK_PIPELINE_BENCHMARK_H
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include "utils.h"
+
+namespace sw::vengine::benchmark {
+
+// Send pipelined PINGs to a running server, and report throughput, latency of
+// batches and, if the server pid is given, syscalls of the server per reply.
+// Since replies of a connection are coalesced into a single vectored write,
+// a batch of `pipeline` requests costs about one write instead of one per reply.
+// Syscalls of the server also include wakeups of event loops, so they're a bit
+// more than one per batch.
+//
+// Options:
+//     --host: server host, default 127.0.0.1
+//     --port: server port, default 7777
+//     --connections: number of connections, each of which runs in a thread, default 16
+//     --requests: number of requests of each pipeline depth, default 200000
+//     --pipeline: pipeline depth, i.e. requests per batch, and 0 runs depths 1, 4, 16 and 64, default 0
+//     --server-pid: pid of the server, whose syscalls are read from /proc/<pid>/io, default 0, i.e. not reported
+class PipelineBenchmark {
+public:
+    explicit PipelineBenchmark(const BenchmarkOptions &opts);
+
+    void run();
+
+private:
+    void _run(std::size_t pipeline);
+
+    // @return pair<read syscalls, write syscalls> of the server so far.
+    std::pair<std::size_t, std::size_t> _server_syscalls() const;
+
+    std::string _host;
+
+    int _port = 0;
+
+    std::size_t _connections = 0;
+
+    std::size_t _requests = 0;
+
+    std::size_t _pipeline = 0;
+
+    std::size_t _server_pid = 0;
+};
+
+}
+
+#endif // end SW_VECTOR_ENGINE_BENCHMARK_PIPELINE_BENCHMARK_H
@@ -0,0 +1,137 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#include "pq_scan_benchmark.h"
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include "sw/vector-engine/distance.h"
+#include "sw/vector-engine/errors.h"
+#include "sw/vector-engine/pq_fast_scan.h"
+#include "sw/vector-engine/vector_collection.h"
+
+namespace sw::vengine::benchmark {
+
+PqScanBenchmark::PqScanBenchmark(const BenchmarkOptions &opts) :
+    _vectors(opts.get("vectors", std::size_t(1000000))),
+    _dim(opts.get("dim", std::size_t(128))),
+    _queries(opts.get("queries", std::size_t(100))),
+    _pq_m(opts.get("pq-m", std::size_t(16))) {
+    if (_vectors == 0 || _dim == 0 || _queries == 0) {
+        throw Error("vectors, dim and queries must be positive");
+    }
+
+    if (_pq_m == 0 || _pq_m % 2 != 0 || _dim % _pq_m != 0) {
+        throw Error("pq-m must be even and divide dim");
+    }
+}
+
+void PqScanBenchmark::run() {
+    auto vecs = random_vectors(_vectors, _dim, 1);
+    auto queries = random_vectors(_queries, _dim, 2);
+
+    std::cout << "vectors: " << _vectors << ", dim: " << _dim << ", pq_m: " << _pq_m
+                << ", simd: " << simd_level() << std::endl;
+    std::cout << std::setw(8) << "bits"
+                << std::setw(16) << "Mcodes/s"
+                << std::setw(10) << "speedup" << std::endl;
+
+    auto base = _scan_index(8, vecs, queries);
+    auto fast = _scan_index(4, vecs, queries);
+    std::cout << std::fixed << std::setprecision(1)
+                << std::setw(8) << 8 << std::setw(16) << base / 1e6 << std::setw(10) << 1.0 << std::endl
+                << std::setw(8) << 4 << std::setw(16) << fast / 1e6 << std::setw(10) << fast / base << std::endl;
+
+    _scan_kernels();
+}
+
+double PqScanBenchmark::_scan_index(std::size_t bits,
+                                    const std::vector<float> &vecs,
+                                    const std::vector<float> &queries) const {
+    // With a single list, each search scans codes of all vectors.
+    IndexOptions index_opts;
+    index_opts.type = IndexType::IVF_PQ;
+    index_opts.nlist = 1;
+    index_opts.nprobe = 1;
+    index_opts.pq_m = _pq_m;
+    index_opts.pq_bits = bits;
+
+    VectorCollection collection(_dim, Metric::L2, index_opts);
+    add_vectors(collection, vecs);
+
+    SearchOptions opts;
+    opts.k = 10;
+
+    auto start = Clock::now();
+    for (std::size_t idx = 0; idx != _queries; ++idx) {
+        collection.search(queries.data() + idx * _dim, opts);
+    }
+    auto seconds = elapsed_seconds(start);
+
+    return static_cast<double>(_vectors) * _queries / seconds;
+}
+
+void PqScanBenchmark::_scan_kernels() const {
+    auto num_blocks = (_vectors + FAST_SCAN_BLOCK - 1) / FAST_SCAN_BLOCK;
+    auto block_size = fast_scan_block_size(_pq_m);
+
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<int> dist(0, 255);
+    std::vector<uint8_t> blocks(num_blocks * block_size);
+    for (auto &byte : blocks) {
+        byte = static_cast<uint8_t>(dist(gen));
+    }
+
+    std::vector<uint8_t> lut(_pq_m * 16);
+    for (auto &entry : lut) {
+        entry = static_cast<uint8_t>(dist(gen));
+    }
+
+    std::vector<uint32_t> dists(FAST_SCAN_BLOCK * num_blocks);
+
+    std::cout << std::setw(8) << "simd"
+                << std::setw(8) << "kernel"
+                << std::setw(16) << "Mcodes/s" << std::endl;
+
+    for (const auto &kernels : detail::fast_scan_kernels()) {
+        // The full kernel only works with `m` of multiple of 4.
+        std::vector<std::pair<std::string, detail::FastScanFunc>> funcs = {{"pair", kernels.pair}};
+        if (_pq_m % 4 == 0) {
+            funcs.emplace_back("full", kernels.full);
+        }
+
+        for (const auto &[name, func] : funcs) {
+            auto start = Clock::now();
+            for (std::size_t query = 0; query != _queries; ++query) {
+                for (std::size_t idx = 0; idx != num_blocks; ++idx) {
+                    func(blocks.data() + idx * block_size, lut.data(), _pq_m, dists.data() + idx * FAST_SCAN_BLOCK);
+                }
+            }
+            auto seconds = elapsed_seconds(start);
+
+            std::cout << std::fixed << std::setprecision(1)
+                        << std::setw(8) << kernels.name
+                        << std::setw(8) << name
+                        << std::setw(16) << static_cast<double>(num_blocks) * FAST_SCAN_BLOCK * _queries / seconds / 1e6
+                        << std::endl;
+        }
+    }
+}
+
+}
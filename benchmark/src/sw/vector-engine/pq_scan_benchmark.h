@@ -0,0 +1,61 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#ifndef SW_VECTOR_ENGINE_BENCHMARK_PQ_SCAN_BENCHMARK_H
+#define SW_VECTOR_ENGINE_BENCHMARK_PQ_SCAN_BENCHMARK_H
+
+#include <cstddef>
+#include <vector>
+#include "utils.h"
+
+namespace sw::vengine::benchmark {
+
+// Compare scans of 8-bit PQ codes, which sum up float lookups, with fast-scans of
+// 4-bit codes, which look up quantized tables in registers. First, IVF_PQ collections
+// with a single list are searched, so that each query scans all codes, and codes
+// scanned per second of both widths are reported. Then fast-scan kernels of every
+// instruction set supported by the CPU, both the full and the pair ones, scan the
+// same blocks, and their throughput is reported.
+//
+// Options:
+//     --vectors: number of vectors, default 1000000
+//     --dim: dimension of vectors, default 128
+//     --queries: number of queries, default 100
+//     --pq-m: number of sub-quantizers, which must be even and divide dim, default 16
+class PqScanBenchmark {
+public:
+    explicit PqScanBenchmark(const BenchmarkOptions &opts);
+
+    void run();
+
+private:
+    // @return codes scanned per second by searches of an IVF_PQ collection with `bits` codes.
+    double _scan_index(std::size_t bits, const std::vector<float> &vecs, const std::vector<float> &queries) const;
+
+    void _scan_kernels() const;
+
+    std::size_t _vectors = 0;
+
+    std::size_t _dim = 0;
+
+    std::size_t _queries = 0;
+
+    std::size_t _pq_m = 0;
+};
+
+}
+
+#endif // end SW_VECTOR_ENGINE_BENCHMARK_PQ_SCAN_BENCHMARK_H
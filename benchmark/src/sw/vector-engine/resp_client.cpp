@@ -0,0 +1,174 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#include "resp_client.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "sw/vector-engine/errors.h"
+
+namespace {
+
+const std::size_t READ_SIZE = 64 * 1024;
+
+}
+
+namespace sw::vengine::benchmark {
+
+std::string resp_command(const std::vector<std::string_view> &args) {
+    std::string request = "*" + std::to_string(args.size()) + "\r\n";
+    for (const auto &arg : args) {
+        request += "$" + std::to_string(arg.size()) + "\r\n";
+        request.append(arg.data(), arg.size());
+        request += "\r\n";
+    }
+
+    return request;
+}
+
+RespClient::RespClient(const std::string &host, int port) {
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+        throw Error("invalid host: " + host);
+    }
+
+    _fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (_fd < 0) {
+        throw Error("failed to create socket: " + std::string(std::strerror(errno)));
+    }
+
+    if (::connect(_fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+        auto err = errno;
+        ::close(_fd);
+        throw Error("failed to connect " + host + ":" + std::to_string(port) + ": " + std::strerror(err));
+    }
+
+    // Requests are sent in batches, and shouldn't wait for replies of previous ones.
+    int flag = 1;
+    ::setsockopt(_fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+}
+
+RespClient::~RespClient() {
+    ::close(_fd);
+}
+
+void RespClient::send(const std::string_view &data) {
+    std::size_t sent = 0;
+    while (sent < data.size()) {
+        auto len = ::send(_fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (len < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            throw Error("failed to send requests: " + std::string(std::strerror(errno)));
+        }
+
+        sent += static_cast<std::size_t>(len);
+    }
+}
+
+std::size_t RespClient::recv(std::size_t num) {
+    std::size_t errors = 0;
+    std::size_t pos = 0;
+    while (num > 0) {
+        auto error = false;
+        auto end = _parse_reply(pos, error);
+        if (end != std::string::npos) {
+            pos = end;
+            errors += error ? 1 : 0;
+            --num;
+            continue;
+        }
+
+        // Drop parsed replies before reading more.
+        _buffer.erase(0, pos);
+        pos = 0;
+
+        auto size = _buffer.size();
+        _buffer.resize(size + READ_SIZE);
+        auto len = ::recv(_fd, _buffer.data() + size, READ_SIZE, 0);
+        if (len <= 0) {
+            if (len < 0 && errno == EINTR) {
+                _buffer.resize(size);
+                continue;
+            }
+
+            throw Error("failed to receive replies: " + std::string(len == 0 ? "connection closed" : std::strerror(errno)));
+        }
+
+        _buffer.resize(size + static_cast<std::size_t>(len));
+    }
+
+    _buffer.erase(0, pos);
+
+    return errors;
+}
+
+std::size_t RespClient::_parse_reply(std::size_t pos, bool &error) const {
+    if (pos >= _buffer.size()) {
+        return std::string::npos;
+    }
+
+    auto line_end = _buffer.find("\r\n", pos);
+    if (line_end == std::string::npos) {
+        return std::string::npos;
+    }
+
+    auto end = line_end + 2;
+    switch (_buffer[pos]) {
+    case '-':
+        error = true;
+        return end;
+
+    case '+':
+    case ':':
+        return end;
+
+    case '$': {
+        auto len = std::strtoll(_buffer.data() + pos + 1, nullptr, 10);
+        if (len < 0) {
+            // Null bulk string.
+            return end;
+        }
+
+        end += static_cast<std::size_t>(len) + 2;
+        return end <= _buffer.size() ? end : std::string::npos;
+    }
+
+    case '*': {
+        auto num = std::strtoll(_buffer.data() + pos + 1, nullptr, 10);
+        for (long long idx = 0; idx < num && end != std::string::npos; ++idx) {
+            end = _parse_reply(end, error);
+        }
+        return end;
+    }
+
+    default:
+        throw Error("invalid reply type: " + std::string(1, _buffer[pos]));
+    }
+}
+
+}
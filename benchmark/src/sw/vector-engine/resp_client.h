@@ -0,0 +1,64 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#ifndef SW_VECTOR_ENGINE_BENCHMARK_RESP_CLIENT_H
+#define SW_VECTOR_ENGINE_BENCHMARK_RESP_CLIENT_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sw::vengine::benchmark {
+
+// @return the RESP request of the command, i.e. an array of bulk strings.
+std::string resp_command(const std::vector<std::string_view> &args);
+
+// A blocking client, which sends pipelined requests and reads their replies.
+class RespClient {
+public:
+    // Throw Error if it fails to connect.
+    RespClient(const std::string &host, int port);
+
+    RespClient(const RespClient &) = delete;
+    RespClient& operator=(const RespClient &) = delete;
+
+    RespClient(RespClient &&) = delete;
+    RespClient& operator=(RespClient &&) = delete;
+
+    ~RespClient();
+
+    // Send all data, which might be several requests, with as few writes as possible.
+    void send(const std::string_view &data);
+
+    // Read `num` replies, and replies of all types are skipped.
+    // @return number of error replies.
+    std::size_t recv(std::size_t num);
+
+private:
+    // Parse a reply, which might be an array, starting at `pos` of the buffer.
+    // @return end of the reply, or std::string::npos if it's incomplete.
+    std::size_t _parse_reply(std::size_t pos, bool &error) const;
+
+    int _fd = -1;
+
+    std::string _buffer;
+};
+
+}
+
+#endif // end SW_VECTOR_ENGINE_BENCHMARK_RESP_CLIENT_H
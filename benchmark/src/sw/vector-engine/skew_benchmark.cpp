@@ -0,0 +1,206 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#include "skew_benchmark.h"
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <unistd.h>
+#include "sw/vector-engine/errors.h"
+#include "resp_client.h"
+
+namespace {
+
+// Number of VADDs sent in a batch when loading the collection.
+const std::size_t LOAD_BATCH = 1000;
+
+// Number of distinct queries of heavy connections.
+const std::size_t NUM_QUERIES = 100;
+
+std::string_view fp32_blob(const float *vec, std::size_t dim) {
+    return {reinterpret_cast<const char*>(vec), dim * sizeof(float)};
+}
+
+}
+
+namespace sw::vengine::benchmark {
+
+SkewBenchmark::SkewBenchmark(const BenchmarkOptions &opts) :
+    _host(opts.get("host", std::string("127.0.0.1"))),
+    _port(static_cast<int>(opts.get("port", std::size_t(7777)))),
+    _connections(opts.get("connections", std::size_t(16))),
+    _heavy(opts.get("heavy", std::size_t(2))),
+    _requests(opts.get("requests", std::size_t(20000))),
+    _pipeline(opts.get("pipeline", std::size_t(4))),
+    _vectors(opts.get("vectors", std::size_t(100000))),
+    _dim(opts.get("dim", std::size_t(128))),
+    _count(opts.get("count", std::size_t(10))) {
+    if (_heavy == 0 || _heavy >= _connections) {
+        throw Error("there must be both heavy and light connections");
+    }
+
+    if (_pipeline == 0 || _vectors == 0 || _dim == 0) {
+        throw Error("pipeline, vectors and dim must be positive");
+    }
+}
+
+void SkewBenchmark::run() {
+    // Collections cannot be dropped, so each run creates a new one.
+    auto key = "benchmark:skew:" + std::to_string(::getpid());
+    _load(key);
+
+    auto light = _connections - _heavy;
+    auto requests = (_requests + light - 1) / light;
+    auto queries = random_vectors(NUM_QUERIES, _dim, 1);
+
+    std::vector<std::unique_ptr<RespClient>> clients;
+    for (std::size_t idx = 0; idx != _connections; ++idx) {
+        clients.push_back(std::make_unique<RespClient>(_host, _port));
+    }
+
+    // Latency of each request or batch in microseconds.
+    std::vector<std::vector<double>> latencies(_connections);
+    std::vector<std::size_t> errors(_connections, 0);
+    std::vector<std::size_t> searches(_heavy, 0);
+
+    // Heavy connections stop once all light ones finish.
+    std::atomic<std::size_t> running{light};
+
+    auto start = Clock::now();
+
+    std::vector<std::thread> threads;
+    for (std::size_t idx = 0; idx != _connections; ++idx) {
+        threads.emplace_back([&, idx]() {
+            auto &client = *clients[idx];
+            auto &latency = latencies[idx];
+            try {
+                if (idx < _heavy) {
+                    for (std::size_t round = 0; running.load(std::memory_order_relaxed) > 0; ++round) {
+                        std::string batch;
+                        for (std::size_t pos = 0; pos != _pipeline; ++pos) {
+                            const auto *query = queries.data() + (round * _pipeline + pos) % NUM_QUERIES * _dim;
+                            batch += resp_command({"VSIM", key, "FP32", fp32_blob(query, _dim),
+                                                    "COUNT", std::to_string(_count)});
+                        }
+
+                        auto sent = Clock::now();
+                        client.send(batch);
+                        errors[idx] += client.recv(_pipeline);
+                        latency.push_back(elapsed_seconds(sent) * 1e6);
+                        searches[idx] += _pipeline;
+                    }
+                } else {
+                    for (std::size_t round = 0; round != requests; ++round) {
+                        auto sent = Clock::now();
+                        client.send(resp_command({"VGET", key, std::to_string(round * 7919 % _vectors)}));
+                        errors[idx] += client.recv(1);
+                        latency.push_back(elapsed_seconds(sent) * 1e6);
+                    }
+                }
+            } catch (const Error &e) {
+                std::cerr << "connection " << idx << " failed: " << e.what() << std::endl;
+                errors[idx] += 1;
+            }
+
+            if (idx >= _heavy) {
+                running.fetch_sub(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    auto seconds = elapsed_seconds(start);
+
+    std::size_t error_num = 0;
+    for (auto num : errors) {
+        error_num += num;
+    }
+
+    if (error_num != 0) {
+        throw Error("failed requests: " + std::to_string(error_num));
+    }
+
+    std::vector<double> heavy_latencies;
+    std::vector<double> light_latencies;
+    std::size_t heavy_requests = 0;
+    for (std::size_t idx = 0; idx != _connections; ++idx) {
+        auto &samples = idx < _heavy ? heavy_latencies : light_latencies;
+        samples.insert(samples.end(), latencies[idx].begin(), latencies[idx].end());
+        if (idx < _heavy) {
+            heavy_requests += searches[idx];
+        }
+    }
+
+    std::cout << "connections: " << _connections << ", heavy: " << _heavy
+                << ", vectors: " << _vectors << ", dim: " << _dim << std::endl;
+    std::cout << std::setw(12) << "command"
+                << std::setw(12) << "requests"
+                << std::setw(12) << "req/s"
+                << std::setw(12) << "p50 (us)"
+                << std::setw(12) << "p99 (us)"
+                << std::setw(12) << "p999 (us)"
+                << std::setw(12) << "max (us)" << std::endl;
+
+    _print("VGET", light_latencies.size(), seconds, light_latencies);
+    _print("VSIM batch", heavy_requests, seconds, heavy_latencies);
+}
+
+void SkewBenchmark::_load(const std::string &key) const {
+    RespClient client(_host, _port);
+
+    client.send(resp_command({"VCREATE", key, "DIM", std::to_string(_dim)}));
+    if (client.recv(1) != 0) {
+        throw Error("failed to create collection " + key);
+    }
+
+    auto vecs = random_vectors(_vectors, _dim);
+    for (std::size_t first = 0; first < _vectors; first += LOAD_BATCH) {
+        std::string batch;
+        auto last = std::min(first + LOAD_BATCH, _vectors);
+        for (auto idx = first; idx != last; ++idx) {
+            batch += resp_command({"VADD", key, "FP32", fp32_blob(vecs.data() + idx * _dim, _dim),
+                                    std::to_string(idx)});
+        }
+
+        client.send(batch);
+        if (client.recv(last - first) != 0) {
+            throw Error("failed to add vectors to " + key);
+        }
+    }
+}
+
+void SkewBenchmark::_print(const std::string &name,
+                            std::size_t requests,
+                            double seconds,
+                            std::vector<double> &latencies) const {
+    std::cout << std::fixed << std::setprecision(0)
+                << std::setw(12) << name
+                << std::setw(12) << requests
+                << std::setw(12) << requests / seconds
+                << std::setw(12) << percentile(latencies, 50)
+                << std::setw(12) << percentile(latencies, 99)
+                << std::setw(12) << percentile(latencies, 99.9)
+                << std::setw(12) << percentile(latencies, 100) << std::endl;
+}
+
+}
@@ -0,0 +1,76 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#ifndef SW_VECTOR_ENGINE_BENCHMARK_SKEW_BENCHMARK_H
+#define SW_VECTOR_ENGINE_BENCHMARK_SKEW_BENCHMARK_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "utils.h"
+
+namespace sw::vengine::benchmark {
+
+// Skewed load on a running server: a few heavy connections keep sending pipelined
+// VSIMs, which scan a FLAT collection, while other connections send VGETs one at
+// a time. Report latency percentiles of the light requests, which shouldn't wait
+// for heavy ones while other workers are idle, and throughput of heavy ones.
+//
+// Options:
+//     --host: server host, default 127.0.0.1
+//     --port: server port, default 7777
+//     --connections: number of connections, each of which runs in a thread, default 16
+//     --heavy: number of connections sending VSIMs, default 2
+//     --requests: number of VGETs of all light connections, default 20000
+//     --pipeline: pipeline depth of heavy connections, default 4
+//     --vectors: number of vectors in the collection, default 100000
+//     --dim: dimension of vectors, default 128
+//     --count: number of neighbors of each VSIM, default 10
+class SkewBenchmark {
+public:
+    explicit SkewBenchmark(const BenchmarkOptions &opts);
+
+    void run();
+
+private:
+    // Create the collection and fill it with random vectors.
+    void _load(const std::string &key) const;
+
+    void _print(const std::string &name, std::size_t requests, double seconds, std::vector<double> &latencies) const;
+
+    std::string _host;
+
+    int _port = 0;
+
+    std::size_t _connections = 0;
+
+    std::size_t _heavy = 0;
+
+    std::size_t _requests = 0;
+
+    std::size_t _pipeline = 0;
+
+    std::size_t _vectors = 0;
+
+    std::size_t _dim = 0;
+
+    std::size_t _count = 0;
+};
+
+}
+
+#endif // end SW_VECTOR_ENGINE_BENCHMARK_SKEW_BENCHMARK_H
@@ -0,0 +1,98 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#include "sq8_benchmark.h"
+#include <iomanip>
+#include <iostream>
+#include "sw/vector-engine/distance.h"
+#include "sw/vector-engine/errors.h"
+#include "sw/vector-engine/vector_collection.h"
+
+namespace sw::vengine::benchmark {
+
+Sq8Benchmark::Sq8Benchmark(const BenchmarkOptions &opts) :
+    _vectors(opts.get("vectors", std::size_t(100000))),
+    _dim(opts.get("dim", std::size_t(128))),
+    _clusters(opts.get("clusters", std::size_t(100))),
+    _queries(opts.get("queries", std::size_t(1000))),
+    _k(opts.get("k", std::size_t(10))),
+    _rerank(opts.get("rerank", std::size_t(4))) {
+    if (_vectors == 0 || _dim == 0 || _k == 0) {
+        throw Error("vectors, dim and k must be positive");
+    }
+}
+
+void Sq8Benchmark::run() {
+    auto vecs = clustered_vectors(_vectors, _dim, _clusters, 1);
+    auto queries = clustered_vectors(_queries, _dim, _clusters, 2);
+
+    VectorCollection exact(_dim);
+    add_vectors(exact, vecs);
+    auto neighbors = exact_neighbors(exact, queries, _k);
+
+    std::cout << "vectors: " << _vectors << ", dim: " << _dim << ", clusters: " << _clusters
+                << ", simd: " << simd_level() << std::endl;
+    std::cout << std::setw(24) << "index"
+                << std::setw(14) << "bytes/vector"
+                << std::setw(12) << "qps"
+                << std::setw(10) << "speedup"
+                << std::setw(12) << "recall@" + std::to_string(_k) << std::endl;
+
+    IndexOptions index_opts;
+    auto flat_qps = _run("FLAT", index_opts, vecs, queries, neighbors, 0);
+
+    index_opts.type = IndexType::SQ8;
+    for (auto per_dim : {true, false}) {
+        index_opts.sq_per_dim = per_dim;
+        std::string name = per_dim ? "SQ8 PER_DIM" : "SQ8 GLOBAL";
+
+        index_opts.rerank = 0;
+        _run(name, index_opts, vecs, queries, neighbors, flat_qps);
+
+        if (_rerank != 0) {
+            index_opts.rerank = _rerank;
+            _run(name + " RERANK " + std::to_string(_rerank), index_opts, vecs, queries, neighbors, flat_qps);
+        }
+    }
+}
+
+double Sq8Benchmark::_run(const std::string &name,
+                            const IndexOptions &index_opts,
+                            const std::vector<float> &vecs,
+                            const std::vector<float> &queries,
+                            const std::vector<std::unordered_set<std::string>> &neighbors,
+                            double flat_qps) const {
+    VectorCollection collection(_dim, Metric::L2, index_opts);
+    add_vectors(collection, vecs);
+
+    SearchOptions opts;
+    opts.k = _k;
+    auto stats = measure_search(collection, queries, opts, neighbors);
+    if (flat_qps == 0) {
+        flat_qps = stats.qps;
+    }
+
+    std::cout << std::fixed << std::setprecision(0)
+                << std::setw(24) << name
+                << std::setw(14) << collection.memory_usage() / _vectors
+                << std::setw(12) << stats.qps
+                << std::setw(10) << std::setprecision(2) << stats.qps / flat_qps
+                << std::setw(12) << std::setprecision(4) << stats.recall << std::endl;
+
+    return stats.qps;
+}
+
+}
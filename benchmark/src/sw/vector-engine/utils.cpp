@@ -0,0 +1,173 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#include "utils.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <random>
+#include <utility>
+#include "sw/vector-engine/errors.h"
+
+namespace sw::vengine::benchmark {
+
+BenchmarkOptions::BenchmarkOptions(int argc, char **argv, int first) {
+    for (auto idx = first; idx < argc; idx += 2) {
+        std::string name = argv[idx];
+        if (name.size() <= 2 || name.compare(0, 2, "--") != 0) {
+            throw Error("invalid option: " + name);
+        }
+
+        if (idx + 1 == argc) {
+            throw Error("no value for option: " + name);
+        }
+
+        _opts[name.substr(2)] = argv[idx + 1];
+    }
+}
+
+std::string BenchmarkOptions::get(const std::string &name, const std::string &default_val) const {
+    auto iter = _opts.find(name);
+    if (iter == _opts.end()) {
+        return default_val;
+    }
+
+    return iter->second;
+}
+
+std::size_t BenchmarkOptions::get(const std::string &name, std::size_t default_val) const {
+    auto iter = _opts.find(name);
+    if (iter == _opts.end()) {
+        return default_val;
+    }
+
+    const auto &val = iter->second;
+    std::size_t num = 0;
+    auto [ptr, err] = std::from_chars(val.data(), val.data() + val.size(), num);
+    if (err != std::errc() || ptr != val.data() + val.size()) {
+        throw Error("invalid value of option " + name + ": " + val);
+    }
+
+    return num;
+}
+
+std::vector<float> random_vectors(std::size_t num, std::size_t dim, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+    std::vector<float> vecs(num * dim);
+    for (auto &val : vecs) {
+        val = dist(gen);
+    }
+
+    return vecs;
+}
+
+std::vector<float> clustered_vectors(std::size_t num,
+                                        std::size_t dim,
+                                        std::size_t clusters,
+                                        uint32_t seed,
+                                        float stddev) {
+    if (clusters == 0) {
+        throw Error("number of clusters must be positive");
+    }
+
+    auto centers = random_vectors(clusters, dim, static_cast<uint32_t>(clusters * 7919 + dim));
+
+    std::mt19937 gen(seed);
+    std::normal_distribution<float> noise(0.0f, stddev);
+    std::uniform_int_distribution<std::size_t> cluster(0, clusters - 1);
+
+    std::vector<float> vecs(num * dim);
+    for (std::size_t idx = 0; idx != num; ++idx) {
+        const auto *center = centers.data() + cluster(gen) * dim;
+        for (std::size_t i = 0; i != dim; ++i) {
+            vecs[idx * dim + i] = center[i] + noise(gen);
+        }
+    }
+
+    return vecs;
+}
+
+void add_vectors(VectorCollection &collection, const std::vector<float> &vecs) {
+    auto dim = collection.dim();
+    for (std::size_t idx = 0; idx * dim < vecs.size(); ++idx) {
+        collection.add(std::to_string(idx), vecs.data() + idx * dim);
+    }
+}
+
+std::vector<std::unordered_set<std::string>> exact_neighbors(const VectorCollection &exact,
+                                                                const std::vector<float> &queries,
+                                                                std::size_t k) {
+    SearchOptions opts;
+    opts.k = k;
+
+    auto dim = exact.dim();
+    std::vector<std::unordered_set<std::string>> neighbors;
+    for (std::size_t idx = 0; idx * dim < queries.size(); ++idx) {
+        std::unordered_set<std::string> keys;
+        for (auto &res : exact.search(queries.data() + idx * dim, opts)) {
+            keys.insert(std::move(res.key));
+        }
+        neighbors.push_back(std::move(keys));
+    }
+
+    return neighbors;
+}
+
+SearchStats measure_search(const VectorCollection &collection,
+                            const std::vector<float> &queries,
+                            const SearchOptions &opts,
+                            const std::vector<std::unordered_set<std::string>> &neighbors) {
+    auto dim = collection.dim();
+    std::vector<std::vector<SearchResult>> results;
+    results.reserve(neighbors.size());
+
+    auto start = Clock::now();
+    for (std::size_t idx = 0; idx * dim < queries.size(); ++idx) {
+        results.push_back(collection.search(queries.data() + idx * dim, opts));
+    }
+    auto seconds = elapsed_seconds(start);
+
+    std::size_t found = 0;
+    std::size_t total = 0;
+    for (std::size_t idx = 0; idx != results.size(); ++idx) {
+        for (const auto &res : results[idx]) {
+            found += neighbors[idx].count(res.key);
+        }
+        total += neighbors[idx].size();
+    }
+
+    SearchStats stats;
+    stats.qps = results.size() / seconds;
+    stats.recall = total == 0 ? 1 : static_cast<double>(found) / total;
+
+    return stats;
+}
+
+double percentile(std::vector<double> &samples, double pct) {
+    if (samples.empty()) {
+        return 0;
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    auto rank = static_cast<std::size_t>(std::ceil(pct / 100 * samples.size()));
+    return samples[std::min(std::max<std::size_t>(rank, 1), samples.size()) - 1];
+}
+
+}
@@ -0,0 +1,97 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#ifndef SW_VECTOR_ENGINE_BENCHMARK_UTILS_H
+#define SW_VECTOR_ENGINE_BENCHMARK_UTILS_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "sw/vector-engine/vector_collection.h"
+
+namespace sw::vengine::benchmark {
+
+// Options of a benchmark, which are passed as `--name value` on the command line.
+// Each benchmark documents its options and their default values.
+class BenchmarkOptions {
+public:
+    // Parse options in `argv[first], ..., argv[argc - 1]`.
+    // Throw Error if an option has no value.
+    BenchmarkOptions(int argc, char **argv, int first);
+
+    std::string get(const std::string &name, const std::string &default_val) const;
+
+    // Throw Error if the value is not a non-negative integer.
+    std::size_t get(const std::string &name, std::size_t default_val) const;
+
+private:
+    std::unordered_map<std::string, std::string> _opts;
+};
+
+using Clock = std::chrono::steady_clock;
+
+inline double elapsed_seconds(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// @return `num` vectors of `dim` floats uniformly distributed in [-1, 1), which are
+//         stored one after another. The same seed always generates the same vectors.
+std::vector<float> random_vectors(std::size_t num, std::size_t dim, uint32_t seed = 0);
+
+// @return `num` vectors of `dim` floats around `clusters` random centers, with
+//         gaussian noise of standard deviation `stddev` on each dimension.
+//         Centers only depend on `dim` and `clusters`, so that data and queries
+//         generated with different seeds share them.
+std::vector<float> clustered_vectors(std::size_t num,
+                                        std::size_t dim,
+                                        std::size_t clusters,
+                                        uint32_t seed,
+                                        float stddev = 0.2f);
+
+// Add vectors with keys of their positions, i.e. "0", "1", ...
+void add_vectors(VectorCollection &collection, const std::vector<float> &vecs);
+
+// @return keys of the `k` nearest neighbors of each query, which are searched by
+//         `exact`, i.e. a FLAT collection.
+std::vector<std::unordered_set<std::string>> exact_neighbors(const VectorCollection &exact,
+                                                                const std::vector<float> &queries,
+                                                                std::size_t k);
+
+struct SearchStats {
+    // Queries per second of a single thread.
+    double qps = 0;
+
+    // Ratio of exact neighbors found.
+    double recall = 0;
+};
+
+// Search queries one by one, and compare results with `neighbors`, i.e. the exact ones.
+SearchStats measure_search(const VectorCollection &collection,
+                            const std::vector<float> &queries,
+                            const SearchOptions &opts,
+                            const std::vector<std::unordered_set<std::string>> &neighbors);
+
+// @return the `pct` percentile, e.g. 99.9, of `samples`, which are sorted in place.
+double percentile(std::vector<double> &samples, double pct);
+
+}
+
+#endif // end SW_VECTOR_ENGINE_BENCHMARK_UTILS_H
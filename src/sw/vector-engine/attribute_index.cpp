@@ -0,0 +1,1057 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#include "sw/vector-engine/attribute_index.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <optional>
+#include <unordered_set>
+#include <utility>
+#include "sw/vector-engine/errors.h"
+#include "sw/vector-engine/filter_scan.h"
+#include "sw/vector-engine/str_utils.h"
+
+namespace sw::vengine {
+
+namespace {
+
+// 2^63, and doubles in [-2^63, 2^63) can be converted to int64.
+constexpr double INT64_BOUND = 9223372036854775808.0;
+
+// Values of the stack machine, and each one is a true mask followed by a false mask
+// of FILTER_BATCH_WORDS words each.
+constexpr auto VALUE_WORDS = 2 * FILTER_BATCH_WORDS;
+
+// Costs of answering comparisons with inverted indexes. Copying or merging a bitmap
+// costs about the number of words it takes, and collecting ids of a range costs 1
+// per id, and ENTRY_COST per entry, since entries are scattered in memory.
+constexpr std::size_t ENTRY_COST = 32;
+
+std::size_t bitmap_cost(const Bitmap &ids) {
+    return ids.memory_usage() / sizeof(uint64_t);
+}
+
+// Bits of `value_needs`.
+constexpr uint8_t NEED_TRUTH = 1;
+constexpr uint8_t NEED_FALSITY = 2;
+
+template <typename T>
+void set_value(std::vector<T> &values, VectorId id, T val) {
+    if (id >= values.size()) {
+        values.resize(static_cast<std::size_t>(id) + 1);
+    }
+
+    values[id] = val;
+}
+
+// @return true if the bit was not set.
+bool set_bit(std::vector<uint64_t> &bits, VectorId id) {
+    auto word = static_cast<std::size_t>(id) / 64;
+    if (word >= bits.size()) {
+        bits.resize(word + 1, 0);
+    }
+
+    auto bit = uint64_t(1) << (id % 64);
+    auto unset = (bits[word] & bit) == 0;
+    bits[word] |= bit;
+
+    return unset;
+}
+
+// @return true if the bit was set.
+bool clear_bit(std::vector<uint64_t> &bits, VectorId id) {
+    auto word = static_cast<std::size_t>(id) / 64;
+    if (word >= bits.size()) {
+        return false;
+    }
+
+    auto bit = uint64_t(1) << (id % 64);
+    auto set = (bits[word] & bit) != 0;
+    bits[word] &= ~bit;
+
+    return set;
+}
+
+template <typename Map, typename Key>
+void unset_value(Map &ids, const Key &key, VectorId id) {
+    auto iter = ids.find(key);
+    assert(iter != ids.end());
+
+    iter->second.remove(id);
+    if (iter->second.empty()) {
+        ids.erase(iter);
+    }
+}
+
+// Entries of `ids` whose values are in the range of `op` and `key`.
+template <typename Map, typename Key>
+std::pair<typename Map::const_iterator, typename Map::const_iterator>
+    value_range(const Map &ids, FilterOp op, const Key &key) {
+    auto begin = ids.begin();
+    auto end = ids.end();
+    switch (op) {
+    case FilterOp::LT:
+        end = ids.lower_bound(key);
+        break;
+
+    case FilterOp::LE:
+        end = ids.upper_bound(key);
+        break;
+
+    case FilterOp::GT:
+        begin = ids.upper_bound(key);
+        break;
+
+    default:
+        assert(op == FilterOp::GE);
+
+        begin = ids.lower_bound(key);
+        break;
+    }
+
+    return {begin, end};
+}
+
+// Cost of looking up `op` and `key` in `ids`, and `all` is ids of all values.
+// Counting stops once it exceeds `limit`.
+template <typename Map, typename Key>
+std::size_t lookup_cost(const Map &ids, const Bitmap &all, FilterOp op, const Key &key, std::size_t limit) {
+    if (op == FilterOp::EQ || op == FilterOp::NE) {
+        auto iter = ids.find(key);
+        auto cost = iter == ids.end() ? 0 : bitmap_cost(iter->second);
+        return op == FilterOp::EQ ? cost : cost + bitmap_cost(all);
+    }
+
+    std::size_t cost = 0;
+    auto [begin, end] = value_range(ids, op, key);
+    for (auto iter = begin; iter != end && cost <= limit; ++iter) {
+        cost += iter->second.cardinality() + ENTRY_COST;
+    }
+
+    return cost;
+}
+
+// @return number of ids of values matching `op` and `key`, and `all` is ids of all values,
+//         or std::nullopt if the range has more than `limit` entries.
+template <typename Map, typename Key>
+std::optional<std::size_t> count_values(const Map &ids, const Bitmap &all, FilterOp op, const Key &key, std::size_t limit) {
+    if (op == FilterOp::EQ || op == FilterOp::NE) {
+        auto iter = ids.find(key);
+        auto cnt = iter == ids.end() ? 0 : iter->second.cardinality();
+        return op == FilterOp::EQ ? cnt : all.cardinality() - cnt;
+    }
+
+    std::size_t cnt = 0;
+    std::size_t entries = 0;
+    auto [begin, end] = value_range(ids, op, key);
+    for (auto iter = begin; iter != end; ++iter) {
+        if (++entries > limit) {
+            return std::nullopt;
+        }
+
+        cnt += iter->second.cardinality();
+    }
+
+    return cnt;
+}
+
+// @return ids of values matching `op` and `key`, and `all` is ids of all values,
+//         which are less than `words * 64`.
+template <typename Map, typename Key>
+Bitmap lookup_values(const Map &ids, const Bitmap &all, FilterOp op, const Key &key, std::size_t words) {
+    if (op == FilterOp::EQ || op == FilterOp::NE) {
+        auto iter = ids.find(key);
+        if (op == FilterOp::EQ) {
+            return iter == ids.end() ? Bitmap{} : iter->second;
+        }
+
+        auto result = all;
+        if (iter != ids.end()) {
+            result -= iter->second;
+        }
+
+        return result;
+    }
+
+    // A range might have lots of bitmaps, and merging them one by one is quadratic.
+    std::vector<uint64_t> bits(words, 0);
+    auto [begin, end] = value_range(ids, op, key);
+    for (auto iter = begin; iter != end; ++iter) {
+        iter->second.for_each([&bits](uint32_t id) { bits[id / 64] |= uint64_t(1) << (id % 64); });
+    }
+
+    Bitmap result;
+    for (std::size_t word = 0; word != words; ++word) {
+        result.add_word(static_cast<uint32_t>(word * 64), bits[word]);
+    }
+
+    return result;
+}
+
+// @return index of the first instruction of the sub-expression ending at each instruction.
+std::vector<std::size_t> subtree_begins(const std::vector<FilterInstruction> &code) {
+    std::vector<std::size_t> begins(code.size());
+    std::vector<std::size_t> stack;
+    for (std::size_t idx = 0; idx != code.size(); ++idx) {
+        switch (code[idx].opcode) {
+        case FilterOpcode::COMPARE:
+            stack.push_back(idx);
+            break;
+
+        case FilterOpcode::AND:
+        case FilterOpcode::OR:
+            assert(stack.size() >= 2);
+
+            // The sub-expression begins with its left operand.
+            stack.pop_back();
+            break;
+
+        default:
+            assert(code[idx].opcode == FilterOpcode::NOT && !stack.empty());
+            break;
+        }
+
+        begins[idx] = stack.back();
+    }
+
+    return begins;
+}
+
+// @return NEED_TRUTH and NEED_FALSITY bits for each instruction, i.e. which masks
+//         of its value are used by the program. Only the true mask of the program is
+//         needed, and a NOT needs the other mask of its operand.
+std::vector<uint8_t> value_needs(const std::vector<FilterInstruction> &code,
+                                    const std::vector<std::size_t> &begins) {
+    std::vector<uint8_t> needs(code.size(), 0);
+    if (code.empty()) {
+        return needs;
+    }
+
+    // Operands follow the operator in reverse order.
+    needs.back() = NEED_TRUTH;
+    for (auto idx = code.size(); idx-- > 0; ) {
+        auto need = needs[idx];
+        switch (code[idx].opcode) {
+        case FilterOpcode::AND:
+        case FilterOpcode::OR: {
+            auto right = idx - 1;
+            auto left = begins[right] - 1;
+            needs[right] |= need;
+            needs[left] |= need;
+            break;
+        }
+
+        case FilterOpcode::NOT:
+            needs[idx - 1] |= ((need & NEED_TRUTH) != 0 ? NEED_FALSITY : 0)
+                | ((need & NEED_FALSITY) != 0 ? NEED_TRUTH : 0);
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    return needs;
+}
+
+// Append ranges of code of conjuncts of the sub-expression in [begin, end) to `conjuncts`.
+void split_conjuncts(const std::vector<FilterInstruction> &code,
+                        const std::vector<std::size_t> &begins,
+                        std::size_t begin,
+                        std::size_t end,
+                        std::vector<std::pair<std::size_t, std::size_t>> &conjuncts) {
+    assert(begin < end);
+
+    if (code[end - 1].opcode != FilterOpcode::AND) {
+        conjuncts.emplace_back(begin, end);
+        return;
+    }
+
+    auto right = begins[end - 2];
+    split_conjuncts(code, begins, begin, right, conjuncts);
+    split_conjuncts(code, begins, right, end - 1, conjuncts);
+}
+
+// Number of values of the batch starting from `base` in `values`.
+template <typename T>
+std::size_t batch_size(const std::vector<T> &values, std::size_t base) {
+    return values.size() > base ? std::min(FILTER_BATCH, values.size() - base) : 0;
+}
+
+}
+
+AttributeType parse_attribute_type(const std::string_view &name) {
+    auto type = str::to_lower(name);
+    if (type == "tag") {
+        return AttributeType::TAG;
+    } else if (type == "int") {
+        return AttributeType::INT;
+    } else if (type == "float") {
+        return AttributeType::FLOAT;
+    }
+
+    throw Error("unknown attribute type: " + std::string(name));
+}
+
+std::string to_string(AttributeType type) {
+    switch (type) {
+    case AttributeType::TAG:
+        return "TAG";
+
+    case AttributeType::INT:
+        return "INT";
+
+    case AttributeType::FLOAT:
+        return "FLOAT";
+
+    default:
+        throw Error("unknown attribute type");
+    }
+}
+
+void AttributeIndex::add(VectorId id) {
+    if (set_bit(_live, id)) {
+        ++_live_cnt;
+    }
+}
+
+void AttributeIndex::check(const std::vector<Attribute> &attrs) const {
+    std::unordered_set<std::string_view> names;
+    for (const auto &attr : attrs) {
+        if (!names.insert(attr.name).second) {
+            throw Error("duplicate attribute: " + attr.name);
+        }
+
+        auto iter = _columns.find(attr.name);
+        if (iter != _columns.end() && iter->second.type != attr.type) {
+            throw Error("attribute " + attr.name + " is " + to_string(iter->second.type)
+                    + ", got " + to_string(attr.type));
+        }
+    }
+}
+
+void AttributeIndex::set(VectorId id, const std::vector<Attribute> &attrs) {
+    for (auto &[name, column] : _columns) {
+        _unset(column, id);
+    }
+
+    for (const auto &attr : attrs) {
+        auto iter = _columns.find(attr.name);
+        if (iter == _columns.end()) {
+            Column column;
+            column.type = attr.type;
+            iter = _columns.emplace(attr.name, std::move(column)).first;
+        }
+
+        auto &column = iter->second;
+        assert(column.type == attr.type);
+
+        set_bit(column.present, id);
+        column.ids.add(id);
+        switch (attr.type) {
+        case AttributeType::TAG: {
+            auto code_iter = column.codes.find(attr.tag);
+            if (code_iter == column.codes.end()) {
+                code_iter = column.codes.emplace(attr.tag, static_cast<uint32_t>(column.tag_ids.size())).first;
+                column.tag_ids.emplace_back();
+            }
+
+            auto code = code_iter->second;
+            set_value(column.tags, id, code);
+            column.tag_ids[code].add(id);
+            break;
+        }
+
+        case AttributeType::INT:
+            set_value(column.integers, id, attr.integer);
+            column.integer_ids[attr.integer].add(id);
+            break;
+
+        default:
+            set_value(column.numbers, id, attr.number);
+            column.number_ids[attr.number].add(id);
+            break;
+        }
+    }
+}
+
+void AttributeIndex::remove(VectorId id) {
+    if (clear_bit(_live, id)) {
+        --_live_cnt;
+    }
+
+    for (auto &[name, column] : _columns) {
+        _unset(column, id);
+    }
+}
+
+Bitmap AttributeIndex::evaluate(const FilterProgram &program) const {
+    const auto &code = program.code();
+    auto compares = _bind(program);
+    auto begins = subtree_begins(code);
+    auto needs = value_needs(code, begins);
+
+    std::vector<std::pair<std::size_t, std::size_t>> conjuncts;
+    split_conjuncts(code, begins, 0, code.size(), conjuncts);
+
+    // Number of values compared by running the program over columns of all batches.
+    auto batches = (_live.size() + FILTER_BATCH_WORDS - 1) / FILTER_BATCH_WORDS;
+    auto batch_ids = batches * FILTER_BATCH;
+    auto compare_cnt = static_cast<std::size_t>(std::count_if(code.begin(), code.end(),
+                [](const FilterInstruction &instruction) {
+                    return instruction.opcode == FilterOpcode::COMPARE;
+                }));
+    auto budget = batch_ids * compare_cnt / INDEX_COST_FACTOR;
+
+    // (cost, index of conjunct), and the most selective conjuncts are answered first.
+    std::vector<std::pair<std::size_t, std::size_t>> costs;
+    costs.reserve(conjuncts.size());
+    for (std::size_t idx = 0; idx != conjuncts.size(); ++idx) {
+        auto [begin, end] = conjuncts[idx];
+        std::size_t cost = 0;
+        for (auto pos = begin; pos != end && cost <= budget; ++pos) {
+            if (code[pos].opcode == FilterOpcode::COMPARE) {
+                cost += _index_cost(compares[pos], (needs[pos] & NEED_FALSITY) != 0, budget - cost);
+            }
+        }
+
+        costs.emplace_back(cost, idx);
+    }
+    std::sort(costs.begin(), costs.end());
+
+    // Ids answered by inverted indexes are ids with attributes, which must be live.
+    Bitmap candidates;
+    std::size_t spent = 0;
+    std::size_t indexed = 0;
+    for (auto [cost, idx] : costs) {
+        if (spent + cost > budget) {
+            break;
+        }
+
+        auto [begin, end] = conjuncts[idx];
+        auto ids = _evaluate_index(program, compares, needs, begin, end);
+        if (indexed == 0) {
+            candidates = std::move(ids);
+        } else {
+            candidates &= ids;
+        }
+
+        spent += cost;
+        ++indexed;
+
+        if (candidates.empty()) {
+            return candidates;
+        }
+    }
+
+    if (indexed == conjuncts.size()) {
+        return candidates;
+    }
+
+    // Other ids are known to be false, and the program only needs to run on batches of
+    // candidates, which are worth finding if there're few of them.
+    auto sparse = indexed > 0 && candidates.cardinality() < batch_ids / INDEX_COST_FACTOR;
+
+    return _evaluate_columns(program, compares, sparse ? &candidates : nullptr);
+}
+
+Bitmap AttributeIndex::evaluate(const FilterProgram &program, const Bitmap &candidates) const {
+    auto compares = _bind(program);
+
+    auto result = _evaluate_columns(program, compares, &candidates);
+    result &= candidates;
+
+    return result;
+}
+
+std::size_t AttributeIndex::estimate(const FilterProgram &program) const {
+    auto compares = _bind(program);
+    if (_live_cnt == 0) {
+        return 0;
+    }
+
+    auto live = static_cast<double>(_live_cnt);
+
+    // Ratios of live ids for which each value is true, and for which it's false.
+    std::vector<std::pair<double, double>> stack;
+    const auto &code = program.code();
+    for (std::size_t idx = 0; idx != code.size(); ++idx) {
+        switch (code[idx].opcode) {
+        case FilterOpcode::COMPARE: {
+            const auto &compare = compares[idx];
+            auto present = compare.column == nullptr ? 0 : compare.column->ids.cardinality();
+            auto truth = _estimate(compare);
+            stack.emplace_back(truth / live, (present - truth) / live);
+            break;
+        }
+
+        case FilterOpcode::AND: {
+            assert(stack.size() >= 2);
+
+            auto [rhs_truth, rhs_falsity] = stack.back();
+            stack.pop_back();
+            auto &[truth, falsity] = stack.back();
+            truth *= rhs_truth;
+            falsity += rhs_falsity - falsity * rhs_falsity;
+            break;
+        }
+
+        case FilterOpcode::OR: {
+            assert(stack.size() >= 2);
+
+            auto [rhs_truth, rhs_falsity] = stack.back();
+            stack.pop_back();
+            auto &[truth, falsity] = stack.back();
+            truth += rhs_truth - truth * rhs_truth;
+            falsity *= rhs_falsity;
+            break;
+        }
+
+        default: {
+            assert(code[idx].opcode == FilterOpcode::NOT && !stack.empty());
+
+            auto &[truth, falsity] = stack.back();
+            std::swap(truth, falsity);
+            break;
+        }
+        }
+    }
+
+    assert(stack.size() == 1);
+
+    return static_cast<std::size_t>(std::llround(std::clamp(stack.back().first, 0.0, 1.0) * live));
+}
+
+std::size_t AttributeIndex::memory_usage() const {
+    auto usage = _live.capacity() * sizeof(uint64_t);
+    for (const auto &[name, column] : _columns) {
+        usage += name.capacity() + column.present.capacity() * sizeof(uint64_t);
+        usage += column.tags.capacity() * sizeof(uint32_t);
+        usage += column.integers.capacity() * sizeof(int64_t);
+        usage += column.numbers.capacity() * sizeof(double);
+        for (const auto &[tag, code] : column.codes) {
+            usage += tag.capacity() + sizeof(code);
+        }
+        usage += column.ids.memory_usage();
+        for (const auto &ids : column.tag_ids) {
+            usage += ids.memory_usage();
+        }
+        for (const auto &[val, ids] : column.integer_ids) {
+            usage += sizeof(val) + ids.memory_usage();
+        }
+        for (const auto &[val, ids] : column.number_ids) {
+            usage += sizeof(val) + ids.memory_usage();
+        }
+    }
+
+    return usage;
+}
+
+void AttributeIndex::_unset(Column &column, VectorId id) {
+    if (!column.ids.contains(id)) {
+        return;
+    }
+
+    column.ids.remove(id);
+    clear_bit(column.present, id);
+    switch (column.type) {
+    case AttributeType::TAG:
+        column.tag_ids[column.tags[id]].remove(id);
+        break;
+
+    case AttributeType::INT:
+        unset_value(column.integer_ids, column.integers[id], id);
+        break;
+
+    default:
+        unset_value(column.number_ids, column.numbers[id], id);
+        break;
+    }
+}
+
+std::vector<AttributeIndex::BoundCompare> AttributeIndex::_bind(const FilterProgram &program) const {
+    std::vector<const Column*> columns;
+    columns.reserve(program.attrs().size());
+    for (const auto &attr : program.attrs()) {
+        auto iter = _columns.find(attr);
+        columns.push_back(iter == _columns.end() ? nullptr : &iter->second);
+    }
+
+    const auto &code = program.code();
+    std::vector<BoundCompare> compares(code.size());
+    for (std::size_t idx = 0; idx != code.size(); ++idx) {
+        const auto &instruction = code[idx];
+        if (instruction.opcode != FilterOpcode::COMPARE) {
+            continue;
+        }
+
+        const auto *column = columns[instruction.attr];
+        if (column == nullptr) {
+            // No vector has the attribute.
+            continue;
+        }
+
+        const auto &name = program.attrs()[instruction.attr];
+        const auto &literal = program.literals()[instruction.literal];
+        auto op = instruction.op;
+        if (op != FilterOp::EQ && op != FilterOp::NE
+                && (column->type == AttributeType::TAG || literal.is_string)) {
+            throw Error("attribute " + name + " is " + to_string(column->type)
+                    + ", which only supports == and != with "
+                    + (column->type == AttributeType::TAG ? "strings" : "numbers"));
+        }
+
+        if ((column->type == AttributeType::TAG) != literal.is_string) {
+            throw Error("attribute " + name + " is " + to_string(column->type)
+                    + (literal.is_string ? ", which cannot be compared with a string"
+                            : ", which cannot be compared with a number"));
+        }
+
+        auto &compare = compares[idx];
+        compare.column = column;
+        compare.op = op;
+        compare.kind = BoundCompare::Kind::VALUE;
+        switch (column->type) {
+        case AttributeType::TAG: {
+            auto iter = column->codes.find(literal.str);
+            if (iter == column->codes.end()) {
+                // No vector has the tag.
+                compare.kind = op == FilterOp::EQ ? BoundCompare::Kind::NONE : BoundCompare::Kind::PRESENT;
+            } else {
+                compare.tag = iter->second;
+            }
+            break;
+        }
+
+        case AttributeType::INT:
+            _bind_integer(literal.num, compare);
+            break;
+
+        default:
+            compare.number = literal.num;
+            break;
+        }
+    }
+
+    return compares;
+}
+
+void AttributeIndex::_bind_integer(double num, BoundCompare &compare) {
+    auto op = compare.op;
+    if (std::isnan(num)) {
+        compare.kind = op == FilterOp::NE ? BoundCompare::Kind::PRESENT : BoundCompare::Kind::NONE;
+        return;
+    }
+
+    auto lower = std::floor(num);
+    auto upper = std::ceil(num);
+    switch (op) {
+    case FilterOp::EQ:
+    case FilterOp::NE:
+        if (lower != num || num < -INT64_BOUND || num >= INT64_BOUND) {
+            // No integer equals the literal.
+            compare.kind = op == FilterOp::EQ ? BoundCompare::Kind::NONE : BoundCompare::Kind::PRESENT;
+            return;
+        }
+        compare.integer = static_cast<int64_t>(num);
+        return;
+
+    case FilterOp::LT:
+    case FilterOp::GE:
+        if (upper >= INT64_BOUND) {
+            compare.kind = op == FilterOp::LT ? BoundCompare::Kind::PRESENT : BoundCompare::Kind::NONE;
+        } else if (upper < -INT64_BOUND) {
+            compare.kind = op == FilterOp::LT ? BoundCompare::Kind::NONE : BoundCompare::Kind::PRESENT;
+        } else {
+            compare.integer = static_cast<int64_t>(upper);
+        }
+        return;
+
+    default:
+        assert(op == FilterOp::LE || op == FilterOp::GT);
+
+        if (lower >= INT64_BOUND) {
+            compare.kind = op == FilterOp::LE ? BoundCompare::Kind::PRESENT : BoundCompare::Kind::NONE;
+        } else if (lower < -INT64_BOUND) {
+            compare.kind = op == FilterOp::LE ? BoundCompare::Kind::NONE : BoundCompare::Kind::PRESENT;
+        } else {
+            compare.integer = static_cast<int64_t>(lower);
+        }
+        return;
+    }
+}
+
+std::size_t AttributeIndex::_index_cost(const BoundCompare &compare, bool falsity, std::size_t limit) const {
+    if (compare.column == nullptr) {
+        return 0;
+    }
+
+    const auto &column = *compare.column;
+    std::size_t cost = 0;
+    switch (compare.kind) {
+    case BoundCompare::Kind::NONE:
+        break;
+
+    case BoundCompare::Kind::PRESENT:
+        cost = bitmap_cost(column.ids);
+        break;
+
+    default:
+        switch (column.type) {
+        case AttributeType::TAG:
+            cost = bitmap_cost(column.tag_ids[compare.tag]);
+            if (compare.op == FilterOp::NE) {
+                cost += bitmap_cost(column.ids);
+            }
+            break;
+
+        case AttributeType::INT:
+            cost = lookup_cost(column.integer_ids, column.ids, compare.op, compare.integer, limit);
+            break;
+
+        default:
+            cost = lookup_cost(column.number_ids, column.ids, compare.op, compare.number, limit);
+            break;
+        }
+        break;
+    }
+
+    if (falsity) {
+        cost += bitmap_cost(column.ids);
+    }
+
+    return cost;
+}
+
+AttributeIndex::BitmapValue AttributeIndex::_lookup(const BoundCompare &compare, bool falsity) const {
+    BitmapValue value;
+    if (compare.column == nullptr) {
+        // Unknown for all ids.
+        return value;
+    }
+
+    const auto &column = *compare.column;
+    switch (compare.kind) {
+    case BoundCompare::Kind::NONE:
+        break;
+
+    case BoundCompare::Kind::PRESENT:
+        value.truth = column.ids;
+        break;
+
+    default:
+        switch (column.type) {
+        case AttributeType::TAG:
+            if (compare.op == FilterOp::EQ) {
+                value.truth = column.tag_ids[compare.tag];
+            } else {
+                value.truth = column.ids;
+                value.truth -= column.tag_ids[compare.tag];
+            }
+            break;
+
+        case AttributeType::INT:
+            value.truth = lookup_values(column.integer_ids, column.ids, compare.op, compare.integer, _live.size());
+            break;
+
+        default:
+            value.truth = lookup_values(column.number_ids, column.ids, compare.op, compare.number, _live.size());
+            break;
+        }
+        break;
+    }
+
+    if (falsity) {
+        value.falsity = column.ids;
+        value.falsity -= value.truth;
+    }
+
+    return value;
+}
+
+std::size_t AttributeIndex::_estimate(const BoundCompare &compare) const {
+    if (compare.column == nullptr) {
+        return 0;
+    }
+
+    const auto &column = *compare.column;
+    switch (compare.kind) {
+    case BoundCompare::Kind::NONE:
+        return 0;
+
+    case BoundCompare::Kind::PRESENT:
+        return column.ids.cardinality();
+
+    default:
+        break;
+    }
+
+    std::optional<std::size_t> cnt;
+    switch (column.type) {
+    case AttributeType::TAG: {
+        auto tagged = column.tag_ids[compare.tag].cardinality();
+        cnt = compare.op == FilterOp::EQ ? tagged : column.ids.cardinality() - tagged;
+        break;
+    }
+
+    case AttributeType::INT:
+        cnt = count_values(column.integer_ids, column.ids, compare.op, compare.integer, ESTIMATE_MAX_ENTRIES);
+        break;
+
+    default:
+        cnt = count_values(column.number_ids, column.ids, compare.op, compare.number, ESTIMATE_MAX_ENTRIES);
+        break;
+    }
+
+    return cnt ? *cnt : _sample(compare);
+}
+
+std::size_t AttributeIndex::_sample(const BoundCompare &compare) const {
+    assert(compare.column != nullptr);
+
+    const auto &column = *compare.column;
+    auto batches = (column.present.size() + FILTER_BATCH_WORDS - 1) / FILTER_BATCH_WORDS;
+    auto samples = std::min(batches, ESTIMATE_SAMPLE_BATCHES);
+
+    // Batches are spread over the column, since ids added at the same time might have similar values.
+    uint64_t truth[FILTER_BATCH_WORDS];
+    uint64_t falsity[FILTER_BATCH_WORDS];
+    std::size_t true_cnt = 0;
+    std::size_t present_cnt = 0;
+    for (std::size_t idx = 0; idx != samples; ++idx) {
+        auto batch = idx * batches / samples;
+        _compare(compare, batch * FILTER_BATCH, truth, falsity);
+        for (std::size_t w = 0; w != FILTER_BATCH_WORDS; ++w) {
+            true_cnt += static_cast<std::size_t>(__builtin_popcountll(truth[w]));
+            present_cnt += static_cast<std::size_t>(__builtin_popcountll(truth[w] | falsity[w]));
+        }
+    }
+
+    if (present_cnt == 0) {
+        return 0;
+    }
+
+    return column.ids.cardinality() * true_cnt / present_cnt;
+}
+
+Bitmap AttributeIndex::_evaluate_index(const FilterProgram &program,
+                                        const std::vector<BoundCompare> &compares,
+                                        const std::vector<uint8_t> &needs,
+                                        std::size_t begin,
+                                        std::size_t end) const {
+    const auto &code = program.code();
+    std::vector<BitmapValue> stack;
+    for (auto idx = begin; idx != end; ++idx) {
+        switch (code[idx].opcode) {
+        case FilterOpcode::COMPARE:
+            stack.push_back(_lookup(compares[idx], (needs[idx] & NEED_FALSITY) != 0));
+            break;
+
+        case FilterOpcode::AND: {
+            assert(stack.size() >= 2);
+
+            auto rhs = std::move(stack.back());
+            stack.pop_back();
+            auto &lhs = stack.back();
+            lhs.truth &= rhs.truth;
+            lhs.falsity |= rhs.falsity;
+            break;
+        }
+
+        case FilterOpcode::OR: {
+            assert(stack.size() >= 2);
+
+            auto rhs = std::move(stack.back());
+            stack.pop_back();
+            auto &lhs = stack.back();
+            lhs.truth |= rhs.truth;
+            lhs.falsity &= rhs.falsity;
+            break;
+        }
+
+        default: {
+            assert(code[idx].opcode == FilterOpcode::NOT && !stack.empty());
+
+            auto &value = stack.back();
+            std::swap(value.truth, value.falsity);
+            break;
+        }
+        }
+    }
+
+    assert(stack.size() == 1);
+
+    return std::move(stack.back().truth);
+}
+
+Bitmap AttributeIndex::_evaluate_columns(const FilterProgram &program,
+                                            const std::vector<BoundCompare> &compares,
+                                            const Bitmap *candidates) const {
+    std::vector<uint64_t> stack(program.max_depth() * VALUE_WORDS);
+
+    Bitmap result;
+    auto run = [&](std::size_t word) {
+        auto words = std::min(FILTER_BATCH_WORDS, _live.size() - word);
+        auto base = word * 64;
+        _run_batch(program, compares, base, stack.data());
+        for (std::size_t w = 0; w != words; ++w) {
+            result.add_word(static_cast<uint32_t>(base + w * 64), stack[w] & _live[word + w]);
+        }
+    };
+
+    if (candidates != nullptr) {
+        // Candidates are live, and sorted, so that each batch runs once.
+        auto last = _live.size();
+        candidates->for_each([&](uint32_t id) {
+                auto word = id / FILTER_BATCH * FILTER_BATCH_WORDS;
+                if (word != last) {
+                    last = word;
+                    run(word);
+                }
+            });
+
+        return result;
+    }
+
+    for (std::size_t word = 0; word < _live.size(); word += FILTER_BATCH_WORDS) {
+        auto words = std::min(FILTER_BATCH_WORDS, _live.size() - word);
+        if (std::all_of(_live.begin() + word, _live.begin() + word + words,
+                    [](uint64_t bits) { return bits == 0; })) {
+            // No live id in this batch.
+            continue;
+        }
+
+        run(word);
+    }
+
+    return result;
+}
+
+void AttributeIndex::_run_batch(const FilterProgram &program,
+                                const std::vector<BoundCompare> &compares,
+                                std::size_t base,
+                                uint64_t *stack) const {
+    const auto &code = program.code();
+    std::size_t top = 0;
+    for (std::size_t idx = 0; idx != code.size(); ++idx) {
+        switch (code[idx].opcode) {
+        case FilterOpcode::COMPARE: {
+            assert(top < program.max_depth());
+
+            auto *value = stack + top * VALUE_WORDS;
+            _compare(compares[idx], base, value, value + FILTER_BATCH_WORDS);
+            ++top;
+            break;
+        }
+
+        case FilterOpcode::AND: {
+            assert(top >= 2);
+
+            --top;
+            auto *lhs = stack + (top - 1) * VALUE_WORDS;
+            const auto *rhs = stack + top * VALUE_WORDS;
+            for (std::size_t w = 0; w != FILTER_BATCH_WORDS; ++w) {
+                lhs[w] &= rhs[w];
+                lhs[FILTER_BATCH_WORDS + w] |= rhs[FILTER_BATCH_WORDS + w];
+            }
+            break;
+        }
+
+        case FilterOpcode::OR: {
+            assert(top >= 2);
+
+            --top;
+            auto *lhs = stack + (top - 1) * VALUE_WORDS;
+            const auto *rhs = stack + top * VALUE_WORDS;
+            for (std::size_t w = 0; w != FILTER_BATCH_WORDS; ++w) {
+                lhs[w] |= rhs[w];
+                lhs[FILTER_BATCH_WORDS + w] &= rhs[FILTER_BATCH_WORDS + w];
+            }
+            break;
+        }
+
+        default: {
+            assert(code[idx].opcode == FilterOpcode::NOT && top >= 1);
+
+            auto *value = stack + (top - 1) * VALUE_WORDS;
+            std::swap_ranges(value, value + FILTER_BATCH_WORDS, value + FILTER_BATCH_WORDS);
+            break;
+        }
+        }
+    }
+
+    assert(top == 1);
+}
+
+void AttributeIndex::_compare(const BoundCompare &compare,
+                                std::size_t base,
+                                uint64_t *truth,
+                                uint64_t *falsity) const {
+    if (compare.column == nullptr) {
+        // Unknown for all ids.
+        std::fill(truth, truth + FILTER_BATCH_WORDS, 0);
+        std::fill(falsity, falsity + FILTER_BATCH_WORDS, 0);
+        return;
+    }
+
+    const auto &column = *compare.column;
+    auto *mask = truth;
+    if (compare.kind == BoundCompare::Kind::NONE) {
+        std::fill(mask, mask + FILTER_BATCH_WORDS, 0);
+    } else if (compare.kind == BoundCompare::Kind::VALUE) {
+        std::size_t n = 0;
+        switch (column.type) {
+        case AttributeType::TAG:
+            n = batch_size(column.tags, base);
+            if (n > 0) {
+                compare_batch(column.tags.data() + base, n, compare.op, compare.tag, mask);
+            }
+            break;
+
+        case AttributeType::INT:
+            n = batch_size(column.integers, base);
+            if (n > 0) {
+                compare_batch(column.integers.data() + base, n, compare.op, compare.integer, mask);
+            }
+            break;
+
+        default:
+            n = batch_size(column.numbers, base);
+            if (n > 0) {
+                compare_batch(column.numbers.data() + base, n, compare.op, compare.number, mask);
+            }
+            break;
+        }
+
+        if (n == 0) {
+            std::fill(mask, mask + FILTER_BATCH_WORDS, 0);
+        }
+    } else {
+        std::fill(mask, mask + FILTER_BATCH_WORDS, ~uint64_t(0));
+    }
+
+    // Values of ids without the attribute are garbage, and the comparison is unknown for them.
+    auto word = base / 64;
+    for (std::size_t w = 0; w != FILTER_BATCH_WORDS; ++w) {
+        auto present = word + w < column.present.size() ? column.present[word + w] : 0;
+        truth[w] &= present;
+        falsity[w] = present & ~truth[w];
+    }
+}
+
+}
@@ -0,0 +1,221 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#ifndef SW_VECTOR_ENGINE_ATTRIBUTE_INDEX_H
+#define SW_VECTOR_ENGINE_ATTRIBUTE_INDEX_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "sw/vector-engine/bitmap.h"
+#include "sw/vector-engine/filter_program.h"
+#include "sw/vector-engine/vector_storage.h"
+
+namespace sw::vengine {
+
+enum class AttributeType {
+    TAG = 0,
+    INT,
+    FLOAT
+};
+
+// Throw Error if `name` is not a valid type, i.e. TAG, INT or FLOAT.
+AttributeType parse_attribute_type(const std::string_view &name);
+
+std::string to_string(AttributeType type);
+
+struct Attribute {
+    std::string name;
+
+    AttributeType type = AttributeType::TAG;
+
+    // Value of TAG.
+    std::string tag;
+
+    // Value of INT.
+    int64_t integer = 0;
+
+    // Value of FLOAT.
+    double number = 0;
+};
+
+// Typed attributes of vectors, which are stored in a dense array per attribute indexed
+// by id, i.e. a column, and in inverted indexes from values to bitmaps of ids.
+// Filters are compiled into programs, see filter_program.h. Conjuncts at the root of
+// a program, which are cheap to look up in inverted indexes, are answered with bitmaps, and
+// the program runs over columns only for batches of FILTER_BATCH ids that contain
+// their candidates, or over all batches if no conjunct is selective. Numeric
+// comparisons on columns are done with SIMD.
+// The type of an attribute is fixed by the first vector which has it.
+// It's not thread-safe, and the collection guards it with its lock.
+class AttributeIndex {
+public:
+    // Mark `id` as a live vector.
+    void add(VectorId id);
+
+    // Throw Error if attributes are duplicated, or conflict with types of existing ones.
+    void check(const std::vector<Attribute> &attrs) const;
+
+    // Replace all attributes of `id`, which must pass `check`.
+    void set(VectorId id, const std::vector<Attribute> &attrs);
+
+    // Remove `id` and its attributes.
+    void remove(VectorId id);
+
+    // @return live ids matched by `program`. Throw Error if a literal does not match
+    //         the type of the attribute, e.g. a string compared with an INT attribute.
+    Bitmap evaluate(const FilterProgram &program) const;
+
+    // @return ids in `candidates` matched by `program`, which only runs on batches
+    //         of candidates, e.g. to check a few search results.
+    Bitmap evaluate(const FilterProgram &program, const Bitmap &candidates) const;
+
+    // @return estimated number of live ids matched by `program`, without building
+    //         bitmaps. Comparisons are counted with cardinalities of inverted indexes,
+    //         or sampled from columns if a range spans too many values, and are
+    //         assumed to be independent. Throw Error like `evaluate`.
+    std::size_t estimate(const FilterProgram &program) const;
+
+    std::size_t memory_usage() const;
+
+private:
+    struct Column {
+        AttributeType type;
+
+        // Bit i is set if id i has the attribute, and `ids` has the same ids.
+        std::vector<uint64_t> present;
+        Bitmap ids;
+
+        // id -> value, which is valid only if the id is present.
+        // Tags are stored as their codes.
+        std::vector<uint32_t> tags;
+        std::vector<int64_t> integers;
+        std::vector<double> numbers;
+
+        // tag -> code, and code -> ids with the tag. Codes are never reused.
+        std::unordered_map<std::string, uint32_t> codes;
+        std::vector<Bitmap> tag_ids;
+
+        // value -> ids with the value.
+        std::map<int64_t, Bitmap> integer_ids;
+        std::map<double, Bitmap> number_ids;
+    };
+
+    // A COMPARE instruction resolved against columns. It's unknown for ids without
+    // the attribute, including all ids if no vector has the attribute.
+    struct BoundCompare {
+        enum class Kind {
+            // False for all ids with the attribute, e.g. the tag does not exist.
+            NONE = 0,
+
+            // True for all ids with the attribute, e.g. `year != 1.5`.
+            PRESENT,
+
+            // Compare values with the literal.
+            VALUE
+        };
+
+        Kind kind = Kind::NONE;
+
+        const Column *column = nullptr;
+
+        FilterOp op = FilterOp::EQ;
+
+        // Literal of the column type.
+        uint32_t tag = 0;
+        int64_t integer = 0;
+        double number = 0;
+    };
+
+    // Ids for which an expression is true, and for which it's false. The latter is
+    // only computed if a NOT above the expression needs it.
+    struct BitmapValue {
+        Bitmap truth;
+
+        Bitmap falsity;
+    };
+
+    // Conjuncts are answered with inverted indexes, if they cost less than 1 / INDEX_COST_FACTOR
+    // of the number of values compared by running the program over columns.
+    static constexpr std::size_t INDEX_COST_FACTOR = 8;
+
+    // `estimate` counts a range comparison with at most this number of entries of the
+    // inverted index, otherwise, it samples this number of batches of the column.
+    static constexpr std::size_t ESTIMATE_MAX_ENTRIES = 64;
+    static constexpr std::size_t ESTIMATE_SAMPLE_BATCHES = 8;
+
+    static void _unset(Column &column, VectorId id);
+
+    // Resolve attributes and literals of the program.
+    // @return bound comparisons indexed by instruction.
+    std::vector<BoundCompare> _bind(const FilterProgram &program) const;
+
+    // Round the literal of an INT comparison to an integer, so that values are compared
+    // without conversion, e.g. `val < 1.5` is `val < 2`.
+    static void _bind_integer(double num, BoundCompare &compare);
+
+    // Cost of answering `compare` with inverted indexes, and `falsity` is whether its
+    // false ids are needed. Counting stops once it exceeds `limit`.
+    std::size_t _index_cost(const BoundCompare &compare, bool falsity, std::size_t limit) const;
+
+    BitmapValue _lookup(const BoundCompare &compare, bool falsity) const;
+
+    // Estimated number of ids for which `compare` is true.
+    std::size_t _estimate(const BoundCompare &compare) const;
+
+    std::size_t _sample(const BoundCompare &compare) const;
+
+    // @return ids for which code in [begin, end) of the program, i.e. a sub-expression,
+    //         is true. `needs` are from `value_needs` in attribute_index.cpp.
+    Bitmap _evaluate_index(const FilterProgram &program,
+                            const std::vector<BoundCompare> &compares,
+                            const std::vector<uint8_t> &needs,
+                            std::size_t begin,
+                            std::size_t end) const;
+
+    // Run the program over columns, on batches containing `candidates` if it's not null,
+    // or on all batches with live ids. @return live ids matched.
+    Bitmap _evaluate_columns(const FilterProgram &program,
+                                const std::vector<BoundCompare> &compares,
+                                const Bitmap *candidates) const;
+
+    // Run the program on the batch starting from `base`, and the true mask of the
+    // result is left at the bottom of `stack`.
+    void _run_batch(const FilterProgram &program,
+                    const std::vector<BoundCompare> &compares,
+                    std::size_t base,
+                    uint64_t *stack) const;
+
+    // Write masks of ids for which `compare` is true and false, on the batch starting
+    // from `base`, into `truth` and `falsity`.
+    void _compare(const BoundCompare &compare, std::size_t base, uint64_t *truth, uint64_t *falsity) const;
+
+    std::unordered_map<std::string, Column> _columns;
+
+    // Bit i is set if id i is live.
+    std::vector<uint64_t> _live;
+
+    // Number of live ids.
+    std::size_t _live_cnt = 0;
+};
+
+}
+
+#endif // end SW_VECTOR_ENGINE_ATTRIBUTE_INDEX_H
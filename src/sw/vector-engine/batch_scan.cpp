@@ -0,0 +1,59 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#include "sw/vector-engine/batch_scan.h"
+#include <cassert>
+
+namespace sw::vengine {
+
+BatchScanner::BatchScanner(Metric metric, const float *queries, std::size_t nq,
+                            std::size_t dim, std::size_t stride) :
+    _metric(metric),
+    _queries(queries),
+    _nq(nq),
+    _dim(dim),
+    _stride(stride),
+    _block(std::max<std::size_t>(1, BLOCK_BYTES / (stride * sizeof(float)))),
+    _dot_block(dot_block_func()),
+    _ip(distance_func(Metric::IP)),
+    _query_norms(nq, 0.0f),
+    _norms(_block, 0.0f),
+    _dots(nq * _block) {
+    assert(queries != nullptr && dim > 0 && dim <= stride);
+
+    if (_metric != Metric::IP) {
+        for (std::size_t i = 0; i != _nq; ++i) {
+            const auto *query = _queries + i * _stride;
+            _query_norms[i] = -_ip(query, query, _dim);
+        }
+    }
+}
+
+void BatchScanner::_compute(const float *vecs, std::size_t nv) {
+    assert(nv <= _block);
+
+    _dot_block(_queries, _nq, vecs, nv, _dim, _stride, _dots.data());
+
+    if (_metric != Metric::IP) {
+        for (std::size_t j = 0; j != nv; ++j) {
+            const auto *vec = vecs + j * _stride;
+            _norms[j] = -_ip(vec, vec, _dim);
+        }
+    }
+}
+
+}
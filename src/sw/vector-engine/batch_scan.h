@@ -0,0 +1,101 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#ifndef SW_VECTOR_ENGINE_BATCH_SCAN_H
+#define SW_VECTOR_ENGINE_BATCH_SCAN_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include "sw/vector-engine/distance.h"
+
+namespace sw::vengine {
+
+// Scan float32 vectors for a batch of queries. Vectors are split into blocks which
+// fit in cache, and inner products of a block and all queries are computed by a
+// GEMM kernel, so that each vector is loaded from memory once per batch, instead
+// of once per query. Distances are then derived from inner products and norms.
+class BatchScanner {
+public:
+    // `queries` are `nq` rows of `dim` floats, and rows are `stride` floats apart.
+    // They must be kept alive until the scanner is destroyed.
+    BatchScanner(Metric metric, const float *queries, std::size_t nq,
+                    std::size_t dim, std::size_t stride);
+
+    BatchScanner(const BatchScanner &) = delete;
+    BatchScanner& operator=(const BatchScanner &) = delete;
+
+    BatchScanner(BatchScanner &&) = delete;
+    BatchScanner& operator=(BatchScanner &&) = delete;
+
+    ~BatchScanner() = default;
+
+    // Call `fn(query index, vector index, distance)` for each pair of query and vector,
+    // where `vecs` are `nv` vectors with the same stride as queries.
+    template <typename Fn>
+    void scan(const float *vecs, std::size_t nv, Fn &&fn);
+
+private:
+    // Vectors of a block are reused by all queries, so keep them in L2 cache.
+    static constexpr std::size_t BLOCK_BYTES = 128 * 1024;
+
+    void _compute(const float *vecs, std::size_t nv);
+
+    Metric _metric;
+
+    const float *_queries;
+
+    std::size_t _nq;
+
+    std::size_t _dim;
+
+    std::size_t _stride;
+
+    std::size_t _block;
+
+    DotBlockFunc _dot_block;
+
+    DistanceFunc _ip;
+
+    // Squared norms of queries.
+    std::vector<float> _query_norms;
+
+    // Squared norms of vectors in the current block.
+    std::vector<float> _norms;
+
+    // _nq x _block inner products of the current block.
+    std::vector<float> _dots;
+};
+
+template <typename Fn>
+void BatchScanner::scan(const float *vecs, std::size_t nv, Fn &&fn) {
+    for (std::size_t begin = 0; begin < nv; begin += _block) {
+        auto num = std::min(_block, nv - begin);
+        _compute(vecs + begin * _stride, num);
+
+        for (std::size_t i = 0; i != _nq; ++i) {
+            const auto *dots = _dots.data() + i * num;
+            for (std::size_t j = 0; j != num; ++j) {
+                fn(i, begin + j, distance_from_dot(_metric, dots[j], _query_norms[i], _norms[j]));
+            }
+        }
+    }
+}
+
+}
+
+#endif // end SW_VECTOR_ENGINE_BATCH_SCAN_H
@@ -0,0 +1,111 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#include "sw/vector-engine/binary_index.h"
+#include <algorithm>
+#include <cassert>
+#include <queue>
+#include "sw/vector-engine/errors.h"
+
+namespace sw::vengine {
+
+BinaryIndex::BinaryIndex(const IndexOptions &opts, const VectorStorage &storage, Metric metric) :
+    _storage(storage),
+    _distance(distance_func(metric, storage.type())),
+    _hamming(hamming_func()),
+    _oversample(opts.oversample),
+    _words((storage.dim() + 63) / 64) {
+    if (_oversample == 0) {
+        throw Error("OVERSAMPLE must larger than 0");
+    }
+}
+
+void BinaryIndex::add(VectorId id, const float *vec) {
+    assert(vec != nullptr);
+
+    if (id >= _used.size()) {
+        _used.resize(static_cast<std::size_t>(id) + 1, false);
+        _codes.resize(_used.size() * _words);
+    }
+
+    _used[id] = true;
+    _encode(vec, _codes.data() + static_cast<std::size_t>(id) * _words);
+}
+
+void BinaryIndex::remove(VectorId id) {
+    assert(id < _used.size());
+
+    _used[id] = false;
+}
+
+std::vector<Neighbor> BinaryIndex::search(const float *query, const SearchOptions &opts) const {
+    assert(query != nullptr);
+
+    auto k = opts.k;
+    if (k == 0) {
+        return {};
+    }
+
+    std::vector<uint64_t> code(_words);
+    _encode(query, code.data());
+
+    // Max heap of (hamming distance, id) of the nearest candidates.
+    auto num_candidates = saturated_mul(k, _oversample);
+    std::priority_queue<std::pair<uint32_t, VectorId>> heap;
+    for (std::size_t idx = 0; idx != _used.size(); ++idx) {
+        auto id = static_cast<VectorId>(idx);
+        if (!_used[idx] || !matches(opts.filter, id)) {
+            continue;
+        }
+
+        auto dist = _hamming(code.data(), _codes.data() + idx * _words, _words);
+        if (heap.size() < num_candidates) {
+            heap.emplace(dist, id);
+        } else if (dist < heap.top().first) {
+            heap.pop();
+            heap.emplace(dist, id);
+        }
+    }
+
+    std::vector<Neighbor> candidates;
+    candidates.reserve(heap.size());
+    auto dim = _storage.dim();
+    while (!heap.empty()) {
+        auto id = heap.top().second;
+        heap.pop();
+        candidates.emplace_back(_distance(query, _storage.raw(id), dim), id);
+    }
+
+    k = std::min(k, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + k, candidates.end());
+    candidates.resize(k);
+
+    return candidates;
+}
+
+void BinaryIndex::_encode(const float *vec, uint64_t *code) const {
+    std::fill(code, code + _words, 0);
+
+    auto dim = _storage.dim();
+    for (std::size_t i = 0; i != dim; ++i) {
+        if (vec[i] > 0) {
+            code[i / 64] |= uint64_t(1) << (i % 64);
+        }
+    }
+}
+
+}
@@ -0,0 +1,68 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#ifndef SW_VECTOR_ENGINE_BINARY_INDEX_H
+#define SW_VECTOR_ENGINE_BINARY_INDEX_H
+
+#include <cstdint>
+#include <vector>
+#include "sw/vector-engine/index.h"
+
+namespace sw::vengine {
+
+// Exhaustive search over 1-bit codes: each dimension is encoded as its sign bit, and
+// codes are compared by Hamming distance. Since the distance is coarse, `oversample * k`
+// candidates are rescored with exact distances against raw vectors. It works well for
+// high dimensional embeddings, e.g. 1024+ dimensions.
+class BinaryIndex : public Index {
+public:
+    BinaryIndex(const IndexOptions &opts, const VectorStorage &storage, Metric metric);
+
+    virtual void add(VectorId id, const float *vec) override;
+
+    virtual void remove(VectorId id) override;
+
+    virtual std::vector<Neighbor> search(const float *query, const SearchOptions &opts) const override;
+
+    virtual std::size_t memory_usage() const override {
+        return _codes.capacity() * sizeof(uint64_t) + _used.capacity() / 8;
+    }
+
+private:
+    void _encode(const float *vec, uint64_t *code) const;
+
+    const VectorStorage &_storage;
+
+    StoredDistanceFunc _distance;
+
+    HammingFunc _hamming;
+
+    std::size_t _oversample;
+
+    // Number of 64-bit words of a code.
+    std::size_t _words;
+
+    // `words` words for each id, and bit i is set if dimension i is positive.
+    std::vector<uint64_t> _codes;
+
+    // Whether the id is in use, i.e. not deleted.
+    std::vector<bool> _used;
+};
+
+}
+
+#endif // end SW_VECTOR_ENGINE_BINARY_INDEX_H
@@ -0,0 +1,400 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#include "sw/vector-engine/bitmap.h"
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+namespace sw::vengine {
+
+namespace {
+
+uint32_t popcount(const std::vector<uint64_t> &bits) {
+    uint32_t cnt = 0;
+    for (auto word : bits) {
+        cnt += static_cast<uint32_t>(__builtin_popcountll(word));
+    }
+
+    return cnt;
+}
+
+bool test(const std::vector<uint64_t> &bits, uint16_t low) {
+    return (bits[low >> 6] >> (low & 63)) & 1;
+}
+
+}
+
+void Bitmap::add(uint32_t val) {
+    auto low = _low(val);
+    auto &container = _get_or_create(_high(val));
+    if (container.is_bitset()) {
+        auto &word = container.bits[low >> 6];
+        auto mask = uint64_t(1) << (low & 63);
+        if ((word & mask) == 0) {
+            word |= mask;
+            ++container.cardinality;
+            ++_cardinality;
+        }
+        return;
+    }
+
+    auto &array = container.array;
+    auto iter = std::lower_bound(array.begin(), array.end(), low);
+    if (iter != array.end() && *iter == low) {
+        return;
+    }
+
+    array.insert(iter, low);
+    ++container.cardinality;
+    ++_cardinality;
+    container.normalize();
+}
+
+void Bitmap::add_word(uint32_t base, uint64_t word) {
+    assert(base % 64 == 0);
+
+    if (word == 0) {
+        return;
+    }
+
+    // All bits are in the same container, since containers are aligned to 64.
+    auto low = _low(base);
+    auto &container = _get_or_create(_high(base));
+    if (container.is_bitset()) {
+        auto &bits = container.bits[low >> 6];
+        auto cnt = static_cast<uint32_t>(__builtin_popcountll(word & ~bits));
+        container.cardinality += cnt;
+        _cardinality += cnt;
+        bits |= word;
+        return;
+    }
+
+    auto &array = container.array;
+    while (word != 0) {
+        auto val = static_cast<uint16_t>(low + __builtin_ctzll(word));
+        word &= word - 1;
+
+        // Words are usually added in ascending order, i.e. appended.
+        auto iter = array.empty() || array.back() < val ? array.end()
+                        : std::lower_bound(array.begin(), array.end(), val);
+        if (iter == array.end() || *iter != val) {
+            array.insert(iter, val);
+            ++container.cardinality;
+            ++_cardinality;
+        }
+    }
+
+    container.normalize();
+}
+
+void Bitmap::remove(uint32_t val) {
+    auto key = _high(val);
+    auto low = _low(val);
+    auto idx = _lower_bound(key);
+    if (idx == _containers.size() || _containers[idx].key != key) {
+        return;
+    }
+
+    auto &container = _containers[idx];
+    if (container.is_bitset()) {
+        auto &word = container.bits[low >> 6];
+        auto mask = uint64_t(1) << (low & 63);
+        if ((word & mask) == 0) {
+            return;
+        }
+        word &= ~mask;
+    } else {
+        auto &array = container.array;
+        auto iter = std::lower_bound(array.begin(), array.end(), low);
+        if (iter == array.end() || *iter != low) {
+            return;
+        }
+        array.erase(iter);
+    }
+
+    --_cardinality;
+    if (--container.cardinality == 0) {
+        _containers.erase(_containers.begin() + idx);
+    } else {
+        container.normalize();
+    }
+}
+
+bool Bitmap::contains(uint32_t val) const {
+    auto key = _high(val);
+    auto idx = _lower_bound(key);
+
+    return idx != _containers.size() && _containers[idx].key == key
+        && _containers[idx].contains(_low(val));
+}
+
+Bitmap& Bitmap::operator|=(const Bitmap &other) {
+    std::vector<Container> containers;
+    containers.reserve(_containers.size() + other._containers.size());
+
+    auto iter = _containers.begin();
+    auto other_iter = other._containers.begin();
+    while (iter != _containers.end() || other_iter != other._containers.end()) {
+        if (other_iter == other._containers.end()
+                || (iter != _containers.end() && iter->key < other_iter->key)) {
+            containers.push_back(std::move(*iter++));
+        } else if (iter == _containers.end() || other_iter->key < iter->key) {
+            containers.push_back(*other_iter++);
+        } else {
+            _union(*iter, *other_iter++);
+            containers.push_back(std::move(*iter++));
+        }
+    }
+
+    _containers = std::move(containers);
+    _update_cardinality();
+
+    return *this;
+}
+
+Bitmap& Bitmap::operator&=(const Bitmap &other) {
+    std::vector<Container> containers;
+    auto other_iter = other._containers.begin();
+    for (auto &container : _containers) {
+        while (other_iter != other._containers.end() && other_iter->key < container.key) {
+            ++other_iter;
+        }
+
+        if (other_iter == other._containers.end()) {
+            break;
+        }
+
+        if (other_iter->key == container.key) {
+            _intersect(container, *other_iter);
+            if (container.cardinality > 0) {
+                containers.push_back(std::move(container));
+            }
+        }
+    }
+
+    _containers = std::move(containers);
+    _update_cardinality();
+
+    return *this;
+}
+
+Bitmap& Bitmap::operator-=(const Bitmap &other) {
+    std::vector<Container> containers;
+    containers.reserve(_containers.size());
+
+    auto other_iter = other._containers.begin();
+    for (auto &container : _containers) {
+        while (other_iter != other._containers.end() && other_iter->key < container.key) {
+            ++other_iter;
+        }
+
+        if (other_iter != other._containers.end() && other_iter->key == container.key) {
+            _subtract(container, *other_iter);
+        }
+
+        if (container.cardinality > 0) {
+            containers.push_back(std::move(container));
+        }
+    }
+
+    _containers = std::move(containers);
+    _update_cardinality();
+
+    return *this;
+}
+
+std::vector<uint32_t> Bitmap::to_vector() const {
+    std::vector<uint32_t> vals;
+    vals.reserve(cardinality());
+    for_each([&vals](uint32_t val) { vals.push_back(val); });
+
+    return vals;
+}
+
+std::size_t Bitmap::memory_usage() const {
+    auto usage = _containers.capacity() * sizeof(Container);
+    for (const auto &container : _containers) {
+        usage += container.array.capacity() * sizeof(uint16_t);
+        usage += container.bits.capacity() * sizeof(uint64_t);
+    }
+
+    return usage;
+}
+
+void Bitmap::_update_cardinality() noexcept {
+    _cardinality = 0;
+    for (const auto &container : _containers) {
+        _cardinality += container.cardinality;
+    }
+}
+
+bool Bitmap::Container::contains(uint16_t low) const {
+    if (is_bitset()) {
+        return test(bits, low);
+    }
+
+    return std::binary_search(array.begin(), array.end(), low);
+}
+
+void Bitmap::Container::normalize() {
+    if (is_bitset()) {
+        if (cardinality > ARRAY_MAX_SIZE) {
+            return;
+        }
+
+        array.clear();
+        array.reserve(cardinality);
+        for (std::size_t idx = 0; idx != BITSET_WORDS; ++idx) {
+            auto word = bits[idx];
+            while (word != 0) {
+                array.push_back(static_cast<uint16_t>(idx * 64 + __builtin_ctzll(word)));
+                word &= word - 1;
+            }
+        }
+
+        bits.clear();
+        bits.shrink_to_fit();
+    } else {
+        if (cardinality <= ARRAY_MAX_SIZE) {
+            return;
+        }
+
+        bits.assign(BITSET_WORDS, 0);
+        for (auto low : array) {
+            bits[low >> 6] |= uint64_t(1) << (low & 63);
+        }
+
+        array.clear();
+        array.shrink_to_fit();
+    }
+}
+
+std::size_t Bitmap::_lower_bound(uint16_t key) const {
+    auto iter = std::lower_bound(_containers.begin(), _containers.end(), key,
+            [](const Container &container, uint16_t k) { return container.key < k; });
+
+    return static_cast<std::size_t>(iter - _containers.begin());
+}
+
+Bitmap::Container& Bitmap::_get_or_create(uint16_t key) {
+    auto idx = _lower_bound(key);
+    if (idx == _containers.size() || _containers[idx].key != key) {
+        Container container;
+        container.key = key;
+        _containers.insert(_containers.begin() + idx, std::move(container));
+    }
+
+    return _containers[idx];
+}
+
+void Bitmap::_union(Container &dst, const Container &src) {
+    assert(dst.key == src.key);
+
+    if (!dst.is_bitset() && !src.is_bitset()) {
+        std::vector<uint16_t> merged;
+        merged.reserve(dst.array.size() + src.array.size());
+        std::set_union(dst.array.begin(), dst.array.end(),
+                src.array.begin(), src.array.end(), std::back_inserter(merged));
+        dst.array = std::move(merged);
+        dst.cardinality = static_cast<uint32_t>(dst.array.size());
+        dst.normalize();
+        return;
+    }
+
+    if (!dst.is_bitset()) {
+        auto array = std::move(dst.array);
+        dst.array.clear();
+        dst.bits = src.bits;
+        for (auto low : array) {
+            dst.bits[low >> 6] |= uint64_t(1) << (low & 63);
+        }
+    } else if (src.is_bitset()) {
+        for (std::size_t idx = 0; idx != BITSET_WORDS; ++idx) {
+            dst.bits[idx] |= src.bits[idx];
+        }
+    } else {
+        for (auto low : src.array) {
+            dst.bits[low >> 6] |= uint64_t(1) << (low & 63);
+        }
+    }
+
+    dst.cardinality = popcount(dst.bits);
+}
+
+void Bitmap::_intersect(Container &dst, const Container &src) {
+    assert(dst.key == src.key);
+
+    if (dst.is_bitset() && src.is_bitset()) {
+        for (std::size_t idx = 0; idx != BITSET_WORDS; ++idx) {
+            dst.bits[idx] &= src.bits[idx];
+        }
+        dst.cardinality = popcount(dst.bits);
+        dst.normalize();
+        return;
+    }
+
+    std::vector<uint16_t> result;
+    if (!dst.is_bitset() && !src.is_bitset()) {
+        std::set_intersection(dst.array.begin(), dst.array.end(),
+                src.array.begin(), src.array.end(), std::back_inserter(result));
+    } else if (dst.is_bitset()) {
+        for (auto low : src.array) {
+            if (test(dst.bits, low)) {
+                result.push_back(low);
+            }
+        }
+        dst.bits.clear();
+        dst.bits.shrink_to_fit();
+    } else {
+        for (auto low : dst.array) {
+            if (test(src.bits, low)) {
+                result.push_back(low);
+            }
+        }
+    }
+
+    dst.array = std::move(result);
+    dst.cardinality = static_cast<uint32_t>(dst.array.size());
+}
+
+void Bitmap::_subtract(Container &dst, const Container &src) {
+    assert(dst.key == src.key);
+
+    if (dst.is_bitset()) {
+        if (src.is_bitset()) {
+            for (std::size_t idx = 0; idx != BITSET_WORDS; ++idx) {
+                dst.bits[idx] &= ~src.bits[idx];
+            }
+        } else {
+            for (auto low : src.array) {
+                dst.bits[low >> 6] &= ~(uint64_t(1) << (low & 63));
+            }
+        }
+        dst.cardinality = popcount(dst.bits);
+        dst.normalize();
+        return;
+    }
+
+    auto &array = dst.array;
+    array.erase(std::remove_if(array.begin(), array.end(),
+                [&src](uint16_t low) { return src.contains(low); }),
+            array.end());
+    dst.cardinality = static_cast<uint32_t>(array.size());
+}
+
+}
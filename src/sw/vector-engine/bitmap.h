@@ -0,0 +1,144 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#ifndef SW_VECTOR_ENGINE_BITMAP_H
+#define SW_VECTOR_ENGINE_BITMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sw::vengine {
+
+// Compressed bitmap of 32-bit integers in the style of Roaring bitmaps. Integers are
+// partitioned by their high 16 bits into containers, and a container keeps the low
+// 16 bits either in a sorted array if it has at most 4096 integers, or in a bitset
+// of 65536 bits, so that a container never takes more than 8KB.
+class Bitmap {
+public:
+    void add(uint32_t val);
+
+    // Add `base + i` for each set bit i of `word`, and `base` must be a multiple of 64.
+    void add_word(uint32_t base, uint64_t word);
+
+    void remove(uint32_t val);
+
+    bool contains(uint32_t val) const;
+
+    bool empty() const noexcept {
+        return _containers.empty();
+    }
+
+    std::size_t cardinality() const noexcept {
+        return _cardinality;
+    }
+
+    Bitmap& operator|=(const Bitmap &other);
+
+    Bitmap& operator&=(const Bitmap &other);
+
+    // Remove integers in `other`.
+    Bitmap& operator-=(const Bitmap &other);
+
+    // Call `fn(val)` for each integer in ascending order.
+    template <typename Fn>
+    void for_each(Fn &&fn) const;
+
+    std::vector<uint32_t> to_vector() const;
+
+    std::size_t memory_usage() const;
+
+private:
+    static constexpr std::size_t ARRAY_MAX_SIZE = 4096;
+    static constexpr std::size_t BITSET_WORDS = 65536 / 64;
+
+    struct Container {
+        uint16_t key = 0;
+
+        uint32_t cardinality = 0;
+
+        // Sorted low bits, if `bits` is empty.
+        std::vector<uint16_t> array;
+
+        // BITSET_WORDS words, if the container is dense.
+        std::vector<uint64_t> bits;
+
+        bool is_bitset() const noexcept {
+            return !bits.empty();
+        }
+
+        bool contains(uint16_t low) const;
+
+        // Convert to the proper representation for the cardinality.
+        void normalize();
+    };
+
+    static uint16_t _high(uint32_t val) noexcept {
+        return static_cast<uint16_t>(val >> 16);
+    }
+
+    static uint16_t _low(uint32_t val) noexcept {
+        return static_cast<uint16_t>(val & 0xFFFF);
+    }
+
+    // @return index of the first container whose key is not less than `key`.
+    std::size_t _lower_bound(uint16_t key) const;
+
+    // @return the container of `key`, which is created if it does not exist.
+    Container& _get_or_create(uint16_t key);
+
+    static void _union(Container &dst, const Container &src);
+
+    static void _intersect(Container &dst, const Container &src);
+
+    static void _subtract(Container &dst, const Container &src);
+
+    // Sum cardinalities of containers, after they're merged with another bitmap.
+    void _update_cardinality() noexcept;
+
+    // Sorted by key, and empty containers are removed.
+    std::vector<Container> _containers;
+
+    // Sum of cardinalities of containers, so that it's cheap to estimate selectivity.
+    std::size_t _cardinality = 0;
+};
+
+template <typename Fn>
+void Bitmap::for_each(Fn &&fn) const {
+    for (const auto &container : _containers) {
+        auto base = static_cast<uint32_t>(container.key) << 16;
+        if (!container.is_bitset()) {
+            for (auto low : container.array) {
+                fn(base | low);
+            }
+            continue;
+        }
+
+        for (std::size_t idx = 0; idx != BITSET_WORDS; ++idx) {
+            auto word = container.bits[idx];
+            while (word != 0) {
+                auto bit = static_cast<uint32_t>(__builtin_ctzll(word));
+                fn(base | static_cast<uint32_t>(idx * 64 + bit));
+                word &= word - 1;
+            }
+        }
+    }
+}
+
+}
+
+#endif // end SW_VECTOR_ENGINE_BITMAP_H
@@ -0,0 +1,85 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#include "sw/vector-engine/buffer_pool.h"
+#include <cassert>
+#include "sw/vector-engine/errors.h"
+
+namespace sw::vengine {
+
+BufferPool::BufferPool(std::size_t chunk_size, std::size_t max_free_chunks) :
+    _chunk_size(chunk_size),
+    _max_free_chunks(max_free_chunks) {
+    if (_chunk_size == 0) {
+        throw Error("chunk size of buffer pool must larger than 0");
+    }
+}
+
+std::shared_ptr<std::string> BufferPool::acquire() {
+    std::unique_ptr<std::string> chunk;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        if (!_free_chunks.empty()) {
+            chunk = std::move(_free_chunks.back());
+            _free_chunks.pop_back();
+        }
+    }
+
+    if (chunk) {
+        _hits.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        _misses.fetch_add(1, std::memory_order_relaxed);
+        chunk = std::make_unique<std::string>(_chunk_size, '\0');
+    }
+
+    _used_chunks.fetch_add(1, std::memory_order_relaxed);
+
+    auto pool = shared_from_this();
+    return std::shared_ptr<std::string>(chunk.release(),
+            [pool](std::string *c) { pool->_release(c); });
+}
+
+BufferPoolStats BufferPool::stats() const {
+    BufferPoolStats stats;
+    stats.chunk_size = _chunk_size;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        stats.free_chunks = _free_chunks.size();
+    }
+    stats.used_chunks = _used_chunks.load(std::memory_order_relaxed);
+    stats.hits = _hits.load(std::memory_order_relaxed);
+    stats.misses = _misses.load(std::memory_order_relaxed);
+
+    return stats;
+}
+
+void BufferPool::_release(std::string *c) {
+    assert(c != nullptr);
+
+    std::unique_ptr<std::string> chunk(c);
+
+    _used_chunks.fetch_sub(1, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (_free_chunks.size() < _max_free_chunks) {
+        _free_chunks.push_back(std::move(chunk));
+    }
+    // Otherwise, chunk is freed.
+}
+
+}
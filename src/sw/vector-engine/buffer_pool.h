@@ -0,0 +1,95 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#ifndef SW_VECTOR_ENGINE_BUFFER_POOL_H
+#define SW_VECTOR_ENGINE_BUFFER_POOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace sw::vengine {
+
+struct BufferPoolStats {
+    std::size_t chunk_size = 0;
+
+    // Number of chunks cached in the pool.
+    std::size_t free_chunks = 0;
+
+    // Number of chunks held by read buffers or pinned by requests.
+    std::size_t used_chunks = 0;
+
+    uint64_t hits = 0;
+
+    uint64_t misses = 0;
+
+    double hit_rate() const {
+        auto total = hits + misses;
+        return total == 0 ? 0 : static_cast<double>(hits) / total;
+    }
+};
+
+// Slab pool of fixed-size chunks shared by read buffers of a reactor loop.
+// Chunks go back to the pool once they are no longer referenced, which might
+// happen on worker threads, since requests pin chunks until they finish.
+class BufferPool : public std::enable_shared_from_this<BufferPool> {
+public:
+    // At most `max_free_chunks` unused chunks are cached, and the others are freed.
+    BufferPool(std::size_t chunk_size, std::size_t max_free_chunks);
+
+    BufferPool(const BufferPool &) = delete;
+    BufferPool& operator=(const BufferPool &) = delete;
+
+    BufferPool(BufferPool &&) = delete;
+    BufferPool& operator=(BufferPool &&) = delete;
+
+    ~BufferPool() = default;
+
+    // The pool MUST be owned by a std::shared_ptr, since chunks keep the pool alive.
+    std::shared_ptr<std::string> acquire();
+
+    std::size_t chunk_size() const noexcept {
+        return _chunk_size;
+    }
+
+    BufferPoolStats stats() const;
+
+private:
+    void _release(std::string *chunk);
+
+    std::size_t _chunk_size;
+
+    std::size_t _max_free_chunks;
+
+    mutable std::mutex _mutex;
+
+    std::vector<std::unique_ptr<std::string>> _free_chunks;
+
+    std::atomic<std::size_t> _used_chunks{0};
+
+    std::atomic<uint64_t> _hits{0};
+
+    std::atomic<uint64_t> _misses{0};
+};
+
+using BufferPoolSPtr = std::shared_ptr<BufferPool>;
+
+}
+
+#endif // end SW_VECTOR_ENGINE_BUFFER_POOL_H
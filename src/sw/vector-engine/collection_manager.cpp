@@ -0,0 +1,74 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#include "sw/vector-engine/collection_manager.h"
+#include "sw/vector-engine/errors.h"
+
+namespace sw::vengine {
+
+CollectionManager& CollectionManager::instance() {
+    static CollectionManager inst;
+    return inst;
+}
+
+VectorCollectionSPtr CollectionManager::get(const std::string &name) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto iter = _collections.find(name);
+    if (iter == _collections.end()) {
+        return nullptr;
+    }
+
+    return iter->second;
+}
+
+bool CollectionManager::create(const std::string &name,
+                                std::size_t dim,
+                                Metric metric,
+                                const IndexOptions &index_opts,
+                                ElementType type) {
+    // Construct it before locking, since it might throw on invalid options.
+    auto collection = std::make_shared<VectorCollection>(dim, metric, index_opts, type);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    return _collections.emplace(name, std::move(collection)).second;
+}
+
+VectorCollectionSPtr CollectionManager::get_or_create(const std::string &name, std::size_t dim) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto iter = _collections.find(name);
+    if (iter == _collections.end()) {
+        iter = _collections.emplace(name, std::make_shared<VectorCollection>(dim)).first;
+    }
+
+    auto &collection = iter->second;
+    if (collection->dim() != dim) {
+        throw Error("dimension mismatch, expect " + std::to_string(collection->dim())
+                + ", got " + std::to_string(dim));
+    }
+
+    return collection;
+}
+
+bool CollectionManager::remove(const std::string &name) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    return _collections.erase(name) > 0;
+}
+
+}
@@ -0,0 +1,65 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#ifndef SW_VECTOR_ENGINE_COLLECTION_MANAGER_H
+#define SW_VECTOR_ENGINE_COLLECTION_MANAGER_H
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "sw/vector-engine/vector_collection.h"
+
+namespace sw::vengine {
+
+// Registry of collections, which is shared by all workers.
+class CollectionManager {
+public:
+    static CollectionManager& instance();
+
+    CollectionManager(const CollectionManager &) = delete;
+    CollectionManager& operator=(const CollectionManager &) = delete;
+    CollectionManager(CollectionManager &&) = delete;
+    CollectionManager& operator=(CollectionManager &&) = delete;
+
+    // @return nullptr if the collection does not exist.
+    VectorCollectionSPtr get(const std::string &name) const;
+
+    // Create a collection with `dim`, `metric`, index and element type.
+    // @return false if the collection already exists.
+    bool create(const std::string &name,
+                std::size_t dim,
+                Metric metric,
+                const IndexOptions &index_opts,
+                ElementType type = ElementType::FLOAT32);
+
+    // Get the collection, and create it with `dim` if it does not exist.
+    // Throw Error if the existing collection has a different dimension.
+    VectorCollectionSPtr get_or_create(const std::string &name, std::size_t dim);
+
+    // @return true if the collection exists and has been removed.
+    bool remove(const std::string &name);
+
+private:
+    CollectionManager() = default;
+
+    mutable std::mutex _mutex;
+
+    std::unordered_map<std::string, VectorCollectionSPtr> _collections;
+};
+
+}
+
+#endif // end SW_VECTOR_ENGINE_COLLECTION_MANAGER_H
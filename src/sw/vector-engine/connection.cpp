@@ -53,7 +53,7 @@ void Connection::on_read(uv_stream_t *client, ssize_t nread, const uv_buf_t * /*
         buffer.occupy(nread);
 
         try {
-            auto [tasks, len] = conn->_parse_request(buffer.data());
+            auto [tasks, len] = conn->_parse_request(buffer);
             if (!tasks.empty()) {
                 assert(len > 0);
 
@@ -61,16 +61,28 @@ void Connection::on_read(uv_stream_t *client, ssize_t nread, const uv_buf_t * /*
 
                 ResponseBuilderCreator creator;
                 auto response_builder = creator.create(conn->_protocol_opts.type);
-                conn->_reactor.dispatch(conn->id(), std::move(tasks), std::move(response_builder));
+                auto seq = conn->_next_seq;
+                conn->_next_seq += tasks.size();
+                conn->_reactor.dispatch(conn->id(),
+                        seq,
+                        std::move(tasks),
+                        std::move(response_builder),
+                        conn->_order);
             }
         } catch (const Error &e) {
             // TODO: do log and send error reply
-            std::cerr << e.what() << ", " << buffer.data() << std::endl;
+            std::cerr << e.what() << std::endl;
             uv::handle_close(client, on_close);
             return;
         }
     }
 
+    if (nread == 0) {
+        // Nothing read, e.g. EAGAIN, give back the chunk allocated by `on_alloc`.
+        auto *conn = uv::get_data<Connection>(client);
+        conn->_read_buf.shrink();
+    }
+
     if (nread < 0) {
         if (nread != UV_EOF) {
             // TODO: do log
@@ -84,18 +96,44 @@ void Connection::on_read(uv_stream_t *client, ssize_t nread, const uv_buf_t * /*
 Connection::Connection(ConnectionId id,
     const ConnectionOptions &opts,
     const ProtocolOptions &protocol_opts,
+    const BufferPoolSPtr &buffer_pool,
     Reactor &reactor) :
     _id(id),
-    _read_buf(opts.read_buf_min_size, opts.read_buf_max_size),
+    _read_buf(buffer_pool, opts.read_buf_max_size),
     _protocol_opts(protocol_opts),
+    _parser(RequestParserCreator{}.create(protocol_opts.type, opts.read_buf_max_size)),
+    _order(std::make_shared<TaskOrder>()),
     _reactor(reactor) {
 }
 
-auto Connection::_parse_request(std::string_view buffer) const
+std::vector<Reply> Connection::reorder(std::vector<Reply> replies) {
+    std::vector<Reply> ready;
+    ready.reserve(replies.size());
+    for (auto &reply : replies) {
+        if (reply.seq != _next_reply_seq) {
+            _pending_replies.emplace(reply.seq, std::move(reply));
+            continue;
+        }
+
+        _next_reply_seq += reply.num;
+        ready.push_back(std::move(reply));
+
+        for (auto iter = _pending_replies.begin();
+                iter != _pending_replies.end() && iter->first == _next_reply_seq; ) {
+            _next_reply_seq += iter->second.num;
+            ready.push_back(std::move(iter->second));
+            iter = _pending_replies.erase(iter);
+        }
+    }
+
+    return ready;
+}
+
+auto Connection::_parse_request(const ReadBuffer &buffer)
     -> std::pair<std::vector<TaskUPtr>, std::size_t> {
-    RequestParserCreator creator;
-    auto parser = creator.create(_protocol_opts.type);
-    return parser->parse(buffer);
+    assert(_parser);
+
+    return _parser->parse(buffer);
 }
 
 }
@@ -17,6 +17,10 @@
 #ifndef SW_VECTOR_ENGINE_CONNECTION_H
 #define SW_VECTOR_ENGINE_CONNECTION_H
 
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
 #include "sw/vector-engine/read_buffer.h"
 #include "sw/vector-engine/protocol.h"
 #include "sw/vector-engine/uv_utils.h"
@@ -25,19 +29,36 @@ namespace sw::vengine {
 
 class Reactor;
 class Task;
+struct TaskOrder;
 
 struct ConnectionOptions {
-    std::size_t read_buf_min_size;
+    // Read buffer is built from chunks of this size.
+    std::size_t read_buf_chunk_size;
     std::size_t read_buf_max_size;
+
+    // Max number of free chunks cached by the buffer pool of each reactor.
+    std::size_t read_buf_pool_size;
 };
 
 using ConnectionId = uint64_t;
 
+struct Reply {
+    ConnectionId connection_id;
+
+    // Replies of tasks [seq, seq + num) of the connection.
+    uint64_t seq;
+
+    std::size_t num;
+
+    std::string reply;
+};
+
 class Connection {
 public:
     Connection(ConnectionId id,
         const ConnectionOptions &opts,
         const ProtocolOptions &protocol_opts,
+        const BufferPoolSPtr &buffer_pool,
         Reactor &reactor);
 
     Connection(const Connection &) = delete;
@@ -58,8 +79,12 @@ public:
 
     static void on_read(uv_stream_t *client, ssize_t nread, const uv_buf_t *buf);
 
+    // Buffer replies that arrive before their predecessors.
+    // @return replies that are ready to be sent, in order of sequence number.
+    std::vector<Reply> reorder(std::vector<Reply> replies);
+
 private:
-    auto _parse_request(std::string_view buffer) const
+    auto _parse_request(const ReadBuffer &buffer)
         -> std::pair<std::vector<std::unique_ptr<Task>>, std::size_t>;
 
     ConnectionId _id;
@@ -68,6 +93,21 @@ private:
 
     ProtocolOptions _protocol_opts;
 
+    // Lives as long as the connection, and keeps the state of the incomplete request.
+    RequestParserUPtr _parser;
+
+    // Sequence number of the next dispatched task.
+    uint64_t _next_seq = 0;
+
+    // Sequence number of the task whose reply should be sent next.
+    uint64_t _next_reply_seq = 0;
+
+    // map<seq, reply>, replies waiting for their predecessors.
+    std::map<uint64_t, Reply> _pending_replies;
+
+    // Orders tasks of all batches of the connection.
+    std::shared_ptr<TaskOrder> _order;
+
     Reactor &_reactor;
 };
 
@@ -0,0 +1,893 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#include "sw/vector-engine/distance.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "sw/vector-engine/errors.h"
+#include "sw/vector-engine/str_utils.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define VECTOR_ENGINE_X86 1
+#include <immintrin.h>
+#endif
+
+namespace sw::vengine {
+
+namespace {
+
+float cosine(float dot, float norm_a, float norm_b) {
+    auto norm = norm_a * norm_b;
+    if (norm <= 0) {
+        // Zero vector is orthogonal to any vector.
+        return 1.0f;
+    }
+
+    return 1.0f - dot / std::sqrt(norm);
+}
+
+float l2_scalar(const float *a, const float *b, std::size_t dim) {
+    float sum = 0;
+    for (std::size_t i = 0; i != dim; ++i) {
+        auto diff = a[i] - b[i];
+        sum += diff * diff;
+    }
+
+    return sum;
+}
+
+float ip_scalar(const float *a, const float *b, std::size_t dim) {
+    float sum = 0;
+    for (std::size_t i = 0; i != dim; ++i) {
+        sum += a[i] * b[i];
+    }
+
+    return -sum;
+}
+
+float cosine_scalar(const float *a, const float *b, std::size_t dim) {
+    float dot = 0;
+    float norm_a = 0;
+    float norm_b = 0;
+    for (std::size_t i = 0; i != dim; ++i) {
+        dot += a[i] * b[i];
+        norm_a += a[i] * a[i];
+        norm_b += b[i] * b[i];
+    }
+
+    return cosine(dot, norm_a, norm_b);
+}
+
+int32_t int8_dot_scalar(const uint8_t *a, const int8_t *b, std::size_t dim) {
+    int32_t sum = 0;
+    for (std::size_t i = 0; i != dim; ++i) {
+        sum += static_cast<int32_t>(a[i]) * b[i];
+    }
+
+    return sum;
+}
+
+uint32_t hamming_scalar(const uint64_t *a, const uint64_t *b, std::size_t words) {
+    uint32_t dist = 0;
+    for (std::size_t i = 0; i != words; ++i) {
+        dist += static_cast<uint32_t>(__builtin_popcountll(a[i] ^ b[i]));
+    }
+
+    return dist;
+}
+
+void dot_block_scalar(const float *queries, std::size_t nq,
+                        const float *vecs, std::size_t nv,
+                        std::size_t dim, std::size_t stride, float *out) {
+    for (std::size_t i = 0; i != nq; ++i) {
+        for (std::size_t j = 0; j != nv; ++j) {
+            out[i * nv + j] = -ip_scalar(queries + i * stride, vecs + j * stride, dim);
+        }
+    }
+}
+
+#ifdef VECTOR_ENGINE_X86
+
+// Same as the scalar one, but __builtin_popcountll is compiled into the popcnt instruction.
+__attribute__((target("popcnt")))
+uint32_t hamming_popcnt(const uint64_t *a, const uint64_t *b, std::size_t words) {
+    uint32_t dist = 0;
+    for (std::size_t i = 0; i != words; ++i) {
+        dist += static_cast<uint32_t>(__builtin_popcountll(a[i] ^ b[i]));
+    }
+
+    return dist;
+}
+
+__attribute__((target("avx2,fma")))
+float hsum256(__m256 v) {
+    auto lo = _mm256_castps256_ps128(v);
+    auto hi = _mm256_extractf128_ps(v, 1);
+    lo = _mm_add_ps(lo, hi);
+    lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+    lo = _mm_add_ss(lo, _mm_movehdup_ps(lo));
+
+    return _mm_cvtss_f32(lo);
+}
+
+// Two accumulators hide the latency of FMA.
+__attribute__((target("avx2,fma")))
+float l2_avx2(const float *a, const float *b, std::size_t dim) {
+    auto sum0 = _mm256_setzero_ps();
+    auto sum1 = _mm256_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 16 <= dim; i += 16) {
+        auto d0 = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        auto d1 = _mm256_sub_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8));
+        sum0 = _mm256_fmadd_ps(d0, d0, sum0);
+        sum1 = _mm256_fmadd_ps(d1, d1, sum1);
+    }
+    for (; i + 8 <= dim; i += 8) {
+        auto d = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        sum0 = _mm256_fmadd_ps(d, d, sum0);
+    }
+
+    return hsum256(_mm256_add_ps(sum0, sum1)) + l2_scalar(a + i, b + i, dim - i);
+}
+
+__attribute__((target("avx2,fma")))
+float ip_avx2(const float *a, const float *b, std::size_t dim) {
+    auto sum0 = _mm256_setzero_ps();
+    auto sum1 = _mm256_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 16 <= dim; i += 16) {
+        sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum0);
+        sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), sum1);
+    }
+    for (; i + 8 <= dim; i += 8) {
+        sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum0);
+    }
+
+    return -hsum256(_mm256_add_ps(sum0, sum1)) + ip_scalar(a + i, b + i, dim - i);
+}
+
+__attribute__((target("avx2,fma")))
+float cosine_avx2(const float *a, const float *b, std::size_t dim) {
+    auto dot = _mm256_setzero_ps();
+    auto norm_a = _mm256_setzero_ps();
+    auto norm_b = _mm256_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 8 <= dim; i += 8) {
+        auto va = _mm256_loadu_ps(a + i);
+        auto vb = _mm256_loadu_ps(b + i);
+        dot = _mm256_fmadd_ps(va, vb, dot);
+        norm_a = _mm256_fmadd_ps(va, va, norm_a);
+        norm_b = _mm256_fmadd_ps(vb, vb, norm_b);
+    }
+
+    auto d = hsum256(dot);
+    auto na = hsum256(norm_a);
+    auto nb = hsum256(norm_b);
+    for (; i != dim; ++i) {
+        d += a[i] * b[i];
+        na += a[i] * a[i];
+        nb += b[i] * b[i];
+    }
+
+    return cosine(d, na, nb);
+}
+
+// vpmaddubsw might saturate with 8-bit inputs, so widen to 16-bit and use vpmaddwd instead.
+__attribute__((target("avx2")))
+int32_t int8_dot_avx2(const uint8_t *a, const int8_t *b, std::size_t dim) {
+    auto sum = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 16 <= dim; i += 16) {
+        auto va = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+        auto vb = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(va, vb));
+    }
+
+    auto lo = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    lo = _mm_add_epi32(lo, _mm_shuffle_epi32(lo, _MM_SHUFFLE(1, 0, 3, 2)));
+    lo = _mm_add_epi32(lo, _mm_shuffle_epi32(lo, _MM_SHUFFLE(2, 3, 0, 1)));
+
+    return _mm_cvtsi128_si32(lo) + int8_dot_scalar(a + i, b + i, dim - i);
+}
+
+// Micro kernel of 4 queries and 1 vector: each load of the vector feeds 4 FMAs.
+__attribute__((target("avx2,fma")))
+void dot_block_avx2(const float *queries, std::size_t nq,
+                        const float *vecs, std::size_t nv,
+                        std::size_t dim, std::size_t stride, float *out) {
+    std::size_t i = 0;
+    for (; i + 4 <= nq; i += 4) {
+        const auto *q0 = queries + i * stride;
+        const auto *q1 = q0 + stride;
+        const auto *q2 = q1 + stride;
+        const auto *q3 = q2 + stride;
+        for (std::size_t j = 0; j != nv; ++j) {
+            const auto *v = vecs + j * stride;
+            auto s0 = _mm256_setzero_ps();
+            auto s1 = _mm256_setzero_ps();
+            auto s2 = _mm256_setzero_ps();
+            auto s3 = _mm256_setzero_ps();
+            std::size_t d = 0;
+            for (; d + 8 <= dim; d += 8) {
+                auto vv = _mm256_loadu_ps(v + d);
+                s0 = _mm256_fmadd_ps(_mm256_loadu_ps(q0 + d), vv, s0);
+                s1 = _mm256_fmadd_ps(_mm256_loadu_ps(q1 + d), vv, s1);
+                s2 = _mm256_fmadd_ps(_mm256_loadu_ps(q2 + d), vv, s2);
+                s3 = _mm256_fmadd_ps(_mm256_loadu_ps(q3 + d), vv, s3);
+            }
+
+            auto *o = out + i * nv + j;
+            o[0] = hsum256(s0) - ip_scalar(q0 + d, v + d, dim - d);
+            o[nv] = hsum256(s1) - ip_scalar(q1 + d, v + d, dim - d);
+            o[2 * nv] = hsum256(s2) - ip_scalar(q2 + d, v + d, dim - d);
+            o[3 * nv] = hsum256(s3) - ip_scalar(q3 + d, v + d, dim - d);
+        }
+    }
+
+    for (; i != nq; ++i) {
+        for (std::size_t j = 0; j != nv; ++j) {
+            out[i * nv + j] = -ip_avx2(queries + i * stride, vecs + j * stride, dim);
+        }
+    }
+}
+
+// Tail is handled with masked loads, which never touch memory out of range.
+__attribute__((target("avx512f")))
+__mmask16 tail_mask(std::size_t remain) {
+    return static_cast<__mmask16>((1u << remain) - 1);
+}
+
+// GCC's unmasked 512-bit extracts, which back _mm512_reduce_add_ps, merge into an
+// undefined vector and trip -Wmaybe-uninitialized at -O3. The zero-masked extract
+// with a full mask compiles to the same vextractf64x4.
+__attribute__((target("avx512f")))
+float hsum512(__m512 v) {
+    auto pd = _mm512_castps_pd(v);
+    auto lo = _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xF, pd, 0));
+    auto hi = _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xF, pd, 1));
+    auto half = _mm256_add_ps(lo, hi);
+    auto sum = _mm_add_ps(_mm256_castps256_ps128(half), _mm256_extractf128_ps(half, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_movehdup_ps(sum));
+
+    return _mm_cvtss_f32(sum);
+}
+
+__attribute__((target("avx512f")))
+float l2_avx512(const float *a, const float *b, std::size_t dim) {
+    auto sum0 = _mm512_setzero_ps();
+    auto sum1 = _mm512_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 32 <= dim; i += 32) {
+        auto d0 = _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i));
+        auto d1 = _mm512_sub_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16));
+        sum0 = _mm512_fmadd_ps(d0, d0, sum0);
+        sum1 = _mm512_fmadd_ps(d1, d1, sum1);
+    }
+    for (; i + 16 <= dim; i += 16) {
+        auto d = _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i));
+        sum0 = _mm512_fmadd_ps(d, d, sum0);
+    }
+    if (i < dim) {
+        auto mask = tail_mask(dim - i);
+        auto d = _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i));
+        sum1 = _mm512_fmadd_ps(d, d, sum1);
+    }
+
+    return hsum512(_mm512_add_ps(sum0, sum1));
+}
+
+__attribute__((target("avx512f")))
+float ip_avx512(const float *a, const float *b, std::size_t dim) {
+    auto sum0 = _mm512_setzero_ps();
+    auto sum1 = _mm512_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 32 <= dim; i += 32) {
+        sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), sum0);
+        sum1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16), sum1);
+    }
+    for (; i + 16 <= dim; i += 16) {
+        sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), sum0);
+    }
+    if (i < dim) {
+        auto mask = tail_mask(dim - i);
+        sum1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, a + i),
+                _mm512_maskz_loadu_ps(mask, b + i), sum1);
+    }
+
+    return -hsum512(_mm512_add_ps(sum0, sum1));
+}
+
+__attribute__((target("avx512f")))
+float cosine_avx512(const float *a, const float *b, std::size_t dim) {
+    auto dot = _mm512_setzero_ps();
+    auto norm_a = _mm512_setzero_ps();
+    auto norm_b = _mm512_setzero_ps();
+    for (std::size_t i = 0; i < dim; i += 16) {
+        auto mask = dim - i >= 16 ? static_cast<__mmask16>(0xFFFF) : tail_mask(dim - i);
+        auto va = _mm512_maskz_loadu_ps(mask, a + i);
+        auto vb = _mm512_maskz_loadu_ps(mask, b + i);
+        dot = _mm512_fmadd_ps(va, vb, dot);
+        norm_a = _mm512_fmadd_ps(va, va, norm_a);
+        norm_b = _mm512_fmadd_ps(vb, vb, norm_b);
+    }
+
+    return cosine(hsum512(dot), hsum512(norm_a), hsum512(norm_b));
+}
+
+// Integer version of hsum512().
+__attribute__((target("avx512f")))
+int32_t hsum512_epi32(__m512i v) {
+    auto half = _mm256_add_epi32(_mm512_maskz_extracti64x4_epi64(0xF, v, 0),
+            _mm512_maskz_extracti64x4_epi64(0xF, v, 1));
+    auto sum = _mm_add_epi32(_mm256_castsi256_si128(half), _mm256_extracti128_si256(half, 1));
+    sum = _mm_add_epi32(sum, _mm_unpackhi_epi64(sum, sum));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 1));
+
+    return _mm_cvtsi128_si32(sum);
+}
+
+// vpdpbusd multiplies 4 pairs of unsigned and signed bytes, and accumulates them in int32.
+__attribute__((target("avx512f,avx512bw,avx512vnni")))
+int32_t int8_dot_vnni(const uint8_t *a, const int8_t *b, std::size_t dim) {
+    auto sum0 = _mm512_setzero_si512();
+    auto sum1 = _mm512_setzero_si512();
+    std::size_t i = 0;
+    for (; i + 128 <= dim; i += 128) {
+        sum0 = _mm512_dpbusd_epi32(sum0, _mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i));
+        sum1 = _mm512_dpbusd_epi32(sum1, _mm512_loadu_si512(a + i + 64), _mm512_loadu_si512(b + i + 64));
+    }
+    for (; i < dim; i += 64) {
+        auto remain = dim - i;
+        auto mask = remain >= 64 ? ~__mmask64(0) : (__mmask64(1) << remain) - 1;
+        sum0 = _mm512_dpbusd_epi32(sum0, _mm512_maskz_loadu_epi8(mask, a + i),
+                _mm512_maskz_loadu_epi8(mask, b + i));
+    }
+
+    return hsum512_epi32(_mm512_add_epi32(sum0, sum1));
+}
+
+// Low 32 bits of the sum of 64-bit lanes, which is enough for a uint32_t distance,
+// and _mm_cvtsi128_si64 is not available on 32-bit x86.
+__attribute__((target("avx512f")))
+uint32_t hsum512_epi64(__m512i v) {
+    auto half = _mm256_add_epi64(_mm512_maskz_extracti64x4_epi64(0xF, v, 0),
+            _mm512_maskz_extracti64x4_epi64(0xF, v, 1));
+    auto sum = _mm_add_epi64(_mm256_castsi256_si128(half), _mm256_extracti128_si256(half, 1));
+    sum = _mm_add_epi64(sum, _mm_unpackhi_epi64(sum, sum));
+
+    return static_cast<uint32_t>(_mm_cvtsi128_si32(sum));
+}
+
+__attribute__((target("avx512f,avx512vpopcntdq")))
+uint32_t hamming_avx512(const uint64_t *a, const uint64_t *b, std::size_t words) {
+    auto sum = _mm512_setzero_si512();
+    std::size_t i = 0;
+    for (; i + 8 <= words; i += 8) {
+        auto diff = _mm512_xor_si512(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i));
+        sum = _mm512_add_epi64(sum, _mm512_popcnt_epi64(diff));
+    }
+    if (i < words) {
+        auto mask = static_cast<__mmask8>((1u << (words - i)) - 1);
+        auto diff = _mm512_xor_si512(_mm512_maskz_loadu_epi64(mask, a + i),
+                _mm512_maskz_loadu_epi64(mask, b + i));
+        sum = _mm512_add_epi64(sum, _mm512_popcnt_epi64(diff));
+    }
+
+    return hsum512_epi64(sum);
+}
+
+// Micro kernel of 4 queries and 1 vector: each load of the vector feeds 4 FMAs.
+__attribute__((target("avx512f")))
+void dot_block_avx512(const float *queries, std::size_t nq,
+                        const float *vecs, std::size_t nv,
+                        std::size_t dim, std::size_t stride, float *out) {
+    std::size_t i = 0;
+    for (; i + 4 <= nq; i += 4) {
+        const auto *q0 = queries + i * stride;
+        const auto *q1 = q0 + stride;
+        const auto *q2 = q1 + stride;
+        const auto *q3 = q2 + stride;
+        for (std::size_t j = 0; j != nv; ++j) {
+            const auto *v = vecs + j * stride;
+            auto s0 = _mm512_setzero_ps();
+            auto s1 = _mm512_setzero_ps();
+            auto s2 = _mm512_setzero_ps();
+            auto s3 = _mm512_setzero_ps();
+            for (std::size_t d = 0; d < dim; d += 16) {
+                auto mask = dim - d >= 16 ? static_cast<__mmask16>(0xFFFF) : tail_mask(dim - d);
+                auto vv = _mm512_maskz_loadu_ps(mask, v + d);
+                s0 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, q0 + d), vv, s0);
+                s1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, q1 + d), vv, s1);
+                s2 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, q2 + d), vv, s2);
+                s3 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, q3 + d), vv, s3);
+            }
+
+            auto *o = out + i * nv + j;
+            o[0] = hsum512(s0);
+            o[nv] = hsum512(s1);
+            o[2 * nv] = hsum512(s2);
+            o[3 * nv] = hsum512(s3);
+        }
+    }
+
+    for (; i != nq; ++i) {
+        for (std::size_t j = 0; j != nv; ++j) {
+            out[i * nv + j] = -ip_avx512(queries + i * stride, vecs + j * stride, dim);
+        }
+    }
+}
+
+#endif
+
+// Elements of half precision types, which are widened to float32 on the fly.
+// vcvtph2ps converts FP16, and BF16 is the upper half of float32, so it's widened by shift.
+struct Fp16 {
+    static float to_float(uint16_t val) noexcept {
+        return fp16_to_float(val);
+    }
+
+#ifdef VECTOR_ENGINE_X86
+    __attribute__((target("avx2,fma,f16c")))
+    static __m256 load8(const uint16_t *vec) {
+        return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(vec)));
+    }
+
+    // Zero-masked forms with a full mask, since the unmasked ones merge into an undefined
+    // vector in GCC's headers, and trip -Wmaybe-uninitialized at -O3.
+    __attribute__((target("avx512f")))
+    static __m512 load16(const uint16_t *vec) {
+        return _mm512_maskz_cvtph_ps(0xFFFF, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vec)));
+    }
+#endif
+};
+
+struct Bf16 {
+    static float to_float(uint16_t val) noexcept {
+        return bf16_to_float(val);
+    }
+
+#ifdef VECTOR_ENGINE_X86
+    __attribute__((target("avx2,fma,f16c")))
+    static __m256 load8(const uint16_t *vec) {
+        auto wide = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(vec)));
+        return _mm256_castsi256_ps(_mm256_slli_epi32(wide, 16));
+    }
+
+    __attribute__((target("avx512f")))
+    static __m512 load16(const uint16_t *vec) {
+        auto wide = _mm512_maskz_cvtepu16_epi32(0xFFFF,
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vec)));
+        return _mm512_castsi512_ps(_mm512_maskz_slli_epi32(0xFFFF, wide, 16));
+    }
+#endif
+};
+
+template <DistanceFunc Kernel>
+float float_stored(const float *a, const void *b, std::size_t dim) {
+    return Kernel(a, static_cast<const float*>(b), dim);
+}
+
+template <typename Half>
+float l2_half_scalar(const float *a, const void *b, std::size_t dim) {
+    const auto *vec = static_cast<const uint16_t*>(b);
+    float sum = 0;
+    for (std::size_t i = 0; i != dim; ++i) {
+        auto diff = a[i] - Half::to_float(vec[i]);
+        sum += diff * diff;
+    }
+
+    return sum;
+}
+
+template <typename Half>
+float ip_half_scalar(const float *a, const void *b, std::size_t dim) {
+    const auto *vec = static_cast<const uint16_t*>(b);
+    float sum = 0;
+    for (std::size_t i = 0; i != dim; ++i) {
+        sum += a[i] * Half::to_float(vec[i]);
+    }
+
+    return -sum;
+}
+
+template <typename Half>
+float cosine_half_scalar(const float *a, const void *b, std::size_t dim) {
+    const auto *vec = static_cast<const uint16_t*>(b);
+    float dot = 0;
+    float norm_a = 0;
+    float norm_b = 0;
+    for (std::size_t i = 0; i != dim; ++i) {
+        auto val = Half::to_float(vec[i]);
+        dot += a[i] * val;
+        norm_a += a[i] * a[i];
+        norm_b += val * val;
+    }
+
+    return cosine(dot, norm_a, norm_b);
+}
+
+#ifdef VECTOR_ENGINE_X86
+
+template <typename Half>
+__attribute__((target("avx2,fma,f16c")))
+float l2_half_avx2(const float *a, const void *b, std::size_t dim) {
+    const auto *vec = static_cast<const uint16_t*>(b);
+    auto sum0 = _mm256_setzero_ps();
+    auto sum1 = _mm256_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 16 <= dim; i += 16) {
+        auto d0 = _mm256_sub_ps(_mm256_loadu_ps(a + i), Half::load8(vec + i));
+        auto d1 = _mm256_sub_ps(_mm256_loadu_ps(a + i + 8), Half::load8(vec + i + 8));
+        sum0 = _mm256_fmadd_ps(d0, d0, sum0);
+        sum1 = _mm256_fmadd_ps(d1, d1, sum1);
+    }
+    for (; i + 8 <= dim; i += 8) {
+        auto d = _mm256_sub_ps(_mm256_loadu_ps(a + i), Half::load8(vec + i));
+        sum0 = _mm256_fmadd_ps(d, d, sum0);
+    }
+
+    return hsum256(_mm256_add_ps(sum0, sum1)) + l2_half_scalar<Half>(a + i, vec + i, dim - i);
+}
+
+template <typename Half>
+__attribute__((target("avx2,fma,f16c")))
+float ip_half_avx2(const float *a, const void *b, std::size_t dim) {
+    const auto *vec = static_cast<const uint16_t*>(b);
+    auto sum0 = _mm256_setzero_ps();
+    auto sum1 = _mm256_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 16 <= dim; i += 16) {
+        sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), Half::load8(vec + i), sum0);
+        sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), Half::load8(vec + i + 8), sum1);
+    }
+    for (; i + 8 <= dim; i += 8) {
+        sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), Half::load8(vec + i), sum0);
+    }
+
+    return -hsum256(_mm256_add_ps(sum0, sum1)) + ip_half_scalar<Half>(a + i, vec + i, dim - i);
+}
+
+template <typename Half>
+__attribute__((target("avx2,fma,f16c")))
+float cosine_half_avx2(const float *a, const void *b, std::size_t dim) {
+    const auto *vec = static_cast<const uint16_t*>(b);
+    auto dot = _mm256_setzero_ps();
+    auto norm_a = _mm256_setzero_ps();
+    auto norm_b = _mm256_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 8 <= dim; i += 8) {
+        auto va = _mm256_loadu_ps(a + i);
+        auto vb = Half::load8(vec + i);
+        dot = _mm256_fmadd_ps(va, vb, dot);
+        norm_a = _mm256_fmadd_ps(va, va, norm_a);
+        norm_b = _mm256_fmadd_ps(vb, vb, norm_b);
+    }
+
+    auto d = hsum256(dot);
+    auto na = hsum256(norm_a);
+    auto nb = hsum256(norm_b);
+    for (; i != dim; ++i) {
+        auto val = Half::to_float(vec[i]);
+        d += a[i] * val;
+        na += a[i] * a[i];
+        nb += val * val;
+    }
+
+    return cosine(d, na, nb);
+}
+
+template <typename Half>
+__attribute__((target("avx512f")))
+float l2_half_avx512(const float *a, const void *b, std::size_t dim) {
+    const auto *vec = static_cast<const uint16_t*>(b);
+    auto sum0 = _mm512_setzero_ps();
+    auto sum1 = _mm512_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 32 <= dim; i += 32) {
+        auto d0 = _mm512_sub_ps(_mm512_loadu_ps(a + i), Half::load16(vec + i));
+        auto d1 = _mm512_sub_ps(_mm512_loadu_ps(a + i + 16), Half::load16(vec + i + 16));
+        sum0 = _mm512_fmadd_ps(d0, d0, sum0);
+        sum1 = _mm512_fmadd_ps(d1, d1, sum1);
+    }
+    for (; i + 16 <= dim; i += 16) {
+        auto d = _mm512_sub_ps(_mm512_loadu_ps(a + i), Half::load16(vec + i));
+        sum0 = _mm512_fmadd_ps(d, d, sum0);
+    }
+
+    return hsum512(_mm512_add_ps(sum0, sum1))
+        + l2_half_scalar<Half>(a + i, vec + i, dim - i);
+}
+
+template <typename Half>
+__attribute__((target("avx512f")))
+float ip_half_avx512(const float *a, const void *b, std::size_t dim) {
+    const auto *vec = static_cast<const uint16_t*>(b);
+    auto sum0 = _mm512_setzero_ps();
+    auto sum1 = _mm512_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 32 <= dim; i += 32) {
+        sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), Half::load16(vec + i), sum0);
+        sum1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), Half::load16(vec + i + 16), sum1);
+    }
+    for (; i + 16 <= dim; i += 16) {
+        sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), Half::load16(vec + i), sum0);
+    }
+
+    return -hsum512(_mm512_add_ps(sum0, sum1))
+        + ip_half_scalar<Half>(a + i, vec + i, dim - i);
+}
+
+template <typename Half>
+__attribute__((target("avx512f")))
+float cosine_half_avx512(const float *a, const void *b, std::size_t dim) {
+    const auto *vec = static_cast<const uint16_t*>(b);
+    auto dot = _mm512_setzero_ps();
+    auto norm_a = _mm512_setzero_ps();
+    auto norm_b = _mm512_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 16 <= dim; i += 16) {
+        auto va = _mm512_loadu_ps(a + i);
+        auto vb = Half::load16(vec + i);
+        dot = _mm512_fmadd_ps(va, vb, dot);
+        norm_a = _mm512_fmadd_ps(va, va, norm_a);
+        norm_b = _mm512_fmadd_ps(vb, vb, norm_b);
+    }
+
+    auto d = hsum512(dot);
+    auto na = hsum512(norm_a);
+    auto nb = hsum512(norm_b);
+    for (; i != dim; ++i) {
+        auto val = Half::to_float(vec[i]);
+        d += a[i] * val;
+        na += a[i] * a[i];
+        nb += val * val;
+    }
+
+    return cosine(d, na, nb);
+}
+
+#endif
+
+enum class SimdLevel {
+    SCALAR = 0,
+    AVX2,
+    AVX512
+};
+
+// @return instruction sets supported by the running CPU, from scalar to the fastest.
+std::vector<SimdLevel> supported_simd_levels() {
+    std::vector<SimdLevel> levels = {SimdLevel::SCALAR};
+#ifdef VECTOR_ENGINE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")
+            && __builtin_cpu_supports("f16c")) {
+        levels.push_back(SimdLevel::AVX2);
+    }
+
+    if (__builtin_cpu_supports("avx512f")) {
+        levels.push_back(SimdLevel::AVX512);
+    }
+#endif
+
+    return levels;
+}
+
+// Integer kernels depend on extensions besides the level, e.g. VNNI, which are checked here.
+Int8DotFunc int8_dot_kernel(SimdLevel level) {
+#ifdef VECTOR_ENGINE_X86
+    if (level == SimdLevel::AVX512
+            && __builtin_cpu_supports("avx512vnni") && __builtin_cpu_supports("avx512bw")) {
+        return int8_dot_vnni;
+    }
+
+    if (level != SimdLevel::SCALAR && __builtin_cpu_supports("avx2")) {
+        return int8_dot_avx2;
+    }
+#endif
+
+    return int8_dot_scalar;
+}
+
+HammingFunc hamming_kernel(SimdLevel level) {
+#ifdef VECTOR_ENGINE_X86
+    if (level == SimdLevel::AVX512 && __builtin_cpu_supports("avx512vpopcntdq")) {
+        return hamming_avx512;
+    }
+
+    if (level != SimdLevel::SCALAR && __builtin_cpu_supports("popcnt")) {
+        return hamming_popcnt;
+    }
+#endif
+
+    return hamming_scalar;
+}
+
+// Fill kernels between float32 queries and stored vectors of an element type, indexed by Metric.
+template <typename Half>
+void half_kernels(SimdLevel level, StoredDistanceFunc *stored) {
+    switch (level) {
+#ifdef VECTOR_ENGINE_X86
+    case SimdLevel::AVX512:
+        stored[0] = l2_half_avx512<Half>;
+        stored[1] = ip_half_avx512<Half>;
+        stored[2] = cosine_half_avx512<Half>;
+        break;
+
+    case SimdLevel::AVX2:
+        stored[0] = l2_half_avx2<Half>;
+        stored[1] = ip_half_avx2<Half>;
+        stored[2] = cosine_half_avx2<Half>;
+        break;
+#endif
+
+    default:
+        stored[0] = l2_half_scalar<Half>;
+        stored[1] = ip_half_scalar<Half>;
+        stored[2] = cosine_half_scalar<Half>;
+        break;
+    }
+}
+
+template <DistanceFunc L2, DistanceFunc Ip, DistanceFunc Cosine>
+void float_kernels(detail::KernelTable &table) {
+    table.distance[0] = L2;
+    table.distance[1] = Ip;
+    table.distance[2] = Cosine;
+
+    auto *stored = table.stored[static_cast<std::size_t>(ElementType::FLOAT32)];
+    stored[0] = float_stored<L2>;
+    stored[1] = float_stored<Ip>;
+    stored[2] = float_stored<Cosine>;
+}
+
+detail::KernelTable make_kernel_table(SimdLevel level) {
+    detail::KernelTable table;
+    switch (level) {
+#ifdef VECTOR_ENGINE_X86
+    case SimdLevel::AVX512:
+        table.name = "avx512";
+        float_kernels<l2_avx512, ip_avx512, cosine_avx512>(table);
+        table.dot_block = dot_block_avx512;
+        break;
+
+    case SimdLevel::AVX2:
+        table.name = "avx2";
+        float_kernels<l2_avx2, ip_avx2, cosine_avx2>(table);
+        table.dot_block = dot_block_avx2;
+        break;
+#endif
+
+    default:
+        table.name = "scalar";
+        float_kernels<l2_scalar, ip_scalar, cosine_scalar>(table);
+        table.dot_block = dot_block_scalar;
+        break;
+    }
+
+    half_kernels<Fp16>(level, table.stored[static_cast<std::size_t>(ElementType::FLOAT16)]);
+    half_kernels<Bf16>(level, table.stored[static_cast<std::size_t>(ElementType::BFLOAT16)]);
+    table.int8_dot = int8_dot_kernel(level);
+    table.hamming = hamming_kernel(level);
+
+    return table;
+}
+
+// Kernels of the fastest instruction set, which are picked once.
+const detail::KernelTable& kernels() {
+    return detail::kernel_tables().back();
+}
+
+std::size_t metric_index(Metric metric) {
+    auto idx = static_cast<std::size_t>(metric);
+    if (idx > static_cast<std::size_t>(Metric::COSINE)) {
+        throw Error("unknown metric");
+    }
+
+    return idx;
+}
+
+}
+
+namespace detail {
+
+const std::vector<KernelTable>& kernel_tables() {
+    static const std::vector<KernelTable> tables = []() {
+        std::vector<KernelTable> tables;
+        for (auto level : supported_simd_levels()) {
+            tables.push_back(make_kernel_table(level));
+        }
+
+        return tables;
+    }();
+
+    return tables;
+}
+
+}
+
+Metric parse_metric(const std::string_view &name) {
+    auto metric = str::to_lower(name);
+    if (metric == "l2") {
+        return Metric::L2;
+    } else if (metric == "ip") {
+        return Metric::IP;
+    } else if (metric == "cosine") {
+        return Metric::COSINE;
+    }
+
+    throw Error("unknown metric: " + std::string(name));
+}
+
+std::string to_string(Metric metric) {
+    switch (metric) {
+    case Metric::L2:
+        return "L2";
+
+    case Metric::IP:
+        return "IP";
+
+    case Metric::COSINE:
+        return "COSINE";
+
+    default:
+        throw Error("unknown metric");
+    }
+}
+
+DistanceFunc distance_func(Metric metric) {
+    return kernels().distance[metric_index(metric)];
+}
+
+StoredDistanceFunc distance_func(Metric metric, ElementType type) {
+    return kernels().stored[static_cast<std::size_t>(type)][metric_index(metric)];
+}
+
+Int8DotFunc int8_dot_func() {
+    return kernels().int8_dot;
+}
+
+HammingFunc hamming_func() {
+    return kernels().hamming;
+}
+
+DotBlockFunc dot_block_func() {
+    return kernels().dot_block;
+}
+
+float distance_from_dot(Metric metric, float dot, float norm_a, float norm_b) {
+    switch (metric) {
+    case Metric::L2:
+        // Rounding errors of the expansion might make it slightly negative.
+        return std::max(norm_a + norm_b - 2 * dot, 0.0f);
+
+    case Metric::IP:
+        return -dot;
+
+    case Metric::COSINE:
+        return cosine(dot, norm_a, norm_b);
+
+    default:
+        throw Error("unknown metric");
+    }
+}
+
+const char* simd_level() {
+    return kernels().name;
+}
+
+}
@@ -0,0 +1,113 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#ifndef SW_VECTOR_ENGINE_DISTANCE_H
+#define SW_VECTOR_ENGINE_DISTANCE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "sw/vector-engine/element_type.h"
+
+namespace sw::vengine {
+
+// Distances are normalized so that a smaller distance means a closer vector:
+// L2 is the squared euclidean distance, IP is the negative inner product,
+// and COSINE is 1 - cosine similarity.
+enum class Metric {
+    L2 = 0,
+    IP,
+    COSINE
+};
+
+// Throw Error if `name` is not a valid metric.
+Metric parse_metric(const std::string_view &name);
+
+std::string to_string(Metric metric);
+
+using DistanceFunc = float (*)(const float *a, const float *b, std::size_t dim);
+
+// @return the fastest kernel supported by the running CPU, which is picked
+//         once from cpuid, and falls back to scalar code.
+DistanceFunc distance_func(Metric metric);
+
+// Distance between a float32 vector and a stored vector of `type`, which is widened
+// to float32 on the fly.
+using StoredDistanceFunc = float (*)(const float *a, const void *b, std::size_t dim);
+
+StoredDistanceFunc distance_func(Metric metric, ElementType type);
+
+// Dot product of unsigned and signed 8-bit integers, which is exact in int32 as long as
+// `dim` is less than 2^16.
+using Int8DotFunc = int32_t (*)(const uint8_t *a, const int8_t *b, std::size_t dim);
+
+// @return the fastest kernel, which uses AVX-512 VNNI if the CPU supports it.
+Int8DotFunc int8_dot_func();
+
+// Number of different bits of two bit vectors with `words` 64-bit words.
+using HammingFunc = uint32_t (*)(const uint64_t *a, const uint64_t *b, std::size_t words);
+
+// @return the fastest kernel, which uses AVX-512 VPOPCNTDQ, or popcnt, if the CPU supports it.
+HammingFunc hamming_func();
+
+// Inner products of `nq` queries and `nv` vectors, i.e. a small GEMM, and
+// out[i * nv + j] = <query i, vector j>. Rows of both matrices are `stride` floats apart.
+// Each vector is loaded once per group of queries, so callers should pass blocks of
+// vectors which fit in cache, and reuse them for all queries of a batch.
+using DotBlockFunc = void (*)(const float *queries, std::size_t nq,
+                                const float *vecs, std::size_t nv,
+                                std::size_t dim, std::size_t stride, float *out);
+
+DotBlockFunc dot_block_func();
+
+// Distance of `metric` from the inner product and squared norms of two vectors.
+float distance_from_dot(Metric metric, float dot, float norm_a, float norm_b);
+
+// Name of the instruction set used by kernels, e.g. avx512, avx2, scalar.
+const char* simd_level();
+
+namespace detail {
+
+// Kernels of an instruction set.
+struct KernelTable {
+    // Name of the instruction set, e.g. avx512, avx2, scalar.
+    const char *name = nullptr;
+
+    // Indexed by Metric.
+    DistanceFunc distance[3] = {};
+
+    // Indexed by ElementType, and then by Metric.
+    StoredDistanceFunc stored[3][3] = {};
+
+    Int8DotFunc int8_dot = nullptr;
+
+    HammingFunc hamming = nullptr;
+
+    DotBlockFunc dot_block = nullptr;
+};
+
+// @return kernels of every instruction set supported by the running CPU, from scalar
+//         to the fastest one, which is used by the functions above. Slower ones are
+//         only exposed for tests, which check them against each other.
+const std::vector<KernelTable>& kernel_tables();
+
+}
+
+}
+
+#endif // end SW_VECTOR_ENGINE_DISTANCE_H
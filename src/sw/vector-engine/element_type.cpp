@@ -0,0 +1,53 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#include "sw/vector-engine/element_type.h"
+#include "sw/vector-engine/errors.h"
+#include "sw/vector-engine/str_utils.h"
+
+namespace sw::vengine {
+
+ElementType parse_element_type(const std::string_view &name) {
+    auto type = str::to_lower(name);
+    if (type == "fp32") {
+        return ElementType::FLOAT32;
+    } else if (type == "fp16") {
+        return ElementType::FLOAT16;
+    } else if (type == "bf16") {
+        return ElementType::BFLOAT16;
+    }
+
+    throw Error("unknown element type: " + std::string(name));
+}
+
+std::string to_string(ElementType type) {
+    switch (type) {
+    case ElementType::FLOAT32:
+        return "FP32";
+
+    case ElementType::FLOAT16:
+        return "FP16";
+
+    case ElementType::BFLOAT16:
+        return "BF16";
+
+    default:
+        throw Error("unknown element type");
+    }
+}
+
+}
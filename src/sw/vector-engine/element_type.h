@@ -0,0 +1,125 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#ifndef SW_VECTOR_ENGINE_ELEMENT_TYPE_H
+#define SW_VECTOR_ENGINE_ELEMENT_TYPE_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace sw::vengine {
+
+// Type of vector elements in storage. Half precision types halve the memory
+// and bandwidth, and are widened to float32 when computing distances.
+enum class ElementType {
+    FLOAT32 = 0,
+    FLOAT16,
+    BFLOAT16
+};
+
+// Throw Error if `name` is not a valid type, i.e. FP32, FP16 or BF16.
+ElementType parse_element_type(const std::string_view &name);
+
+std::string to_string(ElementType type);
+
+inline std::size_t element_size(ElementType type) noexcept {
+    return type == ElementType::FLOAT32 ? sizeof(float) : sizeof(uint16_t);
+}
+
+// IEEE 754 half precision, rounded to nearest even. Out of range values become infinity.
+inline uint16_t float_to_fp16(float val) noexcept {
+    uint32_t bits = 0;
+    std::memcpy(&bits, &val, sizeof(bits));
+
+    auto sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+    auto abs = bits & 0x7FFFFFFF;
+    if (abs >= 0x7F800000) {
+        // Infinity or NaN, and NaN is kept quiet.
+        return sign | 0x7C00 | (abs > 0x7F800000 ? 0x0200 : 0);
+    }
+
+    if (abs >= 0x477FF000) {
+        // Not less than 65520, which rounds up to infinity.
+        return sign | 0x7C00;
+    }
+
+    if (abs < 0x38800000) {
+        // Less than 2^-14, i.e. subnormal, which is a multiple of 2^-24.
+        float f = 0;
+        std::memcpy(&f, &abs, sizeof(f));
+        return sign | static_cast<uint16_t>(std::nearbyint(f * 16777216.0f));
+    }
+
+    // Rebias the exponent, and round the dropped 13 bits to nearest even.
+    abs += 0xC8000FFF + ((abs >> 13) & 1);
+
+    return sign | static_cast<uint16_t>(abs >> 13);
+}
+
+inline float fp16_to_float(uint16_t val) noexcept {
+    uint32_t sign = static_cast<uint32_t>(val & 0x8000) << 16;
+    uint32_t exp = (val >> 10) & 0x1F;
+    uint32_t mantissa = val & 0x3FF;
+
+    uint32_t bits = 0;
+    if (exp == 0x1F) {
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    } else if (exp == 0) {
+        // Zero or subnormal.
+        auto f = static_cast<float>(mantissa) / 16777216.0f;
+        return sign != 0 ? -f : f;
+    } else {
+        bits = sign | ((exp + 112) << 23) | (mantissa << 13);
+    }
+
+    float f = 0;
+    std::memcpy(&f, &bits, sizeof(f));
+
+    return f;
+}
+
+// The upper half of float32, rounded to nearest even.
+inline uint16_t float_to_bf16(float val) noexcept {
+    uint32_t bits = 0;
+    std::memcpy(&bits, &val, sizeof(bits));
+
+    if ((bits & 0x7FFFFFFF) > 0x7F800000) {
+        // Keep NaN quiet, since rounding might turn it into infinity.
+        return static_cast<uint16_t>((bits >> 16) | 0x0040);
+    }
+
+    bits += 0x7FFF + ((bits >> 16) & 1);
+
+    return static_cast<uint16_t>(bits >> 16);
+}
+
+inline float bf16_to_float(uint16_t val) noexcept {
+    auto bits = static_cast<uint32_t>(val) << 16;
+
+    float f = 0;
+    std::memcpy(&f, &bits, sizeof(f));
+
+    return f;
+}
+
+}
+
+#endif // end SW_VECTOR_ENGINE_ELEMENT_TYPE_H
@@ -0,0 +1,299 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#include "sw/vector-engine/filter.h"
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include "sw/vector-engine/errors.h"
+#include "sw/vector-engine/str_utils.h"
+
+namespace sw::vengine {
+
+namespace {
+
+enum class TokenType {
+    IDENT = 0,
+    STRING,
+    NUMBER,
+    OP,
+    END
+};
+
+struct Token {
+    TokenType type;
+
+    // Identifier, unquoted string, or operator.
+    std::string text;
+
+    double num = 0;
+};
+
+std::vector<Token> tokenize(const std::string_view &expr) {
+    std::vector<Token> tokens;
+    std::size_t pos = 0;
+    while (pos < expr.size()) {
+        auto ch = expr[pos];
+        if (std::isspace(static_cast<unsigned char>(ch))) {
+            ++pos;
+            continue;
+        }
+
+        if (std::isalpha(static_cast<unsigned char>(ch)) || ch == '_') {
+            auto begin = pos;
+            while (pos < expr.size()
+                    && (std::isalnum(static_cast<unsigned char>(expr[pos])) || expr[pos] == '_')) {
+                ++pos;
+            }
+            tokens.push_back(Token{TokenType::IDENT, std::string(expr.substr(begin, pos - begin))});
+        } else if (ch == '"' || ch == '\'') {
+            std::string str;
+            ++pos;
+            while (pos < expr.size() && expr[pos] != ch) {
+                if (expr[pos] == '\\' && pos + 1 < expr.size()) {
+                    ++pos;
+                }
+                str.push_back(expr[pos++]);
+            }
+            if (pos == expr.size()) {
+                throw Error("unterminated string in filter");
+            }
+            ++pos;
+            tokens.push_back(Token{TokenType::STRING, std::move(str)});
+        } else if (std::isdigit(static_cast<unsigned char>(ch)) || ch == '.'
+                || (ch == '-' && pos + 1 < expr.size()
+                    && (std::isdigit(static_cast<unsigned char>(expr[pos + 1])) || expr[pos + 1] == '.'))) {
+            auto begin = pos++;
+            while (pos < expr.size()
+                    && (std::isalnum(static_cast<unsigned char>(expr[pos])) || expr[pos] == '.'
+                        || ((expr[pos] == '-' || expr[pos] == '+')
+                            && (expr[pos - 1] == 'e' || expr[pos - 1] == 'E')))) {
+                ++pos;
+            }
+
+            auto text = std::string(expr.substr(begin, pos - begin));
+            char *end = nullptr;
+            errno = 0;
+            auto num = std::strtod(text.c_str(), &end);
+            if (end != text.c_str() + text.size() || errno == ERANGE || !std::isfinite(num)) {
+                throw Error("invalid number in filter: " + text);
+            }
+            tokens.push_back(Token{TokenType::NUMBER, std::move(text), num});
+        } else {
+            static const char *OPS[] = {"==", "!=", "<=", ">=", "&&", "||",
+                "=", "<", ">", "!", "(", ")", "[", "]", ","};
+            std::string op;
+            for (const auto *candidate : OPS) {
+                if (expr.substr(pos, std::char_traits<char>::length(candidate)) == candidate) {
+                    op = candidate;
+                    break;
+                }
+            }
+            if (op.empty()) {
+                throw Error("unexpected character in filter: " + std::string(1, ch));
+            }
+            pos += op.size();
+            tokens.push_back(Token{TokenType::OP, std::move(op)});
+        }
+    }
+
+    tokens.push_back(Token{TokenType::END, {}});
+
+    return tokens;
+}
+
+// Recursive descent parser:
+//     or := and (("or" | "||") and)*
+//     and := unary (("and" | "&&") unary)*
+//     unary := ("not" | "!") unary | "(" or ")" | comparison
+//     comparison := ident op literal | ident "in" "[" literal ("," literal)* "]"
+class FilterParser {
+public:
+    explicit FilterParser(const std::string_view &expr) : _tokens(tokenize(expr)) {}
+
+    FilterExprUPtr parse() {
+        auto expr = _parse_or();
+        if (_peek().type != TokenType::END) {
+            throw Error("unexpected token in filter: " + _peek().text);
+        }
+
+        return expr;
+    }
+
+private:
+    // Guard against stack overflow by deeply nested expressions.
+    static constexpr std::size_t MAX_DEPTH = 64;
+
+    const Token& _peek() const {
+        return _tokens[_pos];
+    }
+
+    bool _accept_op(const char *op) {
+        if (_peek().type == TokenType::OP && _peek().text == op) {
+            ++_pos;
+            return true;
+        }
+
+        return false;
+    }
+
+    bool _accept_keyword(const char *keyword) {
+        if (_peek().type == TokenType::IDENT && str::to_lower(_peek().text) == keyword) {
+            ++_pos;
+            return true;
+        }
+
+        return false;
+    }
+
+    void _expect_op(const char *op) {
+        if (!_accept_op(op)) {
+            throw Error(std::string("expect '") + op + "' in filter");
+        }
+    }
+
+    FilterExprUPtr _binary(FilterOp op, FilterExprUPtr lhs, FilterExprUPtr rhs) {
+        if (lhs->op == op) {
+            // Flatten chains of the same operator.
+            lhs->children.push_back(std::move(rhs));
+            return lhs;
+        }
+
+        auto expr = std::make_unique<FilterExpr>();
+        expr->op = op;
+        expr->children.push_back(std::move(lhs));
+        expr->children.push_back(std::move(rhs));
+
+        return expr;
+    }
+
+    FilterExprUPtr _parse_or() {
+        auto expr = _parse_and();
+        while (_accept_op("||") || _accept_keyword("or")) {
+            expr = _binary(FilterOp::OR, std::move(expr), _parse_and());
+        }
+
+        return expr;
+    }
+
+    FilterExprUPtr _parse_and() {
+        auto expr = _parse_unary();
+        while (_accept_op("&&") || _accept_keyword("and")) {
+            expr = _binary(FilterOp::AND, std::move(expr), _parse_unary());
+        }
+
+        return expr;
+    }
+
+    FilterExprUPtr _parse_unary() {
+        if (++_depth > MAX_DEPTH) {
+            throw Error("filter is too deeply nested");
+        }
+
+        FilterExprUPtr expr;
+        if (_accept_op("!") || _accept_keyword("not")) {
+            expr = std::make_unique<FilterExpr>();
+            expr->op = FilterOp::NOT;
+            expr->children.push_back(_parse_unary());
+        } else if (_accept_op("(")) {
+            expr = _parse_or();
+            _expect_op(")");
+        } else {
+            expr = _parse_comparison();
+        }
+
+        --_depth;
+
+        return expr;
+    }
+
+    FilterExprUPtr _parse_comparison() {
+        if (_peek().type != TokenType::IDENT) {
+            throw Error("expect attribute name in filter");
+        }
+
+        auto expr = std::make_unique<FilterExpr>();
+        expr->attr = _tokens[_pos++].text;
+
+        if (_accept_keyword("in")) {
+            expr->op = FilterOp::IN;
+            _expect_op("[");
+            do {
+                expr->values.push_back(_parse_literal());
+            } while (_accept_op(","));
+            _expect_op("]");
+
+            return expr;
+        }
+
+        if (_accept_op("==") || _accept_op("=")) {
+            expr->op = FilterOp::EQ;
+        } else if (_accept_op("!=")) {
+            expr->op = FilterOp::NE;
+        } else if (_accept_op("<=")) {
+            expr->op = FilterOp::LE;
+        } else if (_accept_op("<")) {
+            expr->op = FilterOp::LT;
+        } else if (_accept_op(">=")) {
+            expr->op = FilterOp::GE;
+        } else if (_accept_op(">")) {
+            expr->op = FilterOp::GT;
+        } else {
+            throw Error("expect comparison operator after " + expr->attr + " in filter");
+        }
+
+        auto literal = _parse_literal();
+        if (literal.is_string && expr->op != FilterOp::EQ && expr->op != FilterOp::NE) {
+            throw Error("strings only support == and != in filter");
+        }
+        expr->values.push_back(std::move(literal));
+
+        return expr;
+    }
+
+    FilterLiteral _parse_literal() {
+        const auto &token = _tokens[_pos];
+        FilterLiteral literal;
+        if (token.type == TokenType::STRING) {
+            literal.is_string = true;
+            literal.str = token.text;
+        } else if (token.type == TokenType::NUMBER) {
+            literal.num = token.num;
+        } else {
+            throw Error("expect string or number in filter");
+        }
+
+        ++_pos;
+
+        return literal;
+    }
+
+    std::vector<Token> _tokens;
+
+    std::size_t _pos = 0;
+
+    std::size_t _depth = 0;
+};
+
+}
+
+FilterExprUPtr parse_filter(const std::string_view &expr) {
+    return FilterParser(expr).parse();
+}
+
+}
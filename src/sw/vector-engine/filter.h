@@ -0,0 +1,81 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#ifndef SW_VECTOR_ENGINE_FILTER_H
+#define SW_VECTOR_ENGINE_FILTER_H
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sw::vengine {
+
+// Filter expression on attributes of vectors, e.g.
+//     lang == "en" and (year >= 2020 or genre in ["news", "blog"]) and not score < 0.5
+// A comparison takes an attribute name on the left, and a literal on the right.
+// Strings are quoted with " or ', and numbers are integers or floats. Operators
+// can also be written as &&, || and !.
+// Like NULL in SQL, a comparison is unknown for vectors without the attribute, and
+// so is its negation, i.e. neither `year == 2000` nor `not year == 2000` matches
+// a vector without `year`, the same as `year != 2000`. AND and OR follow three-valued
+// logic, e.g. `false and unknown` is false, and `true or unknown` is true. Only
+// vectors for which the whole expression is true are matched.
+enum class FilterOp {
+    AND = 0,
+    OR,
+    NOT,
+    EQ,
+    NE,
+    LT,
+    LE,
+    GT,
+    GE,
+    IN
+};
+
+struct FilterLiteral {
+    bool is_string = false;
+
+    std::string str;
+
+    double num = 0;
+};
+
+struct FilterExpr;
+
+using FilterExprUPtr = std::unique_ptr<FilterExpr>;
+
+struct FilterExpr {
+    FilterOp op;
+
+    // Operands of AND, OR and NOT.
+    std::vector<FilterExprUPtr> children;
+
+    // Attribute of comparisons.
+    std::string attr;
+
+    // Literals of comparisons. IN has one or more literals, and others have one.
+    std::vector<FilterLiteral> values;
+};
+
+// Throw Error if `expr` is invalid.
+FilterExprUPtr parse_filter(const std::string_view &expr);
+
+}
+
+#endif // end SW_VECTOR_ENGINE_FILTER_H
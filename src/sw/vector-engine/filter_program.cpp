@@ -0,0 +1,145 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#include "sw/vector-engine/filter_program.h"
+#include <algorithm>
+#include <cassert>
+
+namespace sw::vengine {
+
+FilterProgram::FilterProgram(const std::string_view &expr) {
+    auto root = parse_filter(expr);
+    assert(root);
+
+    _compile(*root, 0);
+}
+
+void FilterProgram::_compile(const FilterExpr &expr, std::size_t depth) {
+    switch (expr.op) {
+    case FilterOp::AND:
+    case FilterOp::OR: {
+        assert(!expr.children.empty());
+
+        auto opcode = expr.op == FilterOp::AND ? FilterOpcode::AND : FilterOpcode::OR;
+        _compile(*expr.children.front(), depth);
+        for (std::size_t idx = 1; idx < expr.children.size(); ++idx) {
+            // Result of the previous children is below.
+            _compile(*expr.children[idx], depth + 1);
+            _emit(opcode);
+        }
+        break;
+    }
+
+    case FilterOp::NOT:
+        assert(expr.children.size() == 1);
+
+        _compile(*expr.children.front(), depth);
+        _emit(FilterOpcode::NOT);
+        break;
+
+    case FilterOp::IN:
+        assert(!expr.values.empty());
+
+        _emit_compare(FilterOp::EQ, expr.attr, expr.values.front(), depth);
+        for (std::size_t idx = 1; idx < expr.values.size(); ++idx) {
+            _emit_compare(FilterOp::EQ, expr.attr, expr.values[idx], depth + 1);
+            _emit(FilterOpcode::OR);
+        }
+        break;
+
+    default:
+        assert(expr.values.size() == 1);
+
+        _emit_compare(expr.op, expr.attr, expr.values.front(), depth);
+        break;
+    }
+}
+
+void FilterProgram::_emit(FilterOpcode opcode) {
+    FilterInstruction instruction;
+    instruction.opcode = opcode;
+    _code.push_back(instruction);
+}
+
+void FilterProgram::_emit_compare(FilterOp op,
+                                    const std::string &attr,
+                                    const FilterLiteral &literal,
+                                    std::size_t depth) {
+    auto attr_iter = std::find(_attrs.begin(), _attrs.end(), attr);
+    if (attr_iter == _attrs.end()) {
+        attr_iter = _attrs.insert(_attrs.end(), attr);
+    }
+
+    auto literal_iter = std::find_if(_literals.begin(), _literals.end(),
+            [&literal](const FilterLiteral &other) {
+                return literal.is_string == other.is_string
+                    && (literal.is_string ? literal.str == other.str : literal.num == other.num);
+            });
+    if (literal_iter == _literals.end()) {
+        literal_iter = _literals.insert(_literals.end(), literal);
+    }
+
+    FilterInstruction instruction;
+    instruction.opcode = FilterOpcode::COMPARE;
+    instruction.op = op;
+    instruction.attr = static_cast<uint32_t>(attr_iter - _attrs.begin());
+    instruction.literal = static_cast<uint32_t>(literal_iter - _literals.begin());
+    _code.push_back(instruction);
+
+    _max_depth = std::max(_max_depth, depth + 1);
+}
+
+FilterProgramCache& FilterProgramCache::instance() {
+    static FilterProgramCache inst;
+    return inst;
+}
+
+FilterProgramSPtr FilterProgramCache::get(const std::string_view &expr) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        auto iter = _index.find(expr);
+        if (iter != _index.end()) {
+            _programs.splice(_programs.begin(), _programs, iter->second);
+            return iter->second->second;
+        }
+    }
+
+    // Compile without lock, and it throws if `expr` is invalid.
+    auto program = std::make_shared<const FilterProgram>(expr);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto iter = _index.find(expr);
+    if (iter != _index.end()) {
+        // Another worker has compiled it.
+        _programs.splice(_programs.begin(), _programs, iter->second);
+        return iter->second->second;
+    }
+
+    _programs.emplace_front(std::string(expr), program);
+    _index.emplace(_programs.front().first, _programs.begin());
+
+    if (_programs.size() > CAPACITY) {
+        _index.erase(_programs.back().first);
+        _programs.pop_back();
+    }
+
+    return program;
+}
+
+}
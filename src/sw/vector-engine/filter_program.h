@@ -0,0 +1,144 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#ifndef SW_VECTOR_ENGINE_FILTER_PROGRAM_H
+#define SW_VECTOR_ENGINE_FILTER_PROGRAM_H
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "sw/vector-engine/filter.h"
+
+namespace sw::vengine {
+
+// Values on the stack are pairs of masks of ids for which the expression is true,
+// and for which it's false. Ids in neither mask are unknown (see filter.h).
+enum class FilterOpcode : uint8_t {
+    // Push masks of `attr op literal`. Ids without the attribute are in neither mask.
+    COMPARE = 0,
+
+    // Pop two values, and push their conjunction or disjunction.
+    AND,
+    OR,
+
+    // Swap the true and false masks of the top value.
+    NOT
+};
+
+struct FilterInstruction {
+    FilterOpcode opcode;
+
+    // Operator of COMPARE, i.e. EQ, NE, LT, LE, GT or GE.
+    FilterOp op = FilterOp::EQ;
+
+    // Index of attribute names and literals of the program.
+    uint32_t attr = 0;
+    uint32_t literal = 0;
+};
+
+// Filter expression compiled into a postfix program for a stack machine, whose
+// values are masks of a batch of ids. IN is expanded into ORs of EQs, and attribute
+// names and literals are deduplicated, so that they're resolved once per evaluation.
+// Programs don't depend on attributes, and can be shared by all collections.
+class FilterProgram {
+public:
+    // Throw Error if `expr` is invalid.
+    explicit FilterProgram(const std::string_view &expr);
+
+    FilterProgram(const FilterProgram &) = delete;
+    FilterProgram& operator=(const FilterProgram &) = delete;
+
+    FilterProgram(FilterProgram &&) = delete;
+    FilterProgram& operator=(FilterProgram &&) = delete;
+
+    ~FilterProgram() = default;
+
+    const std::vector<FilterInstruction>& code() const noexcept {
+        return _code;
+    }
+
+    const std::vector<std::string>& attrs() const noexcept {
+        return _attrs;
+    }
+
+    const std::vector<FilterLiteral>& literals() const noexcept {
+        return _literals;
+    }
+
+    // Max number of values on the stack.
+    std::size_t max_depth() const noexcept {
+        return _max_depth;
+    }
+
+private:
+    // Emit code of `expr`, which runs with `depth` masks on the stack.
+    void _compile(const FilterExpr &expr, std::size_t depth);
+
+    void _emit(FilterOpcode opcode);
+
+    void _emit_compare(FilterOp op, const std::string &attr, const FilterLiteral &literal, std::size_t depth);
+
+    std::vector<FilterInstruction> _code;
+
+    std::vector<std::string> _attrs;
+
+    std::vector<FilterLiteral> _literals;
+
+    std::size_t _max_depth = 0;
+};
+
+using FilterProgramSPtr = std::shared_ptr<const FilterProgram>;
+
+// LRU cache of compiled programs keyed by expression text, which is shared by all
+// workers, so that repeated filters skip parsing and compiling.
+class FilterProgramCache {
+public:
+    static FilterProgramCache& instance();
+
+    FilterProgramCache(const FilterProgramCache &) = delete;
+    FilterProgramCache& operator=(const FilterProgramCache &) = delete;
+    FilterProgramCache(FilterProgramCache &&) = delete;
+    FilterProgramCache& operator=(FilterProgramCache &&) = delete;
+
+    // Compile `expr` if it's not cached. Throw Error if `expr` is invalid,
+    // and invalid expressions are not cached.
+    FilterProgramSPtr get(const std::string_view &expr);
+
+private:
+    FilterProgramCache() = default;
+
+    static constexpr std::size_t CAPACITY = 1024;
+
+    using Entry = std::pair<std::string, FilterProgramSPtr>;
+
+    std::mutex _mutex;
+
+    // Most recently used first.
+    std::list<Entry> _programs;
+
+    // Keys reference the text in `_programs`, whose nodes never move.
+    std::unordered_map<std::string_view, std::list<Entry>::iterator> _index;
+};
+
+}
+
+#endif // end SW_VECTOR_ENGINE_FILTER_PROGRAM_H
@@ -0,0 +1,295 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#include "sw/vector-engine/filter_scan.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define VECTOR_ENGINE_X86 1
+#include <immintrin.h>
+#endif
+
+namespace sw::vengine {
+
+namespace {
+
+// Number of comparison operators, i.e. EQ, NE, LT, LE, GT and GE.
+constexpr std::size_t COMPARE_OPS = 6;
+
+std::size_t op_index(FilterOp op) {
+    assert(op >= FilterOp::EQ && op <= FilterOp::GE);
+
+    return static_cast<std::size_t>(op) - static_cast<std::size_t>(FilterOp::EQ);
+}
+
+// `mask` has been cleared by the caller.
+template <typename T>
+using CompareFunc = void (*)(const T *vals, std::size_t n, T literal, uint64_t *mask);
+
+template <FilterOp OP, typename T>
+bool compare(T val, T literal) {
+    if constexpr (OP == FilterOp::EQ) {
+        return val == literal;
+    } else if constexpr (OP == FilterOp::NE) {
+        return val != literal;
+    } else if constexpr (OP == FilterOp::LT) {
+        return val < literal;
+    } else if constexpr (OP == FilterOp::LE) {
+        return val <= literal;
+    } else if constexpr (OP == FilterOp::GT) {
+        return val > literal;
+    } else {
+        return val >= literal;
+    }
+}
+
+// Compare vals[i] for i in [begin, n).
+template <FilterOp OP, typename T>
+void compare_tail(const T *vals, std::size_t begin, std::size_t n, T literal, uint64_t *mask) {
+    // Branchless, since results are unpredictable.
+    for (auto i = begin; i < n; ++i) {
+        mask[i / 64] |= static_cast<uint64_t>(compare<OP>(vals[i], literal)) << (i % 64);
+    }
+}
+
+template <FilterOp OP, typename T>
+void compare_scalar(const T *vals, std::size_t n, T literal, uint64_t *mask) {
+    compare_tail<OP>(vals, 0, n, literal, mask);
+}
+
+#ifdef VECTOR_ENGINE_X86
+
+// NE is unordered, so that it's true for NaN, the same as the scalar one.
+template <FilterOp OP>
+constexpr int double_predicate() {
+    if constexpr (OP == FilterOp::EQ) {
+        return _CMP_EQ_OQ;
+    } else if constexpr (OP == FilterOp::NE) {
+        return _CMP_NEQ_UQ;
+    } else if constexpr (OP == FilterOp::LT) {
+        return _CMP_LT_OQ;
+    } else if constexpr (OP == FilterOp::LE) {
+        return _CMP_LE_OQ;
+    } else if constexpr (OP == FilterOp::GT) {
+        return _CMP_GT_OQ;
+    } else {
+        return _CMP_GE_OQ;
+    }
+}
+
+template <FilterOp OP>
+constexpr int int_predicate() {
+    if constexpr (OP == FilterOp::EQ) {
+        return _MM_CMPINT_EQ;
+    } else if constexpr (OP == FilterOp::NE) {
+        return _MM_CMPINT_NE;
+    } else if constexpr (OP == FilterOp::LT) {
+        return _MM_CMPINT_LT;
+    } else if constexpr (OP == FilterOp::LE) {
+        return _MM_CMPINT_LE;
+    } else if constexpr (OP == FilterOp::GT) {
+        return _MM_CMPINT_NLE;
+    } else {
+        return _MM_CMPINT_NLT;
+    }
+}
+
+template <FilterOp OP>
+__attribute__((target("avx2")))
+void compare_double_avx2(const double *vals, std::size_t n, double literal, uint64_t *mask) {
+    constexpr int pred = double_predicate<OP>();
+    auto lit = _mm256_set1_pd(literal);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        auto cmp = _mm256_cmp_pd(_mm256_loadu_pd(vals + i), lit, pred);
+        mask[i / 64] |= static_cast<uint64_t>(_mm256_movemask_pd(cmp)) << (i % 64);
+    }
+
+    compare_tail<OP>(vals, i, n, literal, mask);
+}
+
+// AVX2 only has == and >, and other operators are built by swapping operands or negation.
+template <FilterOp OP>
+__attribute__((target("avx2")))
+void compare_int64_avx2(const int64_t *vals, std::size_t n, int64_t literal, uint64_t *mask) {
+    auto lit = _mm256_set1_epi64x(literal);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        auto val = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vals + i));
+        __m256i cmp;
+        if constexpr (OP == FilterOp::EQ || OP == FilterOp::NE) {
+            cmp = _mm256_cmpeq_epi64(val, lit);
+        } else if constexpr (OP == FilterOp::GT || OP == FilterOp::LE) {
+            cmp = _mm256_cmpgt_epi64(val, lit);
+        } else {
+            cmp = _mm256_cmpgt_epi64(lit, val);
+        }
+
+        auto bits = static_cast<uint64_t>(_mm256_movemask_pd(_mm256_castsi256_pd(cmp)));
+        if constexpr (OP == FilterOp::NE || OP == FilterOp::LE || OP == FilterOp::GE) {
+            bits ^= 0xF;
+        }
+
+        mask[i / 64] |= bits << (i % 64);
+    }
+
+    compare_tail<OP>(vals, i, n, literal, mask);
+}
+
+template <FilterOp OP>
+__attribute__((target("avx512f")))
+void compare_double_avx512(const double *vals, std::size_t n, double literal, uint64_t *mask) {
+    constexpr int pred = double_predicate<OP>();
+    auto lit = _mm512_set1_pd(literal);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        auto bits = _mm512_cmp_pd_mask(_mm512_loadu_pd(vals + i), lit, pred);
+        mask[i / 64] |= static_cast<uint64_t>(bits) << (i % 64);
+    }
+
+    compare_tail<OP>(vals, i, n, literal, mask);
+}
+
+template <FilterOp OP>
+__attribute__((target("avx512f")))
+void compare_int64_avx512(const int64_t *vals, std::size_t n, int64_t literal, uint64_t *mask) {
+    constexpr int pred = int_predicate<OP>();
+    auto lit = _mm512_set1_epi64(literal);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        auto bits = _mm512_cmp_epi64_mask(_mm512_loadu_si512(vals + i), lit, pred);
+        mask[i / 64] |= static_cast<uint64_t>(bits) << (i % 64);
+    }
+
+    compare_tail<OP>(vals, i, n, literal, mask);
+}
+
+template <FilterOp OP>
+__attribute__((target("avx2")))
+void compare_uint32_avx2(const uint32_t *vals, std::size_t n, uint32_t literal, uint64_t *mask) {
+    static_assert(OP == FilterOp::EQ || OP == FilterOp::NE, "tags only support EQ and NE");
+
+    auto lit = _mm256_set1_epi32(static_cast<int>(literal));
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        auto val = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vals + i));
+        auto cmp = _mm256_cmpeq_epi32(val, lit);
+        auto bits = static_cast<uint64_t>(_mm256_movemask_ps(_mm256_castsi256_ps(cmp)));
+        if constexpr (OP == FilterOp::NE) {
+            bits ^= 0xFF;
+        }
+
+        mask[i / 64] |= bits << (i % 64);
+    }
+
+    compare_tail<OP>(vals, i, n, literal, mask);
+}
+
+template <FilterOp OP>
+__attribute__((target("avx512f")))
+void compare_uint32_avx512(const uint32_t *vals, std::size_t n, uint32_t literal, uint64_t *mask) {
+    static_assert(OP == FilterOp::EQ || OP == FilterOp::NE, "tags only support EQ and NE");
+
+    constexpr int pred = int_predicate<OP>();
+    auto lit = _mm512_set1_epi32(static_cast<int>(literal));
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        auto bits = _mm512_cmp_epu32_mask(_mm512_loadu_si512(vals + i), lit, pred);
+        mask[i / 64] |= static_cast<uint64_t>(bits) << (i % 64);
+    }
+
+    compare_tail<OP>(vals, i, n, literal, mask);
+}
+
+#endif
+
+// Kernels of int64 and double, indexed by `op_index`, and kernels of tags,
+// i.e. uint32, which only have EQ and NE.
+struct Kernels {
+    Kernels() {
+#ifdef VECTOR_ENGINE_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            integers = {compare_int64_avx512<FilterOp::EQ>, compare_int64_avx512<FilterOp::NE>,
+                        compare_int64_avx512<FilterOp::LT>, compare_int64_avx512<FilterOp::LE>,
+                        compare_int64_avx512<FilterOp::GT>, compare_int64_avx512<FilterOp::GE>};
+            numbers = {compare_double_avx512<FilterOp::EQ>, compare_double_avx512<FilterOp::NE>,
+                        compare_double_avx512<FilterOp::LT>, compare_double_avx512<FilterOp::LE>,
+                        compare_double_avx512<FilterOp::GT>, compare_double_avx512<FilterOp::GE>};
+            tags = {compare_uint32_avx512<FilterOp::EQ>, compare_uint32_avx512<FilterOp::NE>};
+            return;
+        }
+
+        if (__builtin_cpu_supports("avx2")) {
+            integers = {compare_int64_avx2<FilterOp::EQ>, compare_int64_avx2<FilterOp::NE>,
+                        compare_int64_avx2<FilterOp::LT>, compare_int64_avx2<FilterOp::LE>,
+                        compare_int64_avx2<FilterOp::GT>, compare_int64_avx2<FilterOp::GE>};
+            numbers = {compare_double_avx2<FilterOp::EQ>, compare_double_avx2<FilterOp::NE>,
+                        compare_double_avx2<FilterOp::LT>, compare_double_avx2<FilterOp::LE>,
+                        compare_double_avx2<FilterOp::GT>, compare_double_avx2<FilterOp::GE>};
+            tags = {compare_uint32_avx2<FilterOp::EQ>, compare_uint32_avx2<FilterOp::NE>};
+            return;
+        }
+#endif
+
+        integers = {compare_scalar<FilterOp::EQ, int64_t>, compare_scalar<FilterOp::NE, int64_t>,
+                    compare_scalar<FilterOp::LT, int64_t>, compare_scalar<FilterOp::LE, int64_t>,
+                    compare_scalar<FilterOp::GT, int64_t>, compare_scalar<FilterOp::GE, int64_t>};
+        numbers = {compare_scalar<FilterOp::EQ, double>, compare_scalar<FilterOp::NE, double>,
+                    compare_scalar<FilterOp::LT, double>, compare_scalar<FilterOp::LE, double>,
+                    compare_scalar<FilterOp::GT, double>, compare_scalar<FilterOp::GE, double>};
+        tags = {compare_scalar<FilterOp::EQ, uint32_t>, compare_scalar<FilterOp::NE, uint32_t>};
+    }
+
+    std::array<CompareFunc<int64_t>, COMPARE_OPS> integers;
+    std::array<CompareFunc<double>, COMPARE_OPS> numbers;
+    std::array<CompareFunc<uint32_t>, 2> tags;
+};
+
+const Kernels& kernels() {
+    static const Kernels inst;
+    return inst;
+}
+
+}
+
+void compare_batch(const int64_t *vals, std::size_t n, FilterOp op, int64_t literal, uint64_t *mask) {
+    assert(n <= FILTER_BATCH);
+
+    std::fill(mask, mask + FILTER_BATCH_WORDS, 0);
+    kernels().integers[op_index(op)](vals, n, literal, mask);
+}
+
+void compare_batch(const double *vals, std::size_t n, FilterOp op, double literal, uint64_t *mask) {
+    assert(n <= FILTER_BATCH);
+
+    std::fill(mask, mask + FILTER_BATCH_WORDS, 0);
+    kernels().numbers[op_index(op)](vals, n, literal, mask);
+}
+
+void compare_batch(const uint32_t *vals, std::size_t n, FilterOp op, uint32_t literal, uint64_t *mask) {
+    assert(n <= FILTER_BATCH);
+
+    assert(op == FilterOp::EQ || op == FilterOp::NE);
+
+    std::fill(mask, mask + FILTER_BATCH_WORDS, 0);
+    kernels().tags[op_index(op)](vals, n, literal, mask);
+}
+
+}
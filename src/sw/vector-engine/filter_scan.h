@@ -0,0 +1,44 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#ifndef SW_VECTOR_ENGINE_FILTER_SCAN_H
+#define SW_VECTOR_ENGINE_FILTER_SCAN_H
+
+#include <cstddef>
+#include <cstdint>
+#include "sw/vector-engine/filter.h"
+
+namespace sw::vengine {
+
+// Filters are evaluated on batches of FILTER_BATCH consecutive ids, and the result
+// of a batch is a mask of FILTER_BATCH_WORDS words, i.e. bit i of word w is for id
+// `base + w * 64 + i`.
+constexpr std::size_t FILTER_BATCH = 256;
+constexpr std::size_t FILTER_BATCH_WORDS = FILTER_BATCH / 64;
+
+// Set bit i of `mask` if `vals[i] op literal`, for i in [0, n), and clear other bits.
+// `op` is one of EQ, NE, LT, LE, GT and GE, and `n` is at most FILTER_BATCH.
+void compare_batch(const int64_t *vals, std::size_t n, FilterOp op, int64_t literal, uint64_t *mask);
+
+void compare_batch(const double *vals, std::size_t n, FilterOp op, double literal, uint64_t *mask);
+
+// Same as above, but `op` must be EQ or NE.
+void compare_batch(const uint32_t *vals, std::size_t n, FilterOp op, uint32_t literal, uint64_t *mask);
+
+}
+
+#endif // end SW_VECTOR_ENGINE_FILTER_SCAN_H
@@ -0,0 +1,114 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#include "sw/vector-engine/flat_index.h"
+#include <algorithm>
+#include <cassert>
+#include <mutex>
+#include "sw/vector-engine/batch_scan.h"
+#include "sw/vector-engine/parallel.h"
+
+namespace sw::vengine {
+
+void FlatIndex::add(VectorId id, const float * /*vec*/) {
+    if (id >= _used.size()) {
+        _used.resize(static_cast<std::size_t>(id) + 1, false);
+    }
+
+    _used[id] = true;
+}
+
+void FlatIndex::remove(VectorId id) {
+    assert(id < _used.size());
+
+    _used[id] = false;
+}
+
+std::vector<Neighbor> FlatIndex::search(const float *query, const SearchOptions &opts) const {
+    assert(query != nullptr);
+
+    auto k = opts.k;
+    if (k == 0) {
+        return {};
+    }
+
+    // Each range is scanned into its own heap, and merged at the end.
+    NeighborHeap heap;
+    std::mutex mutex;
+    auto dim = _storage.dim();
+    auto scan = [this, query, k, dim, &heap, &mutex](std::size_t num, const auto &id_at) {
+        adaptive_parallel_for(num, PARALLEL_GRAIN, [&](std::size_t begin, std::size_t end) {
+            NeighborHeap local;
+            for (auto idx = begin; idx != end; ++idx) {
+                auto id = id_at(idx);
+                if (id < _used.size() && _used[id]) {
+                    push_neighbor(local, k, _distance(query, _storage.raw(id), dim), id);
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+
+            merge_neighbors(heap, k, local);
+        });
+    };
+
+    if (opts.filter == nullptr) {
+        scan(_used.size(), [](std::size_t idx) { return static_cast<VectorId>(idx); });
+    } else {
+        // Only visit ids in the filter.
+        auto ids = opts.filter->to_vector();
+        scan(ids.size(), [&ids](std::size_t idx) { return ids[idx]; });
+    }
+
+    return sorted_neighbors(heap);
+}
+
+std::vector<std::vector<Neighbor>> FlatIndex::search_batch(const std::vector<const float*> &queries,
+                                                            const std::vector<SearchOptions> &opts) const {
+    assert(queries.size() == opts.size());
+
+    if (queries.size() < 2 || _storage.type() != ElementType::FLOAT32 || _used.empty()) {
+        return Index::search_batch(queries, opts);
+    }
+
+    // Pad queries with zeros like stored vectors, so that the whole storage is a matrix.
+    auto dim = _storage.dim();
+    auto stride = _storage.stride();
+    std::vector<float> matrix(queries.size() * stride, 0.0f);
+    for (std::size_t idx = 0; idx != queries.size(); ++idx) {
+        assert(queries[idx] != nullptr);
+        std::copy_n(queries[idx], dim, matrix.data() + idx * stride);
+    }
+
+    std::vector<NeighborHeap> heaps(queries.size());
+    BatchScanner scanner(_metric, matrix.data(), queries.size(), dim, stride);
+    scanner.scan(_storage.data(0), _used.size(),
+            [this, &heaps, &opts](std::size_t query, std::size_t idx, float dist) {
+                if (_used[idx] && opts[query].k > 0 && matches(opts[query].filter, static_cast<VectorId>(idx))) {
+                    push_neighbor(heaps[query], opts[query].k, dist, static_cast<VectorId>(idx));
+                }
+            });
+
+    std::vector<std::vector<Neighbor>> results;
+    results.reserve(heaps.size());
+    for (auto &heap : heaps) {
+        results.push_back(sorted_neighbors(heap));
+    }
+
+    return results;
+}
+
+}
@@ -0,0 +1,62 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#ifndef SW_VECTOR_ENGINE_FLAT_INDEX_H
+#define SW_VECTOR_ENGINE_FLAT_INDEX_H
+
+#include <vector>
+#include "sw/vector-engine/index.h"
+
+namespace sw::vengine {
+
+// Exact search by scanning all vectors, which is the recall baseline.
+// A batch of queries on float32 vectors is scanned with a blocked GEMM kernel.
+// A single query on a large index is split into ranges scanned by idle workers.
+class FlatIndex : public Index {
+public:
+    FlatIndex(const VectorStorage &storage, Metric metric) :
+        _storage(storage), _metric(metric), _distance(distance_func(metric, storage.type())) {}
+
+    virtual void add(VectorId id, const float *vec) override;
+
+    virtual void remove(VectorId id) override;
+
+    virtual std::vector<Neighbor> search(const float *query, const SearchOptions &opts) const override;
+
+    virtual std::vector<std::vector<Neighbor>> search_batch(const std::vector<const float*> &queries,
+                                                            const std::vector<SearchOptions> &opts) const override;
+
+    virtual std::size_t memory_usage() const override {
+        return _used.capacity() / 8;
+    }
+
+private:
+    // Min number of vectors scanned by a worker.
+    static constexpr std::size_t PARALLEL_GRAIN = 32768;
+
+    const VectorStorage &_storage;
+
+    Metric _metric;
+
+    StoredDistanceFunc _distance;
+
+    // Whether the id is in use, i.e. not deleted.
+    std::vector<bool> _used;
+};
+
+}
+
+#endif // end SW_VECTOR_ENGINE_FLAT_INDEX_H
@@ -0,0 +1,366 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#include "sw/vector-engine/hnsw_index.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <string>
+#include "sw/vector-engine/errors.h"
+
+namespace sw::vengine {
+
+namespace {
+
+// Visited marks tagged by an epoch, so that resetting is O(1) for each search.
+class VisitedList {
+public:
+    void reset(std::size_t size) {
+        if (_marks.size() < size) {
+            _marks.resize(size, 0);
+        }
+
+        if (++_epoch == 0) {
+            // Wrapped around, old marks might collide with the new epoch.
+            std::fill(_marks.begin(), _marks.end(), 0);
+            _epoch = 1;
+        }
+    }
+
+    // @return false if `id` has already been visited.
+    bool visit(VectorId id) {
+        assert(id < _marks.size());
+
+        if (_marks[id] == _epoch) {
+            return false;
+        }
+
+        _marks[id] = _epoch;
+
+        return true;
+    }
+
+private:
+    std::vector<uint32_t> _marks;
+
+    uint32_t _epoch = 0;
+};
+
+thread_local VisitedList visited_list;
+
+}
+
+HnswIndex::HnswIndex(const IndexOptions &opts, const VectorStorage &storage, Metric metric) :
+    _storage(storage),
+    _distance(distance_func(metric, storage.type())),
+    _m(opts.m),
+    _ef_construction(opts.ef_construction),
+    _rng(std::random_device{}()) {
+    if (_m < 2) {
+        throw Error("M of HNSW must be at least 2");
+    }
+
+    if (_m > MAX_M) {
+        throw Error("M of HNSW must be at most " + std::to_string(MAX_M));
+    }
+
+    if (_ef_construction == 0) {
+        throw Error("EF_CONSTRUCTION of HNSW must larger than 0");
+    }
+
+    if (_ef_construction > MAX_EF_CONSTRUCTION) {
+        throw Error("EF_CONSTRUCTION of HNSW must be at most " + std::to_string(MAX_EF_CONSTRUCTION));
+    }
+
+    _level_mult = 1.0 / std::log(static_cast<double>(_m));
+}
+
+void HnswIndex::prepare(VectorId id) {
+    while (_nodes.size() <= id) {
+        _nodes.emplace_back();
+    }
+
+    auto &node = _nodes[id];
+    if (node.links.empty()) {
+        node.links.resize(_random_level() + 1);
+    }
+    // Otherwise, the vector has been updated or the id is reused. Keep its level
+    // and old links, which still help the search in `add` to get out of this node.
+
+    node.deleted.store(false, std::memory_order_relaxed);
+}
+
+void HnswIndex::add(VectorId id, const float * /*vec*/) {
+    assert(id < _nodes.size());
+
+    auto &node = _nodes[id];
+    std::size_t level = node.links.size() - 1;
+
+    auto entry = _entry.load(std::memory_order_acquire);
+    if (entry == 0 && _entry.compare_exchange_strong(entry, _pack(id, level + 1))) {
+        // The first node.
+        return;
+    }
+    // Otherwise, `entry` has been updated by another insert.
+
+    // Read the stored copy, which is the one other nodes see when they link to this node.
+    std::vector<float> buf;
+    const auto *query = _vector(id, buf);
+
+    auto [entry_point, num_levels] = _unpack(entry);
+    auto cur = entry_point;
+    for (auto l = num_levels - 1; l > level; --l) {
+        cur = _search_closest(query, cur, l);
+    }
+
+    for (auto l = std::min(level, num_levels - 1) + 1; l-- > 0; ) {
+        // Deleted nodes are linked too, so that the new node is reachable even if
+        // most of its neighborhood has been deleted.
+        auto candidates = _search_layer(query, cur, _ef_construction, l, nullptr, true);
+        candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                    [id](const Neighbor &n) { return n.second == id; }),
+                candidates.end());
+
+        if (!candidates.empty()) {
+            cur = candidates.front().second;
+        }
+
+        auto neighbors = _select_neighbors(candidates, _m);
+        for (auto neighbor : neighbors) {
+            _connect(neighbor, id, l);
+        }
+
+        std::lock_guard<SpinLock> lock(node.lock);
+        node.links[l] = std::move(neighbors);
+    }
+
+    // Become the entry point, if it's higher than the graph.
+    while (level + 1 > _unpack(entry).second) {
+        if (_entry.compare_exchange_weak(entry, _pack(id, level + 1), std::memory_order_acq_rel)) {
+            break;
+        }
+    }
+}
+
+void HnswIndex::remove(VectorId id) {
+    assert(id < _nodes.size());
+
+    _nodes[id].deleted.store(true, std::memory_order_relaxed);
+}
+
+std::vector<Neighbor> HnswIndex::search(const float *query, const SearchOptions &opts) const {
+    assert(query != nullptr);
+
+    auto [entry_point, num_levels] = _unpack(_entry.load(std::memory_order_acquire));
+    if (num_levels == 0 || opts.k == 0) {
+        return {};
+    }
+
+    auto cur = entry_point;
+    for (auto l = num_levels - 1; l > 0; --l) {
+        cur = _search_closest(query, cur, l);
+    }
+
+    auto ef = std::max(opts.ef == 0 ? DEFAULT_EF : opts.ef, opts.k);
+    auto neighbors = _search_layer(query, cur, ef, 0, opts.filter);
+    if (neighbors.size() > opts.k) {
+        neighbors.resize(opts.k);
+    }
+
+    return neighbors;
+}
+
+std::size_t HnswIndex::memory_usage() const {
+    auto usage = _nodes.size() * sizeof(Node);
+    for (const auto &node : _nodes) {
+        std::lock_guard<SpinLock> lock(node.lock);
+
+        usage += node.links.capacity() * sizeof(std::vector<VectorId>);
+        for (const auto &links : node.links) {
+            usage += links.capacity() * sizeof(VectorId);
+        }
+    }
+
+    return usage;
+}
+
+std::size_t HnswIndex::_random_level() {
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+
+    // 1 - [0, 1) is in (0, 1], so that log never gets 0.
+    return static_cast<std::size_t>(-std::log(1.0 - dist(_rng)) * _level_mult);
+}
+
+void HnswIndex::_get_links(VectorId id, std::size_t level, std::vector<VectorId> &neighbors) const {
+    const auto &node = _nodes[id];
+
+    std::lock_guard<SpinLock> lock(node.lock);
+
+    const auto &links = node.links[level];
+    neighbors.assign(links.begin(), links.end());
+}
+
+VectorId HnswIndex::_search_closest(const float *query, VectorId entry, std::size_t level) const {
+    auto cur = entry;
+    auto cur_dist = _dist(query, cur);
+    std::vector<VectorId> neighbors;
+    auto changed = true;
+    while (changed) {
+        changed = false;
+        _get_links(cur, level, neighbors);
+        for (auto neighbor : neighbors) {
+            auto dist = _dist(query, neighbor);
+            if (dist < cur_dist) {
+                cur = neighbor;
+                cur_dist = dist;
+                changed = true;
+            }
+        }
+    }
+
+    return cur;
+}
+
+std::vector<Neighbor> HnswIndex::_search_layer(const float *query,
+                                                VectorId entry,
+                                                std::size_t ef,
+                                                std::size_t level,
+                                                const Bitmap *filter,
+                                                bool with_deleted) const {
+    auto &visited = visited_list;
+    visited.reset(_nodes.size());
+    visited.visit(entry);
+
+    // Nodes to be expanded, nearest first.
+    std::priority_queue<Neighbor, std::vector<Neighbor>, std::greater<Neighbor>> candidates;
+
+    // Nearest nodes found so far, farthest first.
+    std::priority_queue<Neighbor> results;
+
+    // Deleted and filtered-out nodes are still expanded, so that nodes behind them can
+    // be reached, but they don't take slots of `results`, which would end the search early.
+    auto admit = [this, filter, with_deleted](VectorId id) {
+        return matches(filter, id)
+            && (with_deleted || !_nodes[id].deleted.load(std::memory_order_relaxed));
+    };
+
+    auto dist = _dist(query, entry);
+    candidates.emplace(dist, entry);
+    if (admit(entry)) {
+        results.emplace(dist, entry);
+    }
+
+    std::vector<VectorId> neighbors;
+    while (!candidates.empty()) {
+        auto [cand_dist, cand] = candidates.top();
+        if (results.size() >= ef && cand_dist > results.top().first) {
+            // All remaining candidates are farther than the results.
+            break;
+        }
+        candidates.pop();
+
+        _get_links(cand, level, neighbors);
+        for (auto neighbor : neighbors) {
+            if (!visited.visit(neighbor)) {
+                continue;
+            }
+
+            auto neighbor_dist = _dist(query, neighbor);
+            if (results.size() < ef || neighbor_dist < results.top().first) {
+                candidates.emplace(neighbor_dist, neighbor);
+                if (admit(neighbor)) {
+                    results.emplace(neighbor_dist, neighbor);
+                    if (results.size() > ef) {
+                        results.pop();
+                    }
+                }
+            }
+        }
+    }
+
+    std::vector<Neighbor> nearest(results.size());
+    for (auto iter = nearest.rbegin(); iter != nearest.rend(); ++iter) {
+        *iter = results.top();
+        results.pop();
+    }
+
+    return nearest;
+}
+
+std::vector<VectorId> HnswIndex::_select_neighbors(const std::vector<Neighbor> &candidates,
+                                                    std::size_t m) const {
+    std::vector<VectorId> selected;
+    selected.reserve(m);
+    std::vector<float> buf;
+    for (const auto &[dist, cand] : candidates) {
+        if (selected.size() >= m) {
+            break;
+        }
+
+        const auto *vec = _vector(cand, buf);
+        auto diverse = std::none_of(selected.begin(), selected.end(),
+                [this, vec, dist = dist](VectorId id) { return _dist(vec, id) < dist; });
+        if (diverse) {
+            selected.push_back(cand);
+        }
+    }
+
+    return selected;
+}
+
+void HnswIndex::_connect(VectorId node, VectorId id, std::size_t level) {
+    std::lock_guard<SpinLock> lock(_nodes[node].lock);
+
+    auto &links = _nodes[node].links[level];
+    if (std::find(links.begin(), links.end(), id) != links.end()) {
+        return;
+    }
+
+    auto max_links = _max_links(level);
+    if (links.size() < max_links) {
+        links.push_back(id);
+        return;
+    }
+
+    std::vector<float> buf;
+    const auto *vec = _vector(node, buf);
+    std::vector<Neighbor> candidates;
+    candidates.reserve(links.size() + 1);
+    candidates.emplace_back(_dist(vec, id), id);
+    for (auto link : links) {
+        candidates.emplace_back(_dist(vec, link), link);
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    links = _select_neighbors(candidates, max_links);
+}
+
+const float* HnswIndex::_vector(VectorId id, std::vector<float> &buf) const {
+    if (_storage.type() == ElementType::FLOAT32) {
+        return _storage.data(id);
+    }
+
+    buf.resize(_storage.dim());
+    _storage.get(id, buf.data());
+
+    return buf.data();
+}
+
+}
@@ -0,0 +1,145 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#ifndef SW_VECTOR_ENGINE_HNSW_INDEX_H
+#define SW_VECTOR_ENGINE_HNSW_INDEX_H
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <vector>
+#include "sw/vector-engine/index.h"
+#include "sw/vector-engine/spin_lock.h"
+
+namespace sw::vengine {
+
+// Hierarchical Navigable Small World graph (Malkov & Yashunin).
+// Deleted vectors stay in the graph to keep it navigable, but are excluded
+// from results. When an id is reused or its vector is updated, the node keeps
+// its level and gets new neighbors.
+// Inserts run in parallel: each neighbor list is guarded by a per-node spin lock,
+// and the entry point is updated atomically, so there's no global lock.
+class HnswIndex : public Index {
+public:
+    HnswIndex(const IndexOptions &opts, const VectorStorage &storage, Metric metric);
+
+    virtual bool concurrent_add() const noexcept override {
+        return true;
+    }
+
+    // Allocate the node and assign its level.
+    virtual void prepare(VectorId id) override;
+
+    virtual void add(VectorId id, const float *vec) override;
+
+    virtual void remove(VectorId id) override;
+
+    virtual std::vector<Neighbor> search(const float *query, const SearchOptions &opts) const override;
+
+    virtual std::size_t memory_usage() const override;
+
+    // Nodes reserve links and candidate lists by M and EF_CONSTRUCTION,
+    // so larger ones are rejected.
+    static constexpr std::size_t MAX_M = 256;
+
+    static constexpr std::size_t MAX_EF_CONSTRUCTION = 4096;
+
+private:
+    static constexpr std::size_t DEFAULT_EF = 64;
+
+    struct Node {
+        // links[level] are neighbors on that level, and the node lives on
+        // levels [0, links.size()). The outer vector is only resized by `prepare`,
+        // and inner vectors are guarded by `lock`.
+        std::vector<std::vector<VectorId>> links;
+
+        mutable SpinLock lock;
+
+        std::atomic<bool> deleted{false};
+    };
+
+    // Entry point is packed with the number of levels, so that they're updated together.
+    static uint64_t _pack(VectorId entry_point, std::size_t num_levels) noexcept {
+        return (static_cast<uint64_t>(num_levels) << 32) | entry_point;
+    }
+
+    static std::pair<VectorId, std::size_t> _unpack(uint64_t entry) noexcept {
+        return {static_cast<VectorId>(entry), static_cast<std::size_t>(entry >> 32)};
+    }
+
+    float _dist(const float *query, VectorId id) const {
+        return _distance(query, _storage.raw(id), _storage.dim());
+    }
+
+    // @return the stored vector of `id`, which is widened into `buf` if it's not float32.
+    const float* _vector(VectorId id, std::vector<float> &buf) const;
+
+    std::size_t _max_links(std::size_t level) const noexcept {
+        return level == 0 ? 2 * _m : _m;
+    }
+
+    std::size_t _random_level();
+
+    // Copy neighbors of `id` on `level` into `neighbors`.
+    void _get_links(VectorId id, std::size_t level, std::vector<VectorId> &neighbors) const;
+
+    // Greedy walk on `level`, and return the closest node found.
+    VectorId _search_closest(const float *query, VectorId entry, std::size_t level) const;
+
+    // @return at most `ef` nearest nodes on `level`, sorted by distance in ascending order.
+    // Deleted nodes, unless `with_deleted`, and with a filter, nodes not in it, are expanded
+    // but not returned, so that the graph stays connected for the others. The search stops
+    // once `ef` returnable nodes are found and no candidate is closer, i.e. selective
+    // filters, or lots of deleted nodes, make it visit most of the graph.
+    std::vector<Neighbor> _search_layer(const float *query,
+                                        VectorId entry,
+                                        std::size_t ef,
+                                        std::size_t level,
+                                        const Bitmap *filter = nullptr,
+                                        bool with_deleted = false) const;
+
+    // Pick at most `m` diverse neighbors from `candidates` sorted by distance:
+    // a candidate is dropped if it's closer to a selected one than to the base.
+    std::vector<VectorId> _select_neighbors(const std::vector<Neighbor> &candidates,
+                                            std::size_t m) const;
+
+    // Add `id` to the neighbors of `node`, and prune them if there're too many.
+    void _connect(VectorId node, VectorId id, std::size_t level);
+
+    const VectorStorage &_storage;
+
+    StoredDistanceFunc _distance;
+
+    std::size_t _m;
+
+    std::size_t _ef_construction;
+
+    double _level_mult;
+
+    std::mt19937_64 _rng;
+
+    // Deque never moves nodes, and it only grows in `prepare`.
+    std::deque<Node> _nodes;
+
+    // Entry point and number of levels of the graph, see `_pack`.
+    // 0 levels means the graph is empty.
+    std::atomic<uint64_t> _entry{0};
+};
+
+}
+
+#endif // end SW_VECTOR_ENGINE_HNSW_INDEX_H
@@ -0,0 +1,140 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#include "sw/vector-engine/index.h"
+#include <cassert>
+#include "sw/vector-engine/binary_index.h"
+#include "sw/vector-engine/errors.h"
+#include "sw/vector-engine/flat_index.h"
+#include "sw/vector-engine/hnsw_index.h"
+#include "sw/vector-engine/ivf_index.h"
+#include "sw/vector-engine/ivf_pq_index.h"
+#include "sw/vector-engine/sq8_index.h"
+#include "sw/vector-engine/str_utils.h"
+
+namespace sw::vengine {
+
+void merge_neighbors(NeighborHeap &heap, std::size_t k, NeighborHeap &other) {
+    while (!other.empty()) {
+        push_neighbor(heap, k, other.top().first, other.top().second);
+        other.pop();
+    }
+}
+
+std::vector<Neighbor> sorted_neighbors(NeighborHeap &heap) {
+    std::vector<Neighbor> neighbors(heap.size());
+    for (auto iter = neighbors.rbegin(); iter != neighbors.rend(); ++iter) {
+        *iter = heap.top();
+        heap.pop();
+    }
+
+    return neighbors;
+}
+
+IndexType parse_index_type(const std::string_view &name) {
+    auto type = str::to_lower(name);
+    if (type == "flat") {
+        return IndexType::FLAT;
+    } else if (type == "hnsw") {
+        return IndexType::HNSW;
+    } else if (type == "ivf") {
+        return IndexType::IVF;
+    } else if (type == "ivf_pq") {
+        return IndexType::IVF_PQ;
+    } else if (type == "sq8") {
+        return IndexType::SQ8;
+    } else if (type == "binary") {
+        return IndexType::BINARY;
+    }
+
+    throw Error("unknown index type: " + std::string(name));
+}
+
+std::string to_string(IndexType type) {
+    switch (type) {
+    case IndexType::FLAT:
+        return "FLAT";
+
+    case IndexType::HNSW:
+        return "HNSW";
+
+    case IndexType::IVF:
+        return "IVF";
+
+    case IndexType::IVF_PQ:
+        return "IVF_PQ";
+
+    case IndexType::SQ8:
+        return "SQ8";
+
+    case IndexType::BINARY:
+        return "BINARY";
+
+    default:
+        throw Error("unknown index type");
+    }
+}
+
+std::vector<std::vector<Neighbor>> Index::search_batch(const std::vector<const float*> &queries,
+                                                        const std::vector<SearchOptions> &opts) const {
+    assert(queries.size() == opts.size());
+
+    std::vector<std::vector<Neighbor>> results;
+    results.reserve(queries.size());
+    for (std::size_t idx = 0; idx != queries.size(); ++idx) {
+        results.push_back(search(queries[idx], opts[idx]));
+    }
+
+    return results;
+}
+
+IndexUPtr IndexCreator::create(const IndexOptions &opts,
+                                const VectorStorage &storage,
+                                Metric metric) const {
+    if (storage.type() != ElementType::FLOAT32) {
+        // Other indexes keep their own codes, and read raw vectors as float32.
+        if (opts.type != IndexType::FLAT
+                && opts.type != IndexType::HNSW
+                && opts.type != IndexType::BINARY) {
+            throw Error(to_string(storage.type()) + " vectors only support FLAT, HNSW and BINARY index");
+        }
+    }
+
+    switch (opts.type) {
+    case IndexType::FLAT:
+        return std::make_unique<FlatIndex>(storage, metric);
+
+    case IndexType::HNSW:
+        return std::make_unique<HnswIndex>(opts, storage, metric);
+
+    case IndexType::IVF:
+        return std::make_unique<IvfFlatIndex>(opts, storage.dim(), metric);
+
+    case IndexType::IVF_PQ:
+        return std::make_unique<IvfPqIndex>(opts, storage, metric);
+
+    case IndexType::SQ8:
+        return std::make_unique<Sq8Index>(opts, storage, metric);
+
+    case IndexType::BINARY:
+        return std::make_unique<BinaryIndex>(opts, storage, metric);
+
+    default:
+        throw Error("unknown index type");
+    }
+}
+
+}
@@ -0,0 +1,209 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#ifndef SW_VECTOR_ENGINE_INDEX_H
+#define SW_VECTOR_ENGINE_INDEX_H
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "sw/vector-engine/bitmap.h"
+#include "sw/vector-engine/distance.h"
+#include "sw/vector-engine/errors.h"
+#include "sw/vector-engine/vector_storage.h"
+
+namespace sw::vengine {
+
+enum class IndexType {
+    FLAT = 0,
+    HNSW,
+    IVF,
+    IVF_PQ,
+    SQ8,
+    BINARY
+};
+
+// Throw Error if `name` is not a valid index type.
+IndexType parse_index_type(const std::string_view &name);
+
+std::string to_string(IndexType type);
+
+struct IndexOptions {
+    IndexType type = IndexType::FLAT;
+
+    // HNSW: max number of neighbors of a node on upper layers, and layer 0 has 2 * m.
+    std::size_t m = 16;
+
+    // HNSW: size of the dynamic candidate list when inserting.
+    std::size_t ef_construction = 200;
+
+    // IVF: number of inverted lists.
+    std::size_t nlist = 1024;
+
+    // IVF: default number of lists to scan.
+    std::size_t nprobe = 16;
+
+    // IVF_PQ: number of sub-quantizers, which must divide the dimension.
+    std::size_t pq_m = 8;
+
+    // IVF_PQ: bits of each sub-quantizer code, either 8 or 4. 4-bit codes are scanned
+    // with in-register lookup tables, which is much faster, but less accurate.
+    std::size_t pq_bits = 8;
+
+    // SQ8: train the quantization range of each dimension, or a global one for all dimensions.
+    bool sq_per_dim = true;
+
+    // BINARY: rescore `oversample * k` candidates of the Hamming search with exact distances.
+    std::size_t oversample = 8;
+
+    // IVF_PQ, SQ8: re-rank `rerank * k` candidates with exact distances. If it's 0,
+    // re-ranking is disabled, and raw vectors are not kept to save memory.
+    std::size_t rerank = 0;
+};
+
+struct SearchOptions {
+    std::size_t k = 10;
+
+    // HNSW: size of the dynamic candidate list, and 0 means max(k, default ef).
+    std::size_t ef = 0;
+
+    // IVF: number of lists to scan, and 0 means the one of IndexOptions.
+    std::size_t nprobe = 0;
+
+    // Only vectors in the filter are returned, and nullptr means no filter. Scans skip
+    // filtered-out vectors before computing distances, while HNSW expands through them.
+    const Bitmap *filter = nullptr;
+};
+
+// @return a * b, or the max size if it overflows, e.g. sizes derived from options.
+inline std::size_t saturated_mul(std::size_t a, std::size_t b) noexcept {
+    if (a != 0 && b > std::numeric_limits<std::size_t>::max() / a) {
+        return std::numeric_limits<std::size_t>::max();
+    }
+
+    return a * b;
+}
+
+// Whether `id` passes the filter, and nullptr means no filter.
+inline bool matches(const Bitmap *filter, VectorId id) {
+    return filter == nullptr || filter->contains(id);
+}
+
+// (distance, id)
+using Neighbor = std::pair<float, VectorId>;
+
+// Max heap of the k nearest candidates, so the farthest one is on the top.
+using NeighborHeap = std::priority_queue<Neighbor>;
+
+// Push the candidate into `heap`, which keeps at most `k` nearest ones.
+inline void push_neighbor(NeighborHeap &heap, std::size_t k, float dist, VectorId id) {
+    if (heap.size() < k) {
+        heap.emplace(dist, id);
+    } else if (dist < heap.top().first) {
+        heap.pop();
+        heap.emplace(dist, id);
+    }
+}
+
+// Move candidates of `other` into `heap`.
+void merge_neighbors(NeighborHeap &heap, std::size_t k, NeighborHeap &other);
+
+// @return candidates of `heap` from the nearest to the farthest, and `heap` is emptied.
+std::vector<Neighbor> sorted_neighbors(NeighborHeap &heap);
+
+// Index over vectors in a VectorStorage, which is owned by the collection.
+// The collection calls `prepare` and `remove` with exclusive access, and
+// `search` with shared access. `add` is called with exclusive access, unless
+// `concurrent_add` returns true, in which case it's called with shared access,
+// i.e. it might run in parallel with `add`s of other ids and `search`es. Such an
+// index should read the vector from storage, which the collection keeps unchanged
+// until `add` returns.
+class Index {
+public:
+    virtual ~Index() = default;
+
+    virtual bool concurrent_add() const noexcept {
+        return false;
+    }
+
+    // Whether the index reads raw vectors from storage. If not, the collection
+    // does not keep raw vectors, and the index must implement `reconstruct`.
+    virtual bool needs_raw_vectors() const noexcept {
+        return true;
+    }
+
+    // Called before `add`, e.g. to allocate per-id state.
+    virtual void prepare(VectorId /*id*/) {}
+
+    // Index a new vector, or an existing one whose value has been updated.
+    // If `needs_raw_vectors` is true, `vec` has already been written to storage.
+    virtual void add(VectorId id, const float *vec) = 0;
+
+    virtual void remove(VectorId id) = 0;
+
+    // @return at most `opts.k` nearest neighbors, sorted by distance in ascending order.
+    virtual std::vector<Neighbor> search(const float *query, const SearchOptions &opts) const = 0;
+
+    // Search a batch of queries, and `opts[i]` is the options of `queries[i]`.
+    // Indexes override it to share the scan among queries. By default, queries
+    // are searched one by one.
+    virtual std::vector<std::vector<Neighbor>> search_batch(const std::vector<const float*> &queries,
+                                                            const std::vector<SearchOptions> &opts) const;
+
+    // Bytes used by the index, excluding the vector storage.
+    virtual std::size_t memory_usage() const = 0;
+
+    // Decode the vector of `id`, which might be lossy, into `vec` with `dim` floats.
+    virtual void reconstruct(VectorId /*id*/, float * /*vec*/) const {
+        throw Error("index cannot reconstruct vectors");
+    }
+
+    // Indexes learned from data, e.g. IVF, are trained in 3 steps, so that the
+    // expensive part blocks neither searches nor adds of the collection:
+    // 1. `start_training` is called with exclusive access after `add`, if the index
+    //    does not support `concurrent_add`. It returns an untrained copy of the index,
+    //    or nullptr if training is not due.
+    // 2. `train` of the copy is called without any lock, usually by a worker in background.
+    // 3. `finish_training` is called with exclusive access. It replays changes since
+    //    `start_training` on the trained copy, which then replaces this index. If
+    //    training failed, it's called with nullptr, so that training can start over
+    //    later, e.g. once the index has grown enough that another try might succeed.
+    virtual std::unique_ptr<Index> start_training() {
+        return nullptr;
+    }
+
+    virtual void train() {}
+
+    virtual void finish_training(Index * /*trained*/) {}
+};
+
+using IndexUPtr = std::unique_ptr<Index>;
+
+class IndexCreator {
+public:
+    IndexUPtr create(const IndexOptions &opts,
+                        const VectorStorage &storage,
+                        Metric metric) const;
+};
+
+}
+
+#endif // end SW_VECTOR_ENGINE_INDEX_H
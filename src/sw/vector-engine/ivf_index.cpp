@@ -0,0 +1,425 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#include "sw/vector-engine/ivf_index.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include "sw/vector-engine/batch_scan.h"
+#include "sw/vector-engine/errors.h"
+#include "sw/vector-engine/kmeans.h"
+#include "sw/vector-engine/logger.h"
+#include "sw/vector-engine/parallel.h"
+
+namespace sw::vengine {
+
+IvfIndex::IvfIndex(const IndexOptions &opts, std::size_t dim, Metric metric) :
+    _opts(opts),
+    _dim(dim),
+    _metric(metric),
+    _distance(distance_func(metric)),
+    _lists(1),
+    _nlist(opts.nlist),
+    _nprobe(opts.nprobe) {
+    if (_nlist == 0) {
+        throw Error("NLIST of IVF must larger than 0");
+    }
+
+    if (_nprobe == 0) {
+        throw Error("NPROBE of IVF must larger than 0");
+    }
+
+    _train_size = saturated_mul(_nlist, MIN_TRAIN_POINTS_PER_LIST);
+}
+
+void IvfIndex::add(VectorId id, const float *vec) {
+    assert(vec != nullptr);
+
+    if (id >= _locations.size()) {
+        _locations.resize(static_cast<std::size_t>(id) + 1);
+    }
+
+    if (_training) {
+        _changed.push_back(id);
+    }
+
+    if (_locations[id].list != NO_LIST) {
+        // Vector has been updated, and might belong to another list.
+        _erase(id);
+    }
+
+    if (!trained()) {
+        // The collection trains the index with `start_training` once there're enough vectors.
+        _append(0, id, reinterpret_cast<const uint8_t*>(vec));
+        return;
+    }
+
+    auto list = _assign(vec);
+    std::vector<uint8_t> code(_code_size());
+    _encode(list, vec, code.data());
+    _append(list, id, code.data());
+}
+
+void IvfIndex::remove(VectorId id) {
+    assert(id < _locations.size() && _locations[id].list != NO_LIST);
+
+    if (_training) {
+        _changed.push_back(id);
+    }
+
+    _erase(id);
+}
+
+std::vector<Neighbor> IvfIndex::search(const float *query, const SearchOptions &opts) const {
+    assert(query != nullptr);
+
+    if (opts.k == 0) {
+        return {};
+    }
+
+    NeighborHeap heap;
+    if (!trained()) {
+        const auto &list = _lists.front();
+        const auto *vec = reinterpret_cast<const float*>(list.codes.data());
+        for (auto id : list.ids) {
+            if (matches(opts.filter, id)) {
+                push_neighbor(heap, opts.k, _distance(query, vec, _dim), id);
+            }
+            vec += _dim;
+        }
+
+        return sorted_neighbors(heap);
+    }
+
+    auto probes = _probe(query, opts);
+
+    // Each range of lists has about PARALLEL_GRAIN vectors.
+    std::size_t total = 0;
+    for (auto list : probes) {
+        total += _lists[list].ids.size();
+    }
+    auto grain = total == 0 ? probes.size() : (probes.size() * PARALLEL_GRAIN + total - 1) / total;
+
+    std::mutex mutex;
+    adaptive_parallel_for(probes.size(), grain,
+            [this, query, &opts, &probes, &heap, &mutex](std::size_t begin, std::size_t end) {
+                NeighborHeap local;
+                for (auto idx = begin; idx != end; ++idx) {
+                    _scan(probes[idx], query, opts.k, opts.filter, local);
+                }
+
+                std::lock_guard<std::mutex> lock(mutex);
+
+                merge_neighbors(heap, opts.k, local);
+            });
+
+    return sorted_neighbors(heap);
+}
+
+std::vector<std::size_t> IvfIndex::_probe(const float *query, const SearchOptions &opts) const {
+    assert(trained());
+
+    std::vector<std::pair<float, std::size_t>> lists(_lists.size());
+    for (std::size_t idx = 0; idx != lists.size(); ++idx) {
+        lists[idx] = {_distance(query, _centroid(idx), _dim), idx};
+    }
+
+    auto nprobe = std::min(opts.nprobe == 0 ? _nprobe : opts.nprobe, lists.size());
+    std::partial_sort(lists.begin(), lists.begin() + nprobe, lists.end());
+
+    std::vector<std::size_t> probes(nprobe);
+    for (std::size_t idx = 0; idx != nprobe; ++idx) {
+        probes[idx] = lists[idx].second;
+    }
+
+    return probes;
+}
+
+std::size_t IvfIndex::memory_usage() const {
+    auto usage = _centroids.capacity() * sizeof(float);
+    usage += _locations.capacity() * sizeof(Location);
+    usage += _lists.capacity() * sizeof(InvertedList);
+    for (const auto &list : _lists) {
+        usage += list.ids.capacity() * sizeof(VectorId) + list.codes.capacity();
+    }
+
+    return usage;
+}
+
+void IvfIndex::reconstruct(VectorId id, float *vec) const {
+    assert(id < _locations.size() && _locations[id].list != NO_LIST);
+
+    const auto &location = _locations[id];
+    const auto &list = _lists[location.list];
+    if (!trained()) {
+        const auto *raw = reinterpret_cast<const float*>(list.codes.data()) + location.offset * _dim;
+        std::copy(raw, raw + _dim, vec);
+        return;
+    }
+
+    _decode(location.list, list.codes.data() + location.offset * _code_size(), vec);
+}
+
+std::unique_ptr<Index> IvfIndex::start_training() {
+    if (trained() || _training || _size < _train_size) {
+        return nullptr;
+    }
+
+    // Copying raw vectors is much cheaper than k-means and encoding them.
+    auto copy = _clone_empty();
+    copy->_lists.front() = _lists.front();
+    copy->_locations = _locations;
+    copy->_size = _size;
+
+    _training = true;
+    _changed.clear();
+
+    return copy;
+}
+
+void IvfIndex::train() {
+    _train();
+}
+
+void IvfIndex::finish_training(Index *trained) {
+    assert(_training);
+
+    _training = false;
+    auto changed = std::move(_changed);
+    _changed.clear();
+
+    if (trained == nullptr) {
+        // Training failed, and retry once the index has doubled.
+        _train_size = std::max(_train_size, saturated_mul(_size, 2));
+        return;
+    }
+
+    auto &copy = static_cast<IvfIndex&>(*trained);
+    assert(copy.trained());
+
+    // Vectors are still raw in the single list of this index.
+    const auto &all = _lists.front();
+    for (auto id : changed) {
+        if (id < _locations.size() && _locations[id].list != NO_LIST) {
+            const auto *vec = reinterpret_cast<const float*>(all.codes.data())
+                + static_cast<std::size_t>(_locations[id].offset) * _dim;
+            copy.add(id, vec);
+        } else if (id < copy._locations.size() && copy._locations[id].list != NO_LIST) {
+            copy.remove(id);
+        }
+    }
+}
+
+void IvfIndex::_train() {
+    assert(!trained() && _lists.size() == 1);
+
+    auto all = std::move(_lists.front());
+    const auto *raw = reinterpret_cast<const float*>(all.codes.data());
+    auto num = all.ids.size();
+
+    // Sample training set, which is already contiguous in the list.
+    std::mt19937_64 rng(num);
+    auto sample_size = std::min(num, saturated_mul(_nlist, MAX_TRAIN_POINTS_PER_LIST));
+    std::vector<float> sample;
+    const float *data = raw;
+    if (sample_size < num) {
+        std::vector<std::size_t> indexes(num);
+        std::iota(indexes.begin(), indexes.end(), 0);
+        std::shuffle(indexes.begin(), indexes.end(), rng);
+
+        sample.resize(sample_size * _dim);
+        for (std::size_t idx = 0; idx != sample_size; ++idx) {
+            const auto *vec = raw + indexes[idx] * _dim;
+            std::copy(vec, vec + _dim, sample.data() + idx * _dim);
+        }
+        data = sample.data();
+    }
+
+    KMeansOptions opts;
+    opts.k = _nlist;
+    opts.seed = rng();
+    _centroids = kmeans(data, sample_size, _dim, _dim, _metric, opts);
+    _lists = std::vector<InvertedList>(_centroids.size() / _dim);
+
+    std::vector<std::size_t> sample_assignments(sample_size);
+    parallel_for(sample_size, [&](std::size_t begin, std::size_t end) {
+                for (auto idx = begin; idx != end; ++idx) {
+                    sample_assignments[idx] = _assign(data + idx * _dim);
+                }
+            });
+
+    _train_codec(data, sample_size, sample_assignments);
+
+    // Assign and encode all vectors in parallel, and then move them into lists.
+    auto code_size = _code_size();
+    std::vector<std::size_t> assignments(num);
+    std::vector<uint8_t> codes(num * code_size);
+    parallel_for(num, [&](std::size_t begin, std::size_t end) {
+                for (auto idx = begin; idx != end; ++idx) {
+                    const auto *vec = raw + idx * _dim;
+                    assignments[idx] = _assign(vec);
+                    _encode(assignments[idx], vec, codes.data() + idx * code_size);
+                }
+            });
+
+    _size = 0;
+    for (std::size_t idx = 0; idx != num; ++idx) {
+        _locations[all.ids[idx]].list = NO_LIST;
+        _append(assignments[idx], all.ids[idx], codes.data() + idx * code_size);
+    }
+
+    VECTOR_ENGINE_INFO("trained IVF with {} lists on {} of {} vectors",
+            _lists.size(), sample_size, num);
+}
+
+std::size_t IvfIndex::_assign(const float *vec) const {
+    assert(trained());
+
+    return nearest_centroid(vec, _centroids.data(), _centroids.size() / _dim, _dim, _distance).first;
+}
+
+void IvfIndex::_append(std::size_t list, VectorId id, const uint8_t *code) {
+    assert(list < _lists.size() && id < _locations.size());
+
+    auto &inverted_list = _lists[list];
+    auto &location = _locations[id];
+    location.list = static_cast<uint32_t>(list);
+    location.offset = static_cast<uint32_t>(inverted_list.ids.size());
+
+    auto code_size = trained() ? _code_size() : _dim * sizeof(float);
+    inverted_list.ids.push_back(id);
+    inverted_list.codes.insert(inverted_list.codes.end(), code, code + code_size);
+
+    if (trained()) {
+        _code_updated(list, location.offset);
+    }
+
+    ++_size;
+}
+
+void IvfIndex::_erase(VectorId id) {
+    auto &location = _locations[id];
+    assert(location.list < _lists.size());
+
+    // Move the last one to the erased position, so that the list stays contiguous.
+    auto &list = _lists[location.list];
+    auto code_size = trained() ? _code_size() : _dim * sizeof(float);
+    auto last = list.ids.size() - 1;
+    if (location.offset != last) {
+        auto moved = list.ids[last];
+        list.ids[location.offset] = moved;
+        std::copy(list.codes.begin() + last * code_size,
+                list.codes.end(),
+                list.codes.begin() + location.offset * code_size);
+        _locations[moved].offset = location.offset;
+
+        if (trained()) {
+            _code_updated(location.list, location.offset);
+        }
+    }
+
+    list.ids.pop_back();
+    list.codes.resize(last * code_size);
+
+    if (trained()) {
+        _list_shrunk(location.list, last);
+    }
+
+    location.list = NO_LIST;
+    --_size;
+}
+
+void IvfFlatIndex::_encode(std::size_t /*list*/, const float *vec, uint8_t *code) const {
+    std::memcpy(code, vec, _code_size());
+}
+
+void IvfFlatIndex::_decode(std::size_t /*list*/, const uint8_t *code, float *vec) const {
+    std::memcpy(vec, code, _code_size());
+}
+
+void IvfFlatIndex::_scan(std::size_t list,
+                            const float *query,
+                            std::size_t k,
+                            const Bitmap *filter,
+                            NeighborHeap &heap) const {
+    const auto &inverted_list = _lists[list];
+    const auto *vec = reinterpret_cast<const float*>(inverted_list.codes.data());
+    for (auto id : inverted_list.ids) {
+        if (matches(filter, id)) {
+            push_neighbor(heap, k, _distance(query, vec, _dim), id);
+        }
+        vec += _dim;
+    }
+}
+
+std::vector<std::vector<Neighbor>> IvfFlatIndex::search_batch(const std::vector<const float*> &queries,
+                                                                const std::vector<SearchOptions> &opts) const {
+    assert(queries.size() == opts.size());
+
+    if (queries.size() < 2 || !trained()) {
+        return IvfIndex::search_batch(queries, opts);
+    }
+
+    // list -> queries which probe it.
+    std::vector<std::vector<std::size_t>> probers(_lists.size());
+    for (std::size_t idx = 0; idx != queries.size(); ++idx) {
+        if (opts[idx].k == 0) {
+            continue;
+        }
+
+        for (auto list : _probe(queries[idx], opts[idx])) {
+            probers[list].push_back(idx);
+        }
+    }
+
+    std::vector<NeighborHeap> heaps(queries.size());
+    std::vector<float> matrix;
+    for (std::size_t list = 0; list != _lists.size(); ++list) {
+        const auto &members = probers[list];
+        const auto &inverted_list = _lists[list];
+        if (members.empty() || inverted_list.ids.empty()) {
+            continue;
+        }
+
+        matrix.resize(members.size() * _dim);
+        for (std::size_t idx = 0; idx != members.size(); ++idx) {
+            std::copy_n(queries[members[idx]], _dim, matrix.data() + idx * _dim);
+        }
+
+        BatchScanner scanner(_metric, matrix.data(), members.size(), _dim, _dim);
+        scanner.scan(reinterpret_cast<const float*>(inverted_list.codes.data()), inverted_list.ids.size(),
+                [&](std::size_t query, std::size_t offset, float dist) {
+                    auto member = members[query];
+                    auto id = inverted_list.ids[offset];
+                    if (matches(opts[member].filter, id)) {
+                        push_neighbor(heaps[member], opts[member].k, dist, id);
+                    }
+                });
+    }
+
+    std::vector<std::vector<Neighbor>> results;
+    results.reserve(heaps.size());
+    for (auto &heap : heaps) {
+        results.push_back(sorted_neighbors(heap));
+    }
+
+    return results;
+}
+
+}
@@ -0,0 +1,200 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#ifndef SW_VECTOR_ENGINE_IVF_INDEX_H
+#define SW_VECTOR_ENGINE_IVF_INDEX_H
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "sw/vector-engine/index.h"
+
+namespace sw::vengine {
+
+// Base of inverted file indexes: vectors are partitioned by their nearest centroid
+// of a coarse quantizer, and a search only scans lists of the `nprobe` nearest
+// centroids. Each list keeps fixed-size codes of its vectors contiguously, and
+// subclasses define how vectors are encoded.
+// The quantizer is trained by k-means once there're enough vectors. Before that,
+// raw vectors are kept in a single list, and searched exhaustively. Training runs
+// on a copy of the index, so that the collection is not blocked meanwhile.
+// Probed lists of a large search are split into ranges scanned by idle workers.
+class IvfIndex : public Index {
+public:
+    virtual void add(VectorId id, const float *vec) override;
+
+    virtual void remove(VectorId id) override;
+
+    virtual std::vector<Neighbor> search(const float *query, const SearchOptions &opts) const override;
+
+    virtual std::size_t memory_usage() const override;
+
+    virtual void reconstruct(VectorId id, float *vec) const override;
+
+    virtual std::unique_ptr<Index> start_training() override;
+
+    virtual void train() override;
+
+    virtual void finish_training(Index *trained) override;
+
+    bool trained() const noexcept {
+        return !_centroids.empty();
+    }
+
+protected:
+    IvfIndex(const IndexOptions &opts, std::size_t dim, Metric metric);
+
+    struct InvertedList {
+        std::vector<VectorId> ids;
+
+        // ids.size() codes, and each has `_code_size()` bytes, or raw floats
+        // if the index has not been trained.
+        std::vector<uint8_t> codes;
+    };
+
+    const float* _centroid(std::size_t list) const noexcept {
+        return _centroids.data() + list * _dim;
+    }
+
+    // @return lists of the nearest centroids to scan for `query` in a trained index.
+    std::vector<std::size_t> _probe(const float *query, const SearchOptions &opts) const;
+
+    // An empty index with the same options, which is trained on a copy of this one.
+    virtual std::unique_ptr<IvfIndex> _clone_empty() const = 0;
+
+    // Bytes of the code of a vector in a trained index.
+    virtual std::size_t _code_size() const noexcept = 0;
+
+    // Called after the coarse quantizer has been trained, e.g. to train codebooks.
+    // `assignments` are lists of the `num` sample vectors.
+    virtual void _train_codec(const float * /*sample*/,
+                                std::size_t /*num*/,
+                                const std::vector<std::size_t> & /*assignments*/) {}
+
+    virtual void _encode(std::size_t list, const float *vec, uint8_t *code) const = 0;
+
+    // Called after the code at `offset` of `list` has been written, and after `list`
+    // has been shrunk to `size` codes, so that subclasses can keep another layout in sync.
+    virtual void _code_updated(std::size_t /*list*/, std::size_t /*offset*/) {}
+
+    virtual void _list_shrunk(std::size_t /*list*/, std::size_t /*size*/) {}
+
+    virtual void _decode(std::size_t list, const uint8_t *code, float *vec) const = 0;
+
+    // Push vectors in the list and in `filter` into `heap`, which keeps at most `k` neighbors.
+    virtual void _scan(std::size_t list,
+                        const float *query,
+                        std::size_t k,
+                        const Bitmap *filter,
+                        NeighborHeap &heap) const = 0;
+
+    IndexOptions _opts;
+
+    std::size_t _dim;
+
+    Metric _metric;
+
+    DistanceFunc _distance;
+
+    std::vector<InvertedList> _lists;
+
+private:
+    // Train when there're at least so many vectors per list, and sample at most
+    // so many vectors per list for training.
+    static constexpr std::size_t MIN_TRAIN_POINTS_PER_LIST = 39;
+    static constexpr std::size_t MAX_TRAIN_POINTS_PER_LIST = 256;
+
+    static constexpr uint32_t NO_LIST = std::numeric_limits<uint32_t>::max();
+
+    // Min number of vectors scanned by a worker.
+    static constexpr std::size_t PARALLEL_GRAIN = 32768;
+
+    struct Location {
+        uint32_t list = NO_LIST;
+
+        uint32_t offset = 0;
+    };
+
+    void _train();
+
+    std::size_t _assign(const float *vec) const;
+
+    void _append(std::size_t list, VectorId id, const uint8_t *code);
+
+    void _erase(VectorId id);
+
+    std::size_t _nlist;
+
+    std::size_t _nprobe;
+
+    // Packed `dim` floats for each centroid, and empty if not trained.
+    std::vector<float> _centroids;
+
+    // id -> location in lists.
+    std::vector<Location> _locations;
+
+    std::size_t _size = 0;
+
+    // Training starts once there're so many vectors. It's doubled after a failed
+    // training, so that the following adds do not copy and retrain every time.
+    std::size_t _train_size;
+
+    // Whether a copy of the index is being trained.
+    bool _training = false;
+
+    // Ids added, updated or removed since the copy was taken, which might repeat.
+    std::vector<VectorId> _changed;
+};
+
+// Lists keep raw vectors, so the collection does not need another copy.
+// A batch of queries is searched list by list: queries probing the same list are
+// scanned together with a blocked GEMM kernel, so that each list is loaded once.
+class IvfFlatIndex : public IvfIndex {
+public:
+    IvfFlatIndex(const IndexOptions &opts, std::size_t dim, Metric metric) :
+        IvfIndex(opts, dim, metric) {}
+
+    virtual std::vector<std::vector<Neighbor>> search_batch(const std::vector<const float*> &queries,
+                                                            const std::vector<SearchOptions> &opts) const override;
+
+    virtual bool needs_raw_vectors() const noexcept override {
+        return false;
+    }
+
+protected:
+    virtual std::unique_ptr<IvfIndex> _clone_empty() const override {
+        return std::make_unique<IvfFlatIndex>(_opts, _dim, _metric);
+    }
+
+    virtual std::size_t _code_size() const noexcept override {
+        return _dim * sizeof(float);
+    }
+
+    virtual void _encode(std::size_t list, const float *vec, uint8_t *code) const override;
+
+    virtual void _decode(std::size_t list, const uint8_t *code, float *vec) const override;
+
+    virtual void _scan(std::size_t list,
+                        const float *query,
+                        std::size_t k,
+                        const Bitmap *filter,
+                        NeighborHeap &heap) const override;
+};
+
+}
+
+#endif // end SW_VECTOR_ENGINE_IVF_INDEX_H
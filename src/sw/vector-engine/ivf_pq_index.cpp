@@ -0,0 +1,349 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#include "sw/vector-engine/ivf_pq_index.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <queue>
+#include "sw/vector-engine/errors.h"
+#include "sw/vector-engine/kmeans.h"
+#include "sw/vector-engine/parallel.h"
+#include "sw/vector-engine/pq_fast_scan.h"
+
+namespace sw::vengine {
+
+namespace {
+
+void normalize(const float *vec, std::size_t dim, float *out) {
+    float norm = 0;
+    for (std::size_t i = 0; i != dim; ++i) {
+        norm += vec[i] * vec[i];
+    }
+
+    auto scale = norm > 0 ? 1.0f / std::sqrt(norm) : 0.0f;
+    for (std::size_t i = 0; i != dim; ++i) {
+        out[i] = vec[i] * scale;
+    }
+}
+
+float dot(const float *a, const float *b, std::size_t dim) {
+    float sum = 0;
+    for (std::size_t i = 0; i != dim; ++i) {
+        sum += a[i] * b[i];
+    }
+
+    return sum;
+}
+
+}
+
+IvfPqIndex::IvfPqIndex(const IndexOptions &opts, const VectorStorage &storage, Metric metric) :
+    IvfIndex(opts, storage.dim(), metric),
+    _storage(storage),
+    _l2(distance_func(Metric::L2)),
+    _m(opts.pq_m),
+    _bits(opts.pq_bits),
+    _ksub(0),
+    _dsub(0),
+    _rerank(opts.rerank) {
+    if (_m == 0 || _dim % _m != 0) {
+        throw Error("PQ_M must divide the dimension " + std::to_string(_dim));
+    }
+
+    if (_bits != 8 && _bits != 4) {
+        throw Error("PQ_BITS must be 8 or 4");
+    }
+
+    if (_bits == 4 && _m % 2 != 0) {
+        throw Error("PQ_M must be even with 4-bit codes");
+    }
+
+    _ksub = std::size_t(1) << _bits;
+    _dsub = _dim / _m;
+}
+
+std::vector<Neighbor> IvfPqIndex::search(const float *query, const SearchOptions &opts) const {
+    if (_rerank == 0 || !trained()) {
+        // Untrained index keeps raw vectors, which are already exact.
+        return IvfIndex::search(query, opts);
+    }
+
+    auto candidate_opts = opts;
+    candidate_opts.k = saturated_mul(opts.k, _rerank);
+    auto candidates = IvfIndex::search(query, candidate_opts);
+    for (auto &candidate : candidates) {
+        candidate.first = _distance(query, _storage.data(candidate.second), _dim);
+    }
+
+    auto k = std::min(opts.k, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + k, candidates.end());
+    candidates.resize(k);
+
+    return candidates;
+}
+
+void IvfPqIndex::_train_codec(const float *sample,
+                                std::size_t num,
+                                const std::vector<std::size_t> &assignments) {
+    assert(assignments.size() == num);
+
+    if (_metric == Metric::COSINE) {
+        _unit_centroids.resize(_lists.size() * _dim);
+        for (std::size_t list = 0; list != _lists.size(); ++list) {
+            normalize(_centroid(list), _dim, _unit_centroids.data() + list * _dim);
+        }
+    }
+
+    std::vector<float> residuals(num * _dim);
+    parallel_for(num, [&](std::size_t begin, std::size_t end) {
+                for (auto idx = begin; idx != end; ++idx) {
+                    _residual(assignments[idx], sample + idx * _dim, residuals.data() + idx * _dim);
+                }
+            });
+
+    if (_bits == 4) {
+        _blocks.assign(_lists.size(), {});
+    }
+
+    _codebooks.assign(_m * _ksub * _dsub, 0.0f);
+    for (std::size_t sub = 0; sub != _m; ++sub) {
+        KMeansOptions opts;
+        opts.k = _ksub;
+        opts.max_iterations = 10;
+        opts.seed = sub;
+        auto centroids = kmeans(residuals.data() + sub * _dsub, num, _dsub, _dim, Metric::L2, opts);
+
+        // If there're fewer samples than codewords, duplicate centroids for the rest.
+        auto *codebook = _codebooks.data() + sub * _ksub * _dsub;
+        for (std::size_t code = 0; code != _ksub; ++code) {
+            const auto *centroid = centroids.data() + (code * _dsub) % centroids.size();
+            std::copy(centroid, centroid + _dsub, codebook + code * _dsub);
+        }
+    }
+}
+
+void IvfPqIndex::_encode(std::size_t list, const float *vec, uint8_t *code) const {
+    std::vector<float> residual(_dim);
+    _residual(list, vec, residual.data());
+
+    std::fill(code, code + _code_size(), 0);
+    for (std::size_t sub = 0; sub != _m; ++sub) {
+        auto nearest = nearest_centroid(residual.data() + sub * _dsub,
+                _codeword(sub, 0), _ksub, _dsub, _l2).first;
+        if (_bits == 8) {
+            code[sub] = static_cast<uint8_t>(nearest);
+        } else {
+            code[sub / 2] |= static_cast<uint8_t>(nearest << (sub % 2 * 4));
+        }
+    }
+}
+
+void IvfPqIndex::_code_updated(std::size_t list, std::size_t offset) {
+    if (_bits != 4) {
+        return;
+    }
+
+    auto block_size = fast_scan_block_size(_m);
+    auto &blocks = _blocks[list];
+    auto begin = offset / FAST_SCAN_BLOCK * block_size;
+    if (blocks.size() < begin + block_size) {
+        blocks.resize(begin + block_size, 0);
+    }
+
+    const auto *code = _lists[list].codes.data() + offset * _code_size();
+    for (std::size_t sub = 0; sub != _m; ++sub) {
+        fast_scan_set_code(blocks.data() + begin, offset % FAST_SCAN_BLOCK,
+                sub, static_cast<uint8_t>(_code(code, sub)));
+    }
+}
+
+void IvfPqIndex::_list_shrunk(std::size_t list, std::size_t size) {
+    if (_bits != 4) {
+        return;
+    }
+
+    auto num_blocks = (size + FAST_SCAN_BLOCK - 1) / FAST_SCAN_BLOCK;
+    _blocks[list].resize(num_blocks * fast_scan_block_size(_m));
+}
+
+void IvfPqIndex::_decode(std::size_t list, const uint8_t *code, float *vec) const {
+    const auto *centroid = _base_centroid(list);
+    for (std::size_t sub = 0; sub != _m; ++sub) {
+        const auto *codeword = _codeword(sub, _code(code, sub));
+        for (std::size_t i = 0; i != _dsub; ++i) {
+            vec[sub * _dsub + i] = centroid[sub * _dsub + i] + codeword[i];
+        }
+    }
+}
+
+void IvfPqIndex::_scan(std::size_t list,
+                        const float *query,
+                        std::size_t k,
+                        const Bitmap *filter,
+                        NeighborHeap &heap) const {
+    const auto &inverted_list = _lists[list];
+    if (inverted_list.ids.empty()) {
+        return;
+    }
+
+    std::vector<float> lut(_m * _ksub);
+    auto base = _build_lut(list, query, lut.data());
+
+    if (_bits == 4) {
+        _fast_scan(list, lut.data(), base, k, filter, heap);
+        return;
+    }
+
+    const auto *code = inverted_list.codes.data();
+    for (auto id : inverted_list.ids) {
+        if (matches(filter, id)) {
+            push_neighbor(heap, k, base + _adc(lut.data(), code), id);
+        }
+        code += _m;
+    }
+}
+
+float IvfPqIndex::_build_lut(std::size_t list, const float *query, float *lut) const {
+    float base = 0;
+    if (_metric == Metric::L2) {
+        // |q - c - r|^2 = sum of |(q - c)_sub - r_sub|^2
+        std::vector<float> residual(_dim);
+        _residual(list, query, residual.data());
+        for (std::size_t sub = 0; sub != _m; ++sub) {
+            for (std::size_t code = 0; code != _ksub; ++code) {
+                lut[sub * _ksub + code] = _l2(residual.data() + sub * _dsub, _codeword(sub, code), _dsub);
+            }
+        }
+    } else {
+        // -<q, c + r> = -<q, c> - sum of <q_sub, r_sub>, and COSINE is 1 - <q, c + r>
+        // with normalized vectors.
+        std::vector<float> normalized;
+        const auto *q = query;
+        if (_metric == Metric::COSINE) {
+            normalized.resize(_dim);
+            normalize(query, _dim, normalized.data());
+            q = normalized.data();
+            base = 1;
+        }
+
+        base -= dot(q, _base_centroid(list), _dim);
+        for (std::size_t sub = 0; sub != _m; ++sub) {
+            for (std::size_t code = 0; code != _ksub; ++code) {
+                lut[sub * _ksub + code] = -dot(q + sub * _dsub, _codeword(sub, code), _dsub);
+            }
+        }
+    }
+
+    return base;
+}
+
+float IvfPqIndex::_adc(const float *lut, const uint8_t *code) const noexcept {
+    float dist = 0;
+    if (_bits == 8) {
+        std::size_t sub = 0;
+        for (; sub + 4 <= _m; sub += 4) {
+            dist += lut[sub * _ksub + code[sub]]
+                + lut[(sub + 1) * _ksub + code[sub + 1]]
+                + lut[(sub + 2) * _ksub + code[sub + 2]]
+                + lut[(sub + 3) * _ksub + code[sub + 3]];
+        }
+        for (; sub != _m; ++sub) {
+            dist += lut[sub * _ksub + code[sub]];
+        }
+    } else {
+        for (std::size_t sub = 0; sub != _m; sub += 2) {
+            dist += lut[sub * 16 + (code[sub / 2] & 0x0F)]
+                + lut[(sub + 1) * 16 + (code[sub / 2] >> 4)];
+        }
+    }
+
+    return dist;
+}
+
+void IvfPqIndex::_fast_scan(std::size_t list,
+                            const float *lut,
+                            float base,
+                            std::size_t k,
+                            const Bitmap *filter,
+                            NeighborHeap &heap) const {
+    const auto &inverted_list = _lists[list];
+    auto size = inverted_list.ids.size();
+
+    // Quantize the lookup table to uint8 with a shared scale, and per sub-quantizer
+    // offsets, so that sums of quantized entries keep the order of distances.
+    float scale = 0;
+    for (std::size_t sub = 0; sub != _m; ++sub) {
+        const auto *table = lut + sub * 16;
+        auto [min, max] = std::minmax_element(table, table + 16);
+        scale = std::max(scale, *max - *min);
+    }
+    scale = scale > 0 ? 255.0f / scale : 0.0f;
+
+    std::vector<uint8_t> qlut(_m * 16);
+    for (std::size_t sub = 0; sub != _m; ++sub) {
+        const auto *table = lut + sub * 16;
+        auto min = *std::min_element(table, table + 16);
+        for (std::size_t code = 0; code != 16; ++code) {
+            auto q = std::lround((table[code] - min) * scale);
+            qlut[sub * 16 + code] = static_cast<uint8_t>(std::min<long>(q, 255));
+        }
+    }
+
+    auto num_blocks = (size + FAST_SCAN_BLOCK - 1) / FAST_SCAN_BLOCK;
+    std::vector<uint32_t> dists(num_blocks * FAST_SCAN_BLOCK);
+    fast_scan(_blocks[list].data(), num_blocks, qlut.data(), _m, dists.data());
+
+    // Keep the best candidates by quantized distance, i.e. max heap of (dist, offset).
+    auto num_candidates = std::min(size, k * FAST_SCAN_REFINE);
+    std::priority_queue<std::pair<uint32_t, std::size_t>> candidates;
+    for (std::size_t offset = 0; offset != size; ++offset) {
+        if (!matches(filter, inverted_list.ids[offset])) {
+            continue;
+        }
+
+        if (candidates.size() < num_candidates) {
+            candidates.emplace(dists[offset], offset);
+        } else if (dists[offset] < candidates.top().first) {
+            candidates.pop();
+            candidates.emplace(dists[offset], offset);
+        }
+    }
+
+    auto code_size = _code_size();
+    while (!candidates.empty()) {
+        auto offset = candidates.top().second;
+        candidates.pop();
+
+        auto dist = base + _adc(lut, inverted_list.codes.data() + offset * code_size);
+        push_neighbor(heap, k, dist, inverted_list.ids[offset]);
+    }
+}
+
+void IvfPqIndex::_residual(std::size_t list, const float *vec, float *residual) const {
+    if (_metric == Metric::COSINE) {
+        normalize(vec, _dim, residual);
+    } else {
+        std::copy(vec, vec + _dim, residual);
+    }
+
+    const auto *centroid = _base_centroid(list);
+    for (std::size_t i = 0; i != _dim; ++i) {
+        residual[i] -= centroid[i];
+    }
+}
+
+}
@@ -0,0 +1,153 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#ifndef SW_VECTOR_ENGINE_IVF_PQ_INDEX_H
+#define SW_VECTOR_ENGINE_IVF_PQ_INDEX_H
+
+#include <vector>
+#include "sw/vector-engine/ivf_index.h"
+
+namespace sw::vengine {
+
+// IVF with product quantization: the residual of a vector to its list centroid
+// is split into `m` sub-vectors, and each of them is encoded as the 8-bit, or 4-bit,
+// index of its nearest codeword. A search builds a lookup table of distances between
+// the query and all codewords for each probed list, so that the distance to a
+// vector is `m` table lookups (asymmetric distance computation).
+// With 4-bit codes, lists also keep codes in the fast-scan layout (see pq_fast_scan.h),
+// and are scanned with lookup tables quantized to uint8. Candidates of the quantized
+// distances are then refined with the float lookup table.
+// For COSINE, vectors are normalized before encoding, so reconstructed vectors
+// are normalized too.
+class IvfPqIndex : public IvfIndex {
+public:
+    IvfPqIndex(const IndexOptions &opts, const VectorStorage &storage, Metric metric);
+
+    // Raw vectors are only needed for re-ranking.
+    virtual bool needs_raw_vectors() const noexcept override {
+        return _rerank > 0;
+    }
+
+    virtual std::vector<Neighbor> search(const float *query, const SearchOptions &opts) const override;
+
+    virtual std::size_t memory_usage() const override {
+        std::size_t blocks = 0;
+        for (const auto &list : _blocks) {
+            blocks += list.capacity();
+        }
+
+        return IvfIndex::memory_usage() + blocks
+            + (_codebooks.capacity() + _unit_centroids.capacity()) * sizeof(float);
+    }
+
+protected:
+    virtual std::unique_ptr<IvfIndex> _clone_empty() const override {
+        return std::make_unique<IvfPqIndex>(_opts, _storage, _metric);
+    }
+
+    virtual std::size_t _code_size() const noexcept override {
+        return _bits == 8 ? _m : _m / 2;
+    }
+
+    virtual void _train_codec(const float *sample,
+                                std::size_t num,
+                                const std::vector<std::size_t> &assignments) override;
+
+    virtual void _encode(std::size_t list, const float *vec, uint8_t *code) const override;
+
+    virtual void _code_updated(std::size_t list, std::size_t offset) override;
+
+    virtual void _list_shrunk(std::size_t list, std::size_t size) override;
+
+    virtual void _decode(std::size_t list, const uint8_t *code, float *vec) const override;
+
+    virtual void _scan(std::size_t list,
+                        const float *query,
+                        std::size_t k,
+                        const Bitmap *filter,
+                        NeighborHeap &heap) const override;
+
+private:
+    // With 4-bit codes, refine so many times of `k` candidates of each list
+    // with the float lookup table.
+    static constexpr std::size_t FAST_SCAN_REFINE = 4;
+
+    const float* _codeword(std::size_t sub, std::size_t code) const noexcept {
+        return _codebooks.data() + (sub * _ksub + code) * _dsub;
+    }
+
+    // Codeword index of sub-quantizer `sub` in `code`. 4-bit codes are packed
+    // 2 per byte, and the even sub-quantizer is in the low nibble.
+    std::size_t _code(const uint8_t *code, std::size_t sub) const noexcept {
+        if (_bits == 8) {
+            return code[sub];
+        }
+
+        return (code[sub / 2] >> (sub % 2 * 4)) & 0x0F;
+    }
+
+    // Centroid of `list` that residuals are relative to.
+    const float* _base_centroid(std::size_t list) const noexcept {
+        return _unit_centroids.empty() ? _centroid(list) : _unit_centroids.data() + list * _dim;
+    }
+
+    // Normalize `vec` for COSINE, and subtract the base centroid of `list`.
+    void _residual(std::size_t list, const float *vec, float *residual) const;
+
+    // Build the lookup table: lut[sub * ksub + code] is the distance between the query
+    // and the codeword on sub-space `sub`. @return the distance part that does not
+    // depend on codes.
+    float _build_lut(std::size_t list, const float *query, float *lut) const;
+
+    float _adc(const float *lut, const uint8_t *code) const noexcept;
+
+    void _fast_scan(std::size_t list,
+                    const float *lut,
+                    float base,
+                    std::size_t k,
+                    const Bitmap *filter,
+                    NeighborHeap &heap) const;
+
+    const VectorStorage &_storage;
+
+    DistanceFunc _l2;
+
+    std::size_t _m;
+
+    std::size_t _bits;
+
+    // Number of codewords of each sub-quantizer, i.e. 2 ^ bits.
+    std::size_t _ksub;
+
+    // Dimension of sub-vectors.
+    std::size_t _dsub;
+
+    std::size_t _rerank;
+
+    // `m` codebooks, and each has `ksub` codewords with `dsub` floats.
+    std::vector<float> _codebooks;
+
+    // 4-bit only: codes of each list in blocks of the fast-scan layout, and
+    // the last block is padded.
+    std::vector<std::vector<uint8_t>> _blocks;
+
+    // COSINE only: normalized centroids, so that residuals of normalized vectors are small.
+    std::vector<float> _unit_centroids;
+};
+
+}
+
+#endif // end SW_VECTOR_ENGINE_IVF_PQ_INDEX_H
@@ -21,15 +21,16 @@
 
 namespace sw::vengine {
 
-auto JsonRpcRequestParser::parse(std::string_view buffer) const
+auto JsonRpcRequestParser::parse(const ReadBuffer & /*buffer*/)
     -> std::pair<std::vector<TaskUPtr>, std::size_t> {
-    return std::make_pair({}, 0);
+    // Requests are not parsed yet, and bytes are kept in the buffer.
+    return {std::vector<TaskUPtr>{}, 0};
 }
 
 std::string JsonRpcResponseBuilder::build(TaskOutput *output) {
     assert(output != nullptr);
 
-    return output->to_mcp_reply();
+    return output->to_json_rpc_reply();
 }
 
 }
@@ -43,7 +43,7 @@ public:
 
 class JsonRpcRequestParser : public RequestParser {
 public:
-    virtual auto parse(std::string_view buffer) const
+    virtual auto parse(const ReadBuffer &buffer)
         -> std::pair<std::vector<std::unique_ptr<Task>>, std::size_t> override;
 };
 
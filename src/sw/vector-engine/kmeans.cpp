@@ -0,0 +1,168 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#include "sw/vector-engine/kmeans.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <limits>
+#include <random>
+#include "sw/vector-engine/errors.h"
+#include "sw/vector-engine/parallel.h"
+
+namespace sw::vengine {
+
+namespace {
+
+// Pick centroids one by one, with probability proportional to the distance
+// to the nearest centroid picked so far, which must not be negative.
+std::vector<float> init_centroids(const float *data,
+                                    std::size_t num,
+                                    std::size_t dim,
+                                    std::size_t stride,
+                                    std::size_t k,
+                                    DistanceFunc distance,
+                                    std::mt19937_64 &rng) {
+    std::vector<float> centroids;
+    centroids.reserve(k * dim);
+
+    auto pick = [&](std::size_t idx) {
+        const auto *vec = data + idx * stride;
+        centroids.insert(centroids.end(), vec, vec + dim);
+    };
+
+    pick(std::uniform_int_distribution<std::size_t>(0, num - 1)(rng));
+
+    std::vector<double> min_dists(num, std::numeric_limits<double>::max());
+    for (std::size_t c = 1; c < k; ++c) {
+        const auto *last = centroids.data() + (c - 1) * dim;
+        parallel_for(num, [&](std::size_t begin, std::size_t end) {
+                    for (auto i = begin; i != end; ++i) {
+                        // Rounding might make a COSINE distance slightly negative.
+                        double dist = std::max(0.0f, distance(data + i * stride, last, dim));
+                        min_dists[i] = std::min(min_dists[i], dist);
+                    }
+                });
+
+        if (std::all_of(min_dists.begin(), min_dists.end(), [](double d) { return d <= 0; })) {
+            // All points coincide with picked centroids.
+            pick(std::uniform_int_distribution<std::size_t>(0, num - 1)(rng));
+            continue;
+        }
+
+        std::discrete_distribution<std::size_t> dist(min_dists.begin(), min_dists.end());
+        pick(dist(rng));
+    }
+
+    return centroids;
+}
+
+}
+
+std::pair<std::size_t, float> nearest_centroid(const float *vec,
+                                                const float *centroids,
+                                                std::size_t k,
+                                                std::size_t dim,
+                                                DistanceFunc distance) {
+    assert(k > 0);
+
+    std::size_t best = 0;
+    auto best_dist = std::numeric_limits<float>::max();
+    for (std::size_t c = 0; c != k; ++c) {
+        auto dist = distance(vec, centroids + c * dim, dim);
+        if (dist < best_dist) {
+            best = c;
+            best_dist = dist;
+        }
+    }
+
+    return {best, best_dist};
+}
+
+std::vector<float> kmeans(const float *data,
+                            std::size_t num,
+                            std::size_t dim,
+                            std::size_t stride,
+                            Metric metric,
+                            const KMeansOptions &opts) {
+    if (num == 0 || opts.k == 0) {
+        throw Error("no data or no cluster for k-means");
+    }
+
+    auto k = std::min(num, opts.k);
+    auto distance = distance_func(metric);
+
+    // Negative inner products would leave most points no chance to be picked as seeds,
+    // so IP is seeded by L2, and COSINE distance is already an angular one.
+    auto seed_distance = metric == Metric::IP ? distance_func(Metric::L2) : distance;
+
+    std::mt19937_64 rng(opts.seed);
+    auto centroids = init_centroids(data, num, dim, stride, k, seed_distance, rng);
+
+    std::vector<std::size_t> assignments(num, 0);
+    std::vector<double> sums(k * dim);
+    std::vector<std::size_t> counts(k);
+    for (std::size_t iter = 0; iter != opts.max_iterations; ++iter) {
+        std::atomic<std::size_t> changed{0};
+        parallel_for(num, [&](std::size_t begin, std::size_t end) {
+                    std::size_t cnt = 0;
+                    for (auto i = begin; i != end; ++i) {
+                        auto c = nearest_centroid(data + i * stride,
+                                centroids.data(), k, dim, distance).first;
+                        if (c != assignments[i]) {
+                            assignments[i] = c;
+                            ++cnt;
+                        }
+                    }
+                    changed += cnt;
+                });
+
+        if (iter > 0 && changed == 0) {
+            break;
+        }
+
+        std::fill(sums.begin(), sums.end(), 0.0);
+        std::fill(counts.begin(), counts.end(), 0);
+        for (std::size_t i = 0; i != num; ++i) {
+            auto c = assignments[i];
+            const auto *vec = data + i * stride;
+            auto *sum = sums.data() + c * dim;
+            for (std::size_t d = 0; d != dim; ++d) {
+                sum[d] += vec[d];
+            }
+            ++counts[c];
+        }
+
+        for (std::size_t c = 0; c != k; ++c) {
+            auto *centroid = centroids.data() + c * dim;
+            if (counts[c] == 0) {
+                // Empty cluster, move it to a random point, which splits a big cluster.
+                auto idx = std::uniform_int_distribution<std::size_t>(0, num - 1)(rng);
+                std::copy(data + idx * stride, data + idx * stride + dim, centroid);
+                continue;
+            }
+
+            const auto *sum = sums.data() + c * dim;
+            for (std::size_t d = 0; d != dim; ++d) {
+                centroid[d] = static_cast<float>(sum[d] / counts[c]);
+            }
+        }
+    }
+
+    return centroids;
+}
+
+}
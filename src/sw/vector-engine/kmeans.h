@@ -0,0 +1,57 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#ifndef SW_VECTOR_ENGINE_KMEANS_H
+#define SW_VECTOR_ENGINE_KMEANS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "sw/vector-engine/distance.h"
+
+namespace sw::vengine {
+
+struct KMeansOptions {
+    // Number of clusters.
+    std::size_t k = 0;
+
+    std::size_t max_iterations = 20;
+
+    uint64_t seed = 0;
+};
+
+// Cluster `num` vectors of `dim` floats by `metric`, and vector i starts at data + i * stride.
+// Centroids are initialized with k-means++, and refined with Lloyd iterations.
+// Assignment steps run in parallel with `parallel_for`.
+// @return k centroids, packed with `dim` floats each. If num < k, only num
+//         centroids are returned.
+std::vector<float> kmeans(const float *data,
+                            std::size_t num,
+                            std::size_t dim,
+                            std::size_t stride,
+                            Metric metric,
+                            const KMeansOptions &opts);
+
+// @return index of the nearest centroid, and the distance to it.
+std::pair<std::size_t, float> nearest_centroid(const float *vec,
+                                                const float *centroids,
+                                                std::size_t k,
+                                                std::size_t dim,
+                                                DistanceFunc distance);
+
+}
+
+#endif // end SW_VECTOR_ENGINE_KMEANS_H
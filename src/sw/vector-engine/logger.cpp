@@ -30,6 +30,7 @@ void Logger::init(const LoggerOptions &opts) {
     switch (opts.level) {
     case LogLevel::DEBUG:
         level = spdlog::level::debug;
+        break;
     case LogLevel::INFO:
         level = spdlog::level::info;
         break;
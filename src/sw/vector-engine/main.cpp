@@ -1,25 +1,79 @@
 #include <iostream>
 #include <chrono>
+#include <charconv>
+#include <cstring>
 #include "sw/vector-engine/reactor.h"
 #include "sw/vector-engine/worker.h"
 #include "sw/vector-engine/logger.h"
 
-int main() {
+namespace {
+
+struct CliOptions {
+    // Number of event loops, and 0 means the number of cores.
+    std::size_t loops = 0;
+
+    // Number of workers, and 0 means the number of cores.
+    std::size_t workers = 0;
+};
+
+std::size_t parse_size(const char *arg, const std::string &name) {
+    std::size_t num = 0;
+    auto len = std::strlen(arg);
+    auto [ptr, ec] = std::from_chars(arg, arg + len, num);
+    if (ec != std::errc() || ptr != arg + len || num == 0) {
+        throw sw::vengine::Error("invalid " + name + ": " + arg);
+    }
+
+    return num;
+}
+
+// vector-engine [--loops num] [--workers num]
+CliOptions parse_cli(int argc, char *argv[]) {
+    CliOptions opts;
+    for (auto idx = 1; idx < argc; ++idx) {
+        std::string opt = argv[idx];
+        if (opt != "--loops" && opt != "--workers") {
+            throw sw::vengine::Error("unknown option: " + opt);
+        }
+
+        if (idx + 1 >= argc) {
+            throw sw::vengine::Error("expect value for " + opt);
+        }
+
+        auto num = parse_size(argv[++idx], opt);
+        if (opt == "--loops") {
+            opts.loops = num;
+        } else {
+            opts.workers = num;
+        }
+    }
+
+    return opts;
+}
+
+}
+
+int main(int argc, char *argv[]) {
     try {
+        auto cli_opts = parse_cli(argc, argv);
+
         sw::vengine::LoggerOptions logger_opts;
         sw::vengine::Logger::instance().init(logger_opts);
 
-        auto pool = std::make_shared<sw::vengine::WorkerPool>(3);
+        auto pool = std::make_shared<sw::vengine::WorkerPool>(cli_opts.workers);
         sw::vengine::ReactorOptions opts;
         opts.tcp_opts.ip = "127.0.0.1";
         opts.tcp_opts.port = 7777;
         opts.tcp_opts.backlog= 512;
         opts.tcp_opts.keepalive = std::chrono::seconds(30);
         opts.tcp_opts.nodelay = true;
-        opts.connection_opts.read_buf_min_size = 64 * 1024;
+        opts.connection_opts.read_buf_chunk_size = 64 * 1024;
         opts.connection_opts.read_buf_max_size = 20 * 1024 * 1024;
+        opts.connection_opts.read_buf_pool_size = 1024;
         opts.protocol_opts.type = sw::vengine::ProtocolType::RESP;
-        sw::vengine::Reactor reactor(opts, pool);
+        opts.reply_queue_size = 64 * 1024;
+        opts.num_loops = cli_opts.loops;
+        sw::vengine::ReactorGroup reactors(opts, pool);
 
         VECTOR_ENGINE_INFO("vector engine started");
 
@@ -29,7 +83,7 @@ int main() {
                 break;
             }
         }
-        reactor.stop();
+        reactors.stop();
     } catch (const sw::vengine::Error &err) {
         std::cerr << err.what() << std::endl;
     }
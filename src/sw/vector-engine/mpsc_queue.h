@@ -0,0 +1,149 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#ifndef SW_VECTOR_ENGINE_MPSC_QUEUE_H
+#define SW_VECTOR_ENGINE_MPSC_QUEUE_H
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "sw/vector-engine/errors.h"
+
+namespace sw::vengine {
+
+// Bounded lock-free queue with multiple producers and a single consumer.
+// Each cell carries a sequence number, which tells whether the cell is ready
+// to be written by producers or to be read by the consumer (Dmitry Vyukov's design).
+template <typename T>
+class MpscQueue {
+public:
+    // `capacity` is rounded up to a power of 2.
+    explicit MpscQueue(std::size_t capacity);
+
+    MpscQueue(const MpscQueue &) = delete;
+    MpscQueue& operator=(const MpscQueue &) = delete;
+
+    MpscQueue(MpscQueue &&) = delete;
+    MpscQueue& operator=(MpscQueue &&) = delete;
+
+    ~MpscQueue() = default;
+
+    // Can be called by multiple threads.
+    // @return false if the queue is full, and `item` is left untouched.
+    bool try_push(T &item);
+
+    // Can only be called by the consumer thread.
+    // @return false if the queue is empty.
+    bool try_pop(T &item);
+
+    // Can only be called by the consumer thread.
+    bool empty() const;
+
+    std::size_t capacity() const noexcept {
+        return _mask + 1;
+    }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> seq;
+        T data;
+    };
+
+    static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+    std::unique_ptr<Cell[]> _cells;
+
+    std::size_t _mask;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> _tail{0};
+
+    alignas(CACHE_LINE_SIZE) std::size_t _head = 0;
+};
+
+template <typename T>
+MpscQueue<T>::MpscQueue(std::size_t capacity) {
+    if (capacity == 0) {
+        throw Error("capacity of queue must larger than 0");
+    }
+
+    std::size_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+
+    _cells = std::make_unique<Cell[]>(size);
+    _mask = size - 1;
+
+    for (std::size_t idx = 0; idx != size; ++idx) {
+        _cells[idx].seq.store(idx, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+bool MpscQueue<T>::try_push(T &item) {
+    auto pos = _tail.load(std::memory_order_relaxed);
+    Cell *cell = nullptr;
+    while (true) {
+        cell = &_cells[pos & _mask];
+        auto seq = cell->seq.load(std::memory_order_acquire);
+        auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+        if (diff == 0) {
+            if (_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+            // Otherwise, `pos` has been updated with the latest tail.
+        } else if (diff < 0) {
+            // The consumer has not released this cell yet, i.e. queue is full.
+            return false;
+        } else {
+            // Another producer took this cell, retry with the latest tail.
+            pos = _tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->data = std::move(item);
+    cell->seq.store(pos + 1, std::memory_order_release);
+
+    return true;
+}
+
+template <typename T>
+bool MpscQueue<T>::try_pop(T &item) {
+    auto &cell = _cells[_head & _mask];
+    auto seq = cell.seq.load(std::memory_order_acquire);
+    if (seq != _head + 1) {
+        // Not published yet.
+        return false;
+    }
+
+    item = std::move(cell.data);
+    cell.seq.store(_head + _mask + 1, std::memory_order_release);
+    ++_head;
+
+    return true;
+}
+
+template <typename T>
+bool MpscQueue<T>::empty() const {
+    const auto &cell = _cells[_head & _mask];
+    return cell.seq.load(std::memory_order_acquire) != _head + 1;
+}
+
+}
+
+#endif // end SW_VECTOR_ENGINE_MPSC_QUEUE_H
@@ -0,0 +1,54 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#include "sw/vector-engine/parallel.h"
+#include "sw/vector-engine/worker.h"
+
+namespace sw::vengine {
+
+void parallel_for(std::size_t num, const std::function<void (std::size_t, std::size_t)> &fn) {
+    auto *pool = WorkerPool::current();
+    if (pool == nullptr) {
+        fn(0, num);
+        return;
+    }
+
+    pool->parallel_for(num, fn);
+}
+
+void adaptive_parallel_for(std::size_t num,
+                            std::size_t grain,
+                            const std::function<void (std::size_t, std::size_t)> &fn) {
+    auto *pool = WorkerPool::current();
+    if (pool == nullptr) {
+        fn(0, num);
+        return;
+    }
+
+    pool->adaptive_parallel_for(num, grain, fn);
+}
+
+void post(std::function<void ()> job) {
+    auto *pool = WorkerPool::current();
+    if (pool == nullptr) {
+        job();
+        return;
+    }
+
+    pool->post(std::move(job));
+}
+
+}
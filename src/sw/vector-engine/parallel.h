@@ -0,0 +1,42 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#ifndef SW_VECTOR_ENGINE_PARALLEL_H
+#define SW_VECTOR_ENGINE_PARALLEL_H
+
+#include <cstddef>
+#include <functional>
+
+namespace sw::vengine {
+
+// Call `fn(begin, end)` on sub-ranges of [0, num). If it's called by a worker,
+// ranges are run by the worker pool in parallel, otherwise, by the calling thread.
+// So that data structures, e.g. indexes, can use workers without knowing the pool.
+void parallel_for(std::size_t num, const std::function<void (std::size_t, std::size_t)> &fn);
+
+// Same as `parallel_for`, but fan out only to idle workers, and each range has at
+// least `grain` items, e.g. to split the scan of a single search.
+void adaptive_parallel_for(std::size_t num,
+                            std::size_t grain,
+                            const std::function<void (std::size_t, std::size_t)> &fn);
+
+// Queue `job` to the worker pool and return without waiting for it, if it's called
+// by a worker, otherwise, run it by the calling thread. The job must not throw.
+void post(std::function<void ()> job);
+
+}
+
+#endif // end SW_VECTOR_ENGINE_PARALLEL_H
@@ -29,4 +29,8 @@ RespReply PingTaskOutput::to_resp_reply() {
     return builder.data();
 }
 
+JsonRpcReply PingTaskOutput::to_json_rpc_reply() {
+    return nlohmann::json{{"result", "PONG"}}.dump();
+}
+
 }
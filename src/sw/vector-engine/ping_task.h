@@ -28,12 +28,20 @@ public:
 
     virtual void from_resp_command(RespCommand /*cmd*/) override {}
 
+    virtual void from_json_rpc_request(JsonRpcRequest /*req*/) override {}
+
     virtual TaskOutputUPtr run() override;
+
+    virtual bool read_only() const override {
+        return true;
+    }
 };
 
 class PingTaskOutput : public TaskOutput {
 public:
     virtual RespReply to_resp_reply() override;
+
+    virtual JsonRpcReply to_json_rpc_reply() override;
 };
 
 }
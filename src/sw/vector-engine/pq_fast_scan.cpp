@@ -0,0 +1,194 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#include "sw/vector-engine/pq_fast_scan.h"
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define VECTOR_ENGINE_X86 1
+#include <immintrin.h>
+#endif
+
+namespace sw::vengine {
+
+namespace {
+
+// Max number of sub-quantizers whose uint8 distances can be summed in uint16.
+constexpr std::size_t WIDEN_INTERVAL = 256;
+
+using detail::FastScanFunc;
+
+void fast_scan_scalar(const uint8_t *block, const uint8_t *lut, std::size_t m, uint32_t *dists) {
+    std::fill(dists, dists + FAST_SCAN_BLOCK, 0);
+    for (std::size_t sub = 0; sub != m; ++sub) {
+        const auto *codes = block + sub * 16;
+        const auto *table = lut + sub * 16;
+        for (std::size_t i = 0; i != 16; ++i) {
+            dists[i] += table[codes[i] & 0x0F];
+            dists[i + 16] += table[codes[i] >> 4];
+        }
+    }
+}
+
+#ifdef VECTOR_ENGINE_X86
+
+__attribute__((target("avx2")))
+void widen_avx2(__m256i acc, uint32_t *dists) {
+    auto lo = _mm256_cvtepu16_epi32(_mm256_castsi256_si128(acc));
+    auto hi = _mm256_cvtepu16_epi32(_mm256_extracti128_si256(acc, 1));
+    auto *out = reinterpret_cast<__m256i*>(dists);
+    _mm256_storeu_si256(out, _mm256_add_epi32(_mm256_loadu_si256(out), lo));
+    _mm256_storeu_si256(out + 1, _mm256_add_epi32(_mm256_loadu_si256(out + 1), hi));
+}
+
+// A 256-bit register holds codes, or lookup tables, of 2 sub-quantizers.
+__attribute__((target("avx2")))
+void fast_scan_avx2(const uint8_t *block, const uint8_t *lut, std::size_t m, uint32_t *dists) {
+    std::fill(dists, dists + FAST_SCAN_BLOCK, 0);
+
+    auto mask = _mm256_set1_epi8(0x0F);
+    for (std::size_t begin = 0; begin < m; begin += WIDEN_INTERVAL) {
+        auto end = std::min(m, begin + WIDEN_INTERVAL);
+
+        // Sums of vector 0 ~ 15, and vector 16 ~ 31.
+        auto acc_lo = _mm256_setzero_si256();
+        auto acc_hi = _mm256_setzero_si256();
+        for (auto sub = begin; sub != end; sub += 2) {
+            auto codes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + sub * 16));
+            auto table = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lut + sub * 16));
+            auto lo = _mm256_shuffle_epi8(table, _mm256_and_si256(codes, mask));
+            auto hi = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(codes, 4), mask));
+
+            acc_lo = _mm256_add_epi16(acc_lo, _mm256_cvtepu8_epi16(_mm256_castsi256_si128(lo)));
+            acc_lo = _mm256_add_epi16(acc_lo, _mm256_cvtepu8_epi16(_mm256_extracti128_si256(lo, 1)));
+            acc_hi = _mm256_add_epi16(acc_hi, _mm256_cvtepu8_epi16(_mm256_castsi256_si128(hi)));
+            acc_hi = _mm256_add_epi16(acc_hi, _mm256_cvtepu8_epi16(_mm256_extracti128_si256(hi, 1)));
+        }
+
+        widen_avx2(acc_lo, dists);
+        widen_avx2(acc_hi, dists + 16);
+    }
+}
+
+// GCC's unmasked extract and widening intrinsics merge into an undefined vector, and trip
+// -Wmaybe-uninitialized at -O3. Zero-masked forms with a full mask emit the same instructions.
+template <int HALF>
+__attribute__((target("avx512f")))
+__m256i half_avx512(__m512i v) {
+    return _mm512_maskz_extracti64x4_epi64(0xF, v, HALF);
+}
+
+__attribute__((target("avx512f")))
+__m512i cvtepu16_avx512(__m256i v) {
+    return _mm512_maskz_cvtepu16_epi32(0xFFFF, v);
+}
+
+// A 512-bit register holds 4 sub-quantizers. After widening to uint16, lane i of the
+// accumulator sums sub-quantizers of even index, and lane i + 16 sums the odd ones.
+__attribute__((target("avx512f,avx512bw")))
+void fast_scan_avx512(const uint8_t *block, const uint8_t *lut, std::size_t m, uint32_t *dists) {
+    assert(m % 4 == 0);
+
+    auto sum_lo = _mm512_setzero_si512();
+    auto sum_hi = _mm512_setzero_si512();
+    auto mask = _mm512_set1_epi8(0x0F);
+    for (std::size_t begin = 0; begin < m; begin += WIDEN_INTERVAL) {
+        auto end = std::min(m, begin + WIDEN_INTERVAL);
+
+        auto acc_lo = _mm512_setzero_si512();
+        auto acc_hi = _mm512_setzero_si512();
+        for (auto sub = begin; sub != end; sub += 4) {
+            auto codes = _mm512_loadu_si512(block + sub * 16);
+            auto table = _mm512_loadu_si512(lut + sub * 16);
+            auto lo = _mm512_shuffle_epi8(table, _mm512_and_si512(codes, mask));
+            auto hi = _mm512_shuffle_epi8(table, _mm512_and_si512(_mm512_srli_epi16(codes, 4), mask));
+
+            acc_lo = _mm512_add_epi16(acc_lo, _mm512_cvtepu8_epi16(half_avx512<0>(lo)));
+            acc_lo = _mm512_add_epi16(acc_lo, _mm512_cvtepu8_epi16(half_avx512<1>(lo)));
+            acc_hi = _mm512_add_epi16(acc_hi, _mm512_cvtepu8_epi16(half_avx512<0>(hi)));
+            acc_hi = _mm512_add_epi16(acc_hi, _mm512_cvtepu8_epi16(half_avx512<1>(hi)));
+        }
+
+        sum_lo = _mm512_add_epi32(sum_lo, cvtepu16_avx512(half_avx512<0>(acc_lo)));
+        sum_lo = _mm512_add_epi32(sum_lo, cvtepu16_avx512(half_avx512<1>(acc_lo)));
+        sum_hi = _mm512_add_epi32(sum_hi, cvtepu16_avx512(half_avx512<0>(acc_hi)));
+        sum_hi = _mm512_add_epi32(sum_hi, cvtepu16_avx512(half_avx512<1>(acc_hi)));
+    }
+
+    _mm512_storeu_si512(dists, sum_lo);
+    _mm512_storeu_si512(dists + 16, sum_hi);
+}
+
+#endif
+
+// @return kernels of instruction sets supported by the running CPU, from scalar to the fastest.
+std::vector<detail::FastScanKernels> supported_kernels() {
+    std::vector<detail::FastScanKernels> kernels = {{"scalar", fast_scan_scalar, fast_scan_scalar}};
+#ifdef VECTOR_ENGINE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        kernels.push_back({"avx2", fast_scan_avx2, fast_scan_avx2});
+    }
+
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+        kernels.push_back({"avx512", fast_scan_avx512, fast_scan_avx2});
+    }
+#endif
+
+    return kernels;
+}
+
+}
+
+namespace detail {
+
+const std::vector<FastScanKernels>& fast_scan_kernels() {
+    static const std::vector<FastScanKernels> kernels = supported_kernels();
+    return kernels;
+}
+
+}
+
+void fast_scan_set_code(uint8_t *block, std::size_t lane, std::size_t sub, uint8_t code) noexcept {
+    assert(lane < FAST_SCAN_BLOCK && code < 16);
+
+    auto &byte = block[sub * 16 + lane % 16];
+    if (lane < 16) {
+        byte = static_cast<uint8_t>((byte & 0xF0) | code);
+    } else {
+        byte = static_cast<uint8_t>((byte & 0x0F) | (code << 4));
+    }
+}
+
+void fast_scan(const uint8_t *blocks,
+                std::size_t num_blocks,
+                const uint8_t *lut,
+                std::size_t m,
+                uint32_t *dists) {
+    assert(m % 2 == 0);
+
+    const auto &k = detail::fast_scan_kernels().back();
+    auto kernel = m % 4 == 0 ? k.full : k.pair;
+    auto block_size = fast_scan_block_size(m);
+    for (std::size_t idx = 0; idx != num_blocks; ++idx) {
+        kernel(blocks + idx * block_size, lut, m, dists + idx * FAST_SCAN_BLOCK);
+    }
+}
+
+}
@@ -0,0 +1,79 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#ifndef SW_VECTOR_ENGINE_PQ_FAST_SCAN_H
+#define SW_VECTOR_ENGINE_PQ_FAST_SCAN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sw::vengine {
+
+// Fast-scan of 4-bit PQ codes. Codes are packed in blocks of FAST_SCAN_BLOCK vectors,
+// and a block has 16 bytes for each sub-quantizer: byte i holds the code of vector i
+// in the low nibble, and the code of vector i + 16 in the high nibble. A lookup table
+// of a sub-quantizer has 16 uint8 entries, which fits in a 128-bit lane, so that a
+// single shuffle instruction looks up the codes of 16 vectors.
+constexpr std::size_t FAST_SCAN_BLOCK = 32;
+
+// Bytes of a block with `m` sub-quantizers.
+inline std::size_t fast_scan_block_size(std::size_t m) noexcept {
+    return m * 16;
+}
+
+// Set the code of the `lane`-th vector on sub-quantizer `sub` in `block`.
+void fast_scan_set_code(uint8_t *block, std::size_t lane, std::size_t sub, uint8_t code) noexcept;
+
+// Sum up the quantized distances of all vectors in `num_blocks` blocks, i.e.
+// dists[b * FAST_SCAN_BLOCK + lane] = sum of lut[sub * 16 + code of (b, lane, sub)].
+// `m` must be even, since sub-quantizers are processed in pairs.
+// Sums are accumulated in uint16 and widened to uint32 every 256 sub-quantizers,
+// so that they never overflow.
+void fast_scan(const uint8_t *blocks,
+                std::size_t num_blocks,
+                const uint8_t *lut,
+                std::size_t m,
+                uint32_t *dists);
+
+namespace detail {
+
+// Sum up the quantized distances of vectors in a single block.
+using FastScanFunc = void (*)(const uint8_t *block, const uint8_t *lut, std::size_t m, uint32_t *dists);
+
+// Fast-scan kernels of an instruction set.
+struct FastScanKernels {
+    // Name of the instruction set, e.g. avx512, avx2, scalar.
+    const char *name = nullptr;
+
+    // Kernel for `m` of multiple of 4.
+    FastScanFunc full = nullptr;
+
+    // Kernel for any even `m`, which is used if `m` is not a multiple of 4.
+    FastScanFunc pair = nullptr;
+};
+
+// @return kernels of every instruction set supported by the running CPU, from scalar
+//         to the fastest one, which is used by `fast_scan`. Slower ones are only exposed
+//         for tests and benchmarks.
+const std::vector<FastScanKernels>& fast_scan_kernels();
+
+}
+
+}
+
+#endif // end SW_VECTOR_ENGINE_PQ_FAST_SCAN_H
@@ -34,10 +34,10 @@ ResponseBuilderUPtr ResponseBuilderCreator::create(ProtocolType type) const {
     }
 }
 
-RequestParserUPtr RequestParserCreator::create(ProtocolType type) const {
+RequestParserUPtr RequestParserCreator::create(ProtocolType type, std::size_t max_request_size) const {
     switch (type) {
     case ProtocolType::RESP:
-        return std::make_unique<RespRequestParser>();
+        return std::make_unique<RespRequestParser>(max_request_size);
 
     case ProtocolType::JSON_RPC:
         return std::make_unique<JsonRpcRequestParser>();
@@ -17,8 +17,12 @@
 #ifndef SW_VECTOR_ENGINE_PROTOCOL_H
 #define SW_VECTOR_ENGINE_PROTOCOL_H
 
+#include <cstddef>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
+#include "sw/vector-engine/read_buffer.h"
 
 namespace sw::vengine {
 
@@ -26,7 +30,7 @@ class TaskOutput;
 class Task;
 
 enum class ProtocolType {
-    RESP = 0
+    RESP = 0,
     JSON_RPC,
 };
 
@@ -38,9 +42,12 @@ class ResponseBuilder {
 public:
     virtual ~ResponseBuilder() = default;
 
+    // Tasks of a batch might run on multiple workers, which share the builder,
+    // so this method MUST be thread-safe.
     virtual std::string build(TaskOutput *output) = 0;
 };
 using ResponseBuilderUPtr = std::unique_ptr<ResponseBuilder>;
+using ResponseBuilderSPtr = std::shared_ptr<ResponseBuilder>;
 
 class ResponseBuilderCreator {
 public:
@@ -51,14 +58,19 @@ class RequestParser {
 public:
     virtual ~RequestParser() = default;
 
-    virtual auto parse(std::string_view buffer) const
+    // Parsers might be stateful, i.e. remember the state of an incomplete request.
+    // The caller must drop the returned number of bytes from the front of `buffer`
+    // before the next call.
+    virtual auto parse(const ReadBuffer &buffer)
         -> std::pair<std::vector<std::unique_ptr<Task>>, std::size_t> = 0;
 };
 using RequestParserUPtr = std::unique_ptr<RequestParser>;
 
 class RequestParserCreator {
 public:
-    RequestParserUPtr create(ProtocolType type) const;
+    // A request is buffered until it's complete, so it never exceeds `max_request_size`,
+    // i.e. the max size of the read buffer, and parsers reject headers claiming more.
+    RequestParserUPtr create(ProtocolType type, std::size_t max_request_size) const;
 };
 
 }
@@ -15,13 +15,35 @@
  *************************************************************************/
 
 #include "sw/vector-engine/reactor.h"
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <iostream>
 #include "sw/vector-engine/errors.h"
+#include "sw/vector-engine/logger.h"
 #include "sw/vector-engine/resp.h"
 
 namespace sw::vengine {
 
+namespace {
+
+// Retries of a full reply queue yield at first, then sleep exponentially longer,
+// up to about 1ms, so that blocked workers don't burn cores the reactor might need.
+void backoff(std::size_t retries) {
+    constexpr std::size_t MAX_YIELDS = 16;
+    constexpr std::size_t MAX_SHIFT = 10;
+
+    if (retries < MAX_YIELDS) {
+        std::this_thread::yield();
+        return;
+    }
+
+    auto shift = std::min(retries - MAX_YIELDS, MAX_SHIFT);
+    std::this_thread::sleep_for(std::chrono::microseconds(std::size_t(1) << shift));
+}
+
+}
+
 void Reactor::_on_connect(uv_stream_t *server, int status) {
     if (status < 0) {
         // TODO: do log instead of throw exception
@@ -71,7 +93,6 @@ void Reactor::_on_reply(uv_async_t *handle) {
 void Reactor::_on_write(uv_write_t *req, int status) {
     if (status < 0) {
         // TODO: failed to do write.
-        return;
     }
 
     auto *ctx = uv::get_data<ReplyContext>(req);
@@ -80,12 +101,25 @@ void Reactor::_on_write(uv_write_t *req, int status) {
     delete req;
 }
 
-void Reactor::_on_timer(uv_timer_t * /*handle*/) {
+void Reactor::_on_timer(uv_timer_t *handle) {
+    assert(handle != nullptr);
+
+    auto *reactor = uv::get_data<Reactor>(handle);
+    assert(reactor != nullptr);
+
+    // Might be unused if debug logging is compiled out.
+    [[maybe_unused]] auto stats = reactor->buffer_pool_stats();
+    VECTOR_ENGINE_DEBUG("read buffer pool: chunk size {}, used chunks {}, free chunks {}, hit rate {:.2f}%",
+            stats.chunk_size, stats.used_chunks, stats.free_chunks, stats.hit_rate() * 100);
 }
 
-Reactor::Reactor(const ReactorOptions &opts, const WorkerPoolSPtr &worker_pool) :
+Reactor::Reactor(const ReactorOptions &opts, const WorkerPoolSPtr &worker_pool, std::size_t index) :
     _opts(opts),
+    _connection_cnt(static_cast<uint64_t>(index) << 48),
+    _replies(opts.reply_queue_size),
     _worker_pool(worker_pool),
+    _buffer_pool(std::make_shared<BufferPool>(opts.connection_opts.read_buf_chunk_size,
+                opts.connection_opts.read_buf_pool_size)),
     _loop(uv::make_loop()) {
     _server = uv::make_tcp_server(*_loop, _opts.tcp_opts, _on_connect, this);
 
@@ -93,9 +127,12 @@ Reactor::Reactor(const ReactorOptions &opts, const WorkerPoolSPtr &worker_pool)
 
     _reply_async = uv::make_async(*_loop, _on_reply, this);
 
-    _loop_thread = std::thread([this]() { uv_run(this->_loop.get(), UV_RUN_DEFAULT); });
+    // Handles must be initialized before the loop thread starts running.
     uv_timer_init(_loop.get(), &timer);
+    uv::set_data(&timer, this);
     uv_timer_start(&timer, _on_timer, 2000, 2000);
+
+    _loop_thread = std::thread([this]() { uv_run(this->_loop.get(), UV_RUN_DEFAULT); });
 }
 
 Reactor::~Reactor() {
@@ -107,19 +144,34 @@ Reactor::~Reactor() {
 }
 
 void Reactor::send(std::vector<Reply> replies) {
-    {
-        std::lock_guard<std::mutex> lock(_mutex);
-        _replies.insert(_replies.end(),
-                std::make_move_iterator(replies.begin()),
-                std::make_move_iterator(replies.end()));
+    for (auto &reply : replies) {
+        for (std::size_t retries = 0; !_replies.try_push(reply); ++retries) {
+            if (_stopped.load(std::memory_order_acquire)) {
+                // Nobody will drain the queue.
+                return;
+            }
+
+            // Queue is full, wake up the reactor and wait for it to drain the queue.
+            _waiting.store(false);
+            _notify();
+            backoff(retries);
+        }
     }
 
-    _notify();
+    // Pairs with the fence in `_send()`: either we see the reactor waiting,
+    // or the reactor sees the replies we just pushed.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (_waiting.exchange(false)) {
+        _notify();
+    }
 }
 
 void Reactor::stop() {
     assert(_stop_async);
 
+    _stopped.store(true, std::memory_order_release);
+
     uv_async_send(_stop_async.get());
 }
 
@@ -131,7 +183,8 @@ void Reactor::_notify() {
 
 std::pair<ConnectionId, TcpUPtr> Reactor::_create_client() {
     auto id = _connection_id();
-    auto conn = std::make_unique<Connection>(id, _opts.connection_opts, _opts.protocol_opts, *this);
+    auto conn = std::make_unique<Connection>(id,
+            _opts.connection_opts, _opts.protocol_opts, _buffer_pool, *this);
     auto *connection = conn.get();
 
     auto client = uv::make_tcp_client(*_loop, _opts.tcp_opts.keepalive, connection);
@@ -143,8 +196,8 @@ std::pair<ConnectionId, TcpUPtr> Reactor::_create_client() {
     return std::make_pair(id, std::move(client));
 }
 
-void Reactor::_send(Reply reply) {
-    auto iter = _connections.find(reply.connection_id);
+void Reactor::_send(ConnectionId id, std::vector<Reply> replies) {
+    auto iter = _connections.find(id);
     if (iter == _connections.end()) {
         // Connection has been closed.
         return;
@@ -153,33 +206,96 @@ void Reactor::_send(Reply reply) {
     auto *client = iter->second;
     assert(client != nullptr);
 
-    auto ctx = std::make_unique<ReplyContext>(std::move(reply));
+    // Batches might be finished by different workers out of order.
+    auto *connection = uv::get_data<Connection>(client);
+    assert(connection != nullptr);
+
+    replies = connection->reorder(std::move(replies));
+    if (replies.empty()) {
+        return;
+    }
+
+    auto ctx = std::make_unique<ReplyContext>(std::move(replies));
     auto w = uv::make_write(*_loop, ctx.get());
-    uv_write(w.get(), reinterpret_cast<uv_stream_t*>(client), &(ctx->buf), 1, _on_write);
+    // uv_write copies the uv_buf_t array, but the underlying replies must outlive the request.
+    auto err = uv_write(w.get(), uv::to_stream(client),
+            ctx->bufs.data(), ctx->bufs.size(), _on_write);
+    if (err != 0) {
+        // TODO: do log
+        return;
+    }
+
     ctx.release();
     w.release();
 }
 
 void Reactor::_send() {
+    _waiting.store(false);
+
+    // Drain at most one queue of replies per wakeup, so that reads are not starved.
     std::vector<Reply> replies;
-    {
-        std::lock_guard<std::mutex> lock(_mutex);
-        replies.swap(_replies);
+    Reply reply;
+    while (replies.size() < _replies.capacity() && _replies.try_pop(reply)) {
+        replies.push_back(std::move(reply));
     }
 
-    for (auto &reply : replies) {
-        _send(reply);
+    if (!_replies.empty()) {
+        // Still have pending replies, schedule another round.
+        _notify();
+    } else {
+        _waiting.store(true);
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (!_replies.empty() && _waiting.exchange(false)) {
+            // Some producer pushed replies before it saw us waiting.
+            _notify();
+        }
+    }
+
+    // Group replies by connection, and keep the order of replies for each connection,
+    // so that each connection gets a single vectored write per wakeup.
+    std::unordered_map<ConnectionId, std::vector<Reply>> batches;
+    for (auto &r : replies) {
+        batches[r.connection_id].push_back(std::move(r));
+    }
+
+    for (auto &[id, batch] : batches) {
+        _send(id, std::move(batch));
     }
 }
 
-void Reactor::dispatch(ConnectionId id, std::vector<TaskUPtr> tasks, ResponseBuilderUPtr builder) {
+void Reactor::dispatch(ConnectionId id,
+        uint64_t seq,
+        std::vector<TaskUPtr> tasks,
+        ResponseBuilderUPtr builder,
+        const TaskOrderSPtr &order) {
     try {
-        auto &worker = _worker_pool->fetch(id);
-        BatchTask batch_task = {std::move(tasks), id, std::move(builder), this};
-        worker.submit(std::move(batch_task));
+        BatchTask batch_task = {std::move(tasks), id, seq, std::move(builder), this, order};
+        _worker_pool->submit(std::move(batch_task));
     } catch (const Error &e) {
         // TODO: worker pool has been stopped.
     }
 }
 
+ReactorGroup::ReactorGroup(const ReactorOptions &opts, const WorkerPoolSPtr &worker_pool) {
+    auto num = opts.num_loops == 0 ? hardware_concurrency() : opts.num_loops;
+
+    // Reactor index takes the high 16 bits of connection ids.
+    if (num > (1U << 16)) {
+        throw Error("too many event loops: " + std::to_string(num));
+    }
+
+    _reactors.reserve(num);
+    for (auto idx = 0U; idx != num; ++idx) {
+        _reactors.push_back(std::make_unique<Reactor>(opts, worker_pool, idx));
+    }
+}
+
+void ReactorGroup::stop() {
+    for (auto &reactor : _reactors) {
+        reactor->stop();
+    }
+}
+
 }
@@ -17,11 +17,15 @@
 #ifndef SW_VECTOR_ENGINE_REACTOR_H
 #define SW_VECTOR_ENGINE_REACTOR_H
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <thread>
 #include <unordered_map>
+#include <vector>
+#include "sw/vector-engine/buffer_pool.h"
 #include "sw/vector-engine/connection.h"
+#include "sw/vector-engine/mpsc_queue.h"
 #include "sw/vector-engine/task.h"
 #include "sw/vector-engine/worker.h"
 #include "sw/vector-engine/uv_utils.h"
@@ -34,22 +38,33 @@ struct ReactorOptions {
     ConnectionOptions connection_opts;
 
     ProtocolOptions protocol_opts;
+
+    // Max number of pending replies, which are sent from workers to the reactor.
+    std::size_t reply_queue_size;
+
+    // Number of event loops of a ReactorGroup, and 0 means `hardware_concurrency()`.
+    std::size_t num_loops = 0;
 };
 
+// Replies of a single connection, which are written with one vectored write.
 struct ReplyContext {
-    explicit ReplyContext(Reply r) : reply(std::move(r)) {
-        buf.base = reply.reply.data();
-        buf.len = reply.reply.size();
+    explicit ReplyContext(std::vector<Reply> r) : replies(std::move(r)) {
+        bufs.reserve(replies.size());
+        for (auto &reply : replies) {
+            bufs.push_back(uv_buf_init(reply.reply.data(), reply.reply.size()));
+        }
     }
 
-    Reply reply;
+    std::vector<Reply> replies;
 
-    uv_buf_t buf;
+    std::vector<uv_buf_t> bufs;
 };
 
 class Reactor {
 public:
-    Reactor(const ReactorOptions &opts, const WorkerPoolSPtr &worker_pool);
+    // `index` identifies this reactor inside a ReactorGroup, and is encoded
+    // into the high bits of connection ids to keep them unique across loops.
+    Reactor(const ReactorOptions &opts, const WorkerPoolSPtr &worker_pool, std::size_t index = 0);
 
     Reactor(const Reactor &) = delete;
     Reactor& operator=(const Reactor &) = delete;
@@ -59,6 +74,12 @@ public:
 
     ~Reactor();
 
+    BufferPoolStats buffer_pool_stats() const {
+        return _buffer_pool->stats();
+    }
+
+    // Called by workers. If the reply queue is full, it backs off until the reactor
+    // drains it, and replies are dropped once the reactor has been stopped.
     void send(std::vector<Reply> replies);
 
     void stop();
@@ -67,7 +88,14 @@ public:
         _connections.erase(id);
     }
 
-    void dispatch(ConnectionId id, std::vector<TaskUPtr> task, ResponseBuilderUPtr builder);
+    // `seq` is the sequence number of the first task in the connection,
+    // and other tasks are numbered consecutively. `order` is shared by all
+    // batches of the connection.
+    void dispatch(ConnectionId id,
+                    uint64_t seq,
+                    std::vector<TaskUPtr> tasks,
+                    ResponseBuilderUPtr builder,
+                    const TaskOrderSPtr &order);
 
 private:
     static void _on_connect(uv_stream_t *server, int status);
@@ -90,7 +118,7 @@ private:
 
     void _send();
 
-    void _send(Reply reply);
+    void _send(ConnectionId id, std::vector<Reply> replies);
 
     ReactorOptions _opts;
 
@@ -106,17 +134,53 @@ private:
 
     std::unordered_map<ConnectionId, uv_tcp_t*> _connections;
 
-    std::mutex _mutex;
+    MpscQueue<Reply> _replies;
+
+    // Whether the loop thread has drained the reply queue and waits for a notification.
+    // Producers only signal the async handle when it's true, so that wakeups are
+    // elided when the reactor is busy.
+    std::atomic<bool> _waiting{true};
 
-    std::vector<Reply> _replies;
+    std::atomic<bool> _stopped{false};
 
     WorkerPoolSPtr _worker_pool;
 
+    // Shared by read buffers of all connections of this loop.
+    BufferPoolSPtr _buffer_pool;
+
     uv_timer_t timer;
 
     LoopUPtr _loop;
 };
 
+using ReactorUPtr = std::unique_ptr<Reactor>;
+
+// Runs N independent reactors, each with its own loop thread, listener, connections
+// and reply queue. All listeners bind to the same ip/port with SO_REUSEPORT,
+// so that the kernel spreads incoming connections across loops.
+class ReactorGroup {
+public:
+    // Start `opts.num_loops` reactors.
+    ReactorGroup(const ReactorOptions &opts, const WorkerPoolSPtr &worker_pool);
+
+    ReactorGroup(const ReactorGroup &) = delete;
+    ReactorGroup& operator=(const ReactorGroup &) = delete;
+
+    ReactorGroup(ReactorGroup &&) = delete;
+    ReactorGroup& operator=(ReactorGroup &&) = delete;
+
+    ~ReactorGroup() = default;
+
+    void stop();
+
+    std::size_t size() const noexcept {
+        return _reactors.size();
+    }
+
+private:
+    std::vector<ReactorUPtr> _reactors;
+};
+
 }
 
 #endif // end SW_VECTOR_ENGINE_REACTOR_H
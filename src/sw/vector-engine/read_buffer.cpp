@@ -15,71 +15,127 @@
  *************************************************************************/
 
 #include "sw/vector-engine/read_buffer.h"
+#include <algorithm>
 #include <cassert>
 #include "sw/vector-engine/errors.h"
 
 namespace sw::vengine {
 
-ReadBuffer::ReadBuffer(std::size_t min_size, std::size_t max_size) :
-    _min_size(min_size),
+ReadBuffer::ReadBuffer(const BufferPoolSPtr &pool, std::size_t max_size) :
+    _pool(pool),
+    _chunk_size(pool->chunk_size()),
     _max_size(max_size) {
-    assert(_min_size > 0 && _min_size <= _max_size);
-
-    _size = 0;
-    _buf.resize(_min_size);
+    assert(_chunk_size > 0 && _chunk_size <= _max_size);
 }
 
-std::pair<char*, std::size_t> ReadBuffer::alloc(std::size_t suggested_size) {
-    auto remain = _realloc_if_needed(suggested_size);
+std::pair<char*, std::size_t> ReadBuffer::alloc(std::size_t /*suggested_size*/) {
+    if (_size >= _max_size) {
+        // Already reach the max size limit.
+        return std::make_pair(nullptr, 0);
+    }
+
+    if (_chunks.empty() || _chunks.back().end == _chunk_size) {
+        Chunk chunk;
+        chunk.buf = _pool->acquire();
+        _chunks.push_back(std::move(chunk));
+    }
+
+    auto &chunk = _chunks.back();
+    auto remain = std::min(_chunk_size - chunk.end, _max_size - _size);
 
-    return std::make_pair(_buf.data() + _size, remain);
+    return std::make_pair(chunk.buf->data() + chunk.end, remain);
 }
 
 void ReadBuffer::occupy(std::size_t size) noexcept {
-    assert(size + _size <= _buf.size());
+    assert(!_chunks.empty() && _chunks.back().end + size <= _chunk_size);
 
+    _chunks.back().end += size;
     _size += size;
 }
 
 void ReadBuffer::dealloc(std::size_t size) {
     assert(size > 0 && size <= _size);
 
-    if (_size - size < _min_size / 2) {
-        std::string buf(_min_size, '\0');
-        std::copy(_buf.data() + size, _buf.data() + _size, buf.data());
-        _buf.swap(buf);
-    } else {
-        std::copy(_buf.data() + size, _buf.data() + _size, _buf.data());
-    }
-
     _size -= size;
-}
 
-std::size_t ReadBuffer::_realloc_if_needed(std::size_t suggested_size) {
-    auto capacity = _buf.size();
-    assert(capacity >= _size);
+    while (size > 0) {
+        assert(!_chunks.empty());
 
-    auto remain = capacity - _size;
+        auto &chunk = _chunks.front();
+        auto len = std::min(size, chunk.end - chunk.begin);
+        chunk.begin += len;
+        size -= len;
 
-    while (remain < suggested_size) {
-        if (capacity >= _max_size) {
-            // Already reach the max size limit.
+        if (chunk.begin < chunk.end) {
             break;
         }
 
-        capacity *= 2;
-        if (capacity > _max_size) {
-            capacity = _max_size;
-        }
+        // The chunk has been fully consumed, and goes back to the pool once it's unpinned.
+        _chunks.pop_front();
+    }
+}
 
-        remain = capacity - _size;
+void ReadBuffer::shrink() {
+    if (_size == 0) {
+        _chunks.clear();
     }
+}
+
+char ReadBuffer::at(std::size_t pos) const {
+    assert(pos < _size);
+
+    auto [idx, offset] = _locate(pos);
+
+    return (*_chunks[idx].buf)[offset];
+}
 
-    if (capacity > _buf.size()) {
-        _buf.resize(capacity);
+std::string_view ReadBuffer::contiguous(std::size_t pos) const {
+    if (pos >= _size) {
+        return {};
     }
 
-    return remain;
+    auto [idx, offset] = _locate(pos);
+    const auto &chunk = _chunks[idx];
+
+    return {chunk.buf->data() + offset, chunk.end - offset};
+}
+
+void ReadBuffer::copy(std::size_t pos, std::size_t len, char *out) const {
+    assert(pos + len <= _size);
+
+    while (len > 0) {
+        auto view = contiguous(pos);
+        auto n = std::min(len, view.size());
+        std::copy(view.data(), view.data() + n, out);
+        out += n;
+        pos += n;
+        len -= n;
+    }
+}
+
+std::pair<std::string_view, BufferPin> ReadBuffer::view(std::size_t pos, std::size_t len) const {
+    assert(pos + len <= _size);
+
+    auto [idx, offset] = _locate(pos);
+    const auto &chunk = _chunks[idx];
+    if (offset + len <= chunk.end) {
+        return std::make_pair(std::string_view(chunk.buf->data() + offset, len), chunk.buf);
+    }
+
+    // The range spans chunks, make it contiguous.
+    auto buf = std::make_shared<std::string>(len, '\0');
+    copy(pos, len, buf->data());
+
+    return std::make_pair(std::string_view(buf->data(), len), std::move(buf));
+}
+
+std::pair<std::size_t, std::size_t> ReadBuffer::_locate(std::size_t pos) const {
+    assert(!_chunks.empty());
+
+    // All chunks except the last one are full, so chunk index can be calculated directly.
+    auto abs_pos = _chunks.front().begin + pos;
+
+    return std::make_pair(abs_pos / _chunk_size, abs_pos % _chunk_size);
 }
 
 }
@@ -17,32 +17,75 @@
 #ifndef SW_VECTOR_ENGINE_READ_BUFFER_H
 #define SW_VECTOR_ENGINE_READ_BUFFER_H
 
+#include <deque>
+#include <memory>
 #include <string>
 #include <string_view>
+#include "sw/vector-engine/buffer_pool.h"
 
 namespace sw::vengine {
 
+// Keeps the underlying memory of some views alive.
+using BufferPin = std::shared_ptr<const void>;
+
+// Read buffer built from fixed-size chunks. New data is appended to the last chunk,
+// and consumed data is dropped from the front without moving the remaining bytes.
+// All chunks, except the last one, are full. Positions used by the accessors are
+// relative to the first unconsumed byte.
+// Chunks are lazily acquired from the pool, and go back to it once they are consumed
+// and no longer pinned, so that idle connections hold no memory.
 class ReadBuffer {
 public:
-    ReadBuffer(std::size_t min_size, std::size_t max_size);
+    ReadBuffer(const BufferPoolSPtr &pool, std::size_t max_size);
 
+    // @return free space at the end of the last chunk, and a new chunk is allocated
+    //         if the last one is full. Return zero size if the buffer is full.
     std::pair<char*, std::size_t> alloc(std::size_t suggested_size);
 
+    // Consume `size` bytes from the front.
     void dealloc(std::size_t size);
 
     void occupy(std::size_t size) noexcept;
 
-    std::string_view data() {
-        return {_buf.data(), _size};
+    // Release the allocated chunk if it holds no data, e.g. the read got nothing.
+    void shrink();
+
+    // Number of unconsumed bytes.
+    std::size_t size() const noexcept {
+        return _size;
     }
 
+    char at(std::size_t pos) const;
+
+    // @return view from `pos` to the end of the chunk that contains `pos`.
+    std::string_view contiguous(std::size_t pos) const;
+
+    void copy(std::size_t pos, std::size_t len, char *out) const;
+
+    // Get a view of [pos, pos + len) and the pin which keeps the view valid.
+    // If the range is inside a single chunk, the view references the chunk
+    // without copy. Otherwise, the range is copied to a new memory block.
+    std::pair<std::string_view, BufferPin> view(std::size_t pos, std::size_t len) const;
+
 private:
-    std::size_t _realloc_if_needed(std::size_t suggested_size);
+    struct Chunk {
+        std::shared_ptr<std::string> buf;
+
+        // Offset of the first unconsumed byte.
+        std::size_t begin = 0;
+
+        // Offset of the end of occupied bytes.
+        std::size_t end = 0;
+    };
+
+    // @return pair<chunk index, offset in chunk>
+    std::pair<std::size_t, std::size_t> _locate(std::size_t pos) const;
 
-    std::size_t _min_size;
+    BufferPoolSPtr _pool;
+    std::size_t _chunk_size;
     std::size_t _max_size;
-    std::size_t _size;
-    std::string _buf;
+    std::size_t _size = 0;
+    std::deque<Chunk> _chunks;
 };
 
 }
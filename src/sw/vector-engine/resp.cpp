@@ -19,60 +19,155 @@
 #include "sw/vector-engine/task.h"
 #include "sw/vector-engine/ping_task.h"
 #include "sw/vector-engine/unknown_task.h"
+#include "sw/vector-engine/vector_task.h"
 #include "sw/vector-engine/str_utils.h"
 #include <cassert>
+#include <algorithm>
 #include <charconv>
 
 namespace sw::vengine {
 
-auto RespCommandParser::parse(std::string_view buffer) const
+auto RespCommandParser::parse(const ReadBuffer &buffer)
     -> std::pair<std::vector<RespCommand>, std::size_t> {
-    auto *first = buffer.data();
+    assert(_pos <= buffer.size());
+
     std::vector<RespCommand> cmds;
     std::size_t bytes_parsed = 0;
 
-    while (true) {
-        auto argc = _parse_argc(buffer);
+    while (_parse_command(buffer)) {
+        cmds.push_back(_make_command(buffer));
+
+        bytes_parsed = _pos;
+        _argc.reset();
+        _argv.clear();
+    }
+
+    // The caller will drop the parsed bytes, so rebase the state of the incomplete command.
+    _pos -= bytes_parsed;
+    for (auto &arg : _argv) {
+        arg.first -= bytes_parsed;
+    }
+
+    return std::make_pair(std::move(cmds), bytes_parsed);
+}
+
+bool RespCommandParser::_parse_command(const ReadBuffer &buffer) {
+    // Only commit the state, i.e. `_pos`, after a complete element has been parsed.
+    if (!_argc) {
+        auto argc = _parse_header('*', buffer);
         if (!argc) {
             // Incomplete request.
-            break;
+            return false;
         }
 
         if (*argc == 0) {
             throw Error("invalid request: zero argument");
         }
 
-        auto name = _parse_argv(buffer);
-        if (!name) {
-            // Incomplete request.
-            break;
+        if (*argc > _max_size / MIN_ARG_SIZE) {
+            throw Error("invalid request: too many arguments");
         }
 
-        std::vector<std::string> args;
-        args.reserve(*argc - 1);
-        auto idx = 0U;
-        for ( ; idx != *argc - 1; ++idx) {
-            auto argv = _parse_argv(buffer);
-            if (!argv) {
+        _argc = *argc;
+        _argv.reserve(std::min(*argc, MAX_RESERVED_ARGS));
+    }
+
+    while (_argv.size() < *_argc) {
+        // $n\r\nxxxxx\r\n
+        if (!_bulk_len) {
+            auto bulk_len = _parse_header('$', buffer);
+            if (!bulk_len) {
                 // Incomplete request.
-                break;
+                return false;
+            }
+
+            // Also guarantee that `len + 2` below never overflows.
+            if (*bulk_len > _max_size) {
+                throw Error("invalid request: argument is too long");
             }
-            args.push_back(std::move(*argv));
+
+            _bulk_len = bulk_len;
         }
 
-        if (idx < *argc - 1) {
-            // Incomplete request.
-            break;
+        auto len = *_bulk_len;
+        if (buffer.size() - _pos < len + 2) {
+            // Incomplete request. Wait for more data without scanning the payload.
+            return false;
+        }
+
+        if (buffer.at(_pos + len) != '\r' || buffer.at(_pos + len + 1) != '\n') {
+            throw Error("expect '\\r\\n'");
         }
 
-        RespCommand cmd;
-        cmd.name = *name;
-        cmd.args = std::move(args);
-        cmds.push_back(std::move(cmd));
-        bytes_parsed = (buffer.data() - first);
+        _argv.emplace_back(_pos, len);
+        _bulk_len.reset();
+
+        _pos += len + 2;
     }
 
-    return std::make_pair(std::move(cmds), bytes_parsed);
+    return true;
+}
+
+RespCommand RespCommandParser::_make_command(const ReadBuffer &buffer) const {
+    assert(_argc && _argv.size() == *_argc && !_argv.empty());
+
+    RespCommand cmd;
+
+    auto [name_offset, name_len] = _argv.front();
+    cmd.name.resize(name_len);
+    buffer.copy(name_offset, name_len, cmd.name.data());
+
+    cmd.args.reserve(_argv.size() - 1);
+
+    if (_zero_copy) {
+        for (auto idx = 1U; idx < _argv.size(); ++idx) {
+            auto [offset, len] = _argv[idx];
+            auto [arg, pin] = buffer.view(offset, len);
+            cmd.args.push_back(arg);
+            if (cmd.pins.empty() || cmd.pins.back() != pin) {
+                // Arguments in the same chunk share the pin.
+                cmd.pins.push_back(std::move(pin));
+            }
+        }
+    } else {
+        std::size_t total = 0;
+        for (auto idx = 1U; idx < _argv.size(); ++idx) {
+            total += _argv[idx].second;
+        }
+
+        auto buf = std::make_shared<std::string>(total, '\0');
+        auto *ptr = buf->data();
+        for (auto idx = 1U; idx < _argv.size(); ++idx) {
+            auto [offset, len] = _argv[idx];
+            buffer.copy(offset, len, ptr);
+            cmd.args.emplace_back(ptr, len);
+            ptr += len;
+        }
+
+        cmd.pins.push_back(std::move(buf));
+    }
+
+    return cmd;
+}
+
+std::optional<std::size_t> RespCommandParser::_parse_header(char c, const ReadBuffer &buffer) {
+    auto data = buffer.contiguous(_pos);
+
+    char tmp[MAX_HEADER_SIZE];
+    if (data.size() < MAX_HEADER_SIZE && _pos + data.size() < buffer.size()) {
+        // The header might span chunks.
+        auto len = std::min(MAX_HEADER_SIZE, buffer.size() - _pos);
+        buffer.copy(_pos, len, tmp);
+        data = std::string_view(tmp, len);
+    }
+
+    auto *first = data.data();
+    auto num = _parse_num(c, data);
+    if (num) {
+        _pos += data.data() - first;
+    }
+
+    return num;
 }
 
 std::optional<std::size_t> RespCommandParser::_parse_num(char c, std::string_view &buffer) const {
@@ -110,32 +205,6 @@ std::optional<std::size_t> RespCommandParser::_parse_num(char c, std::string_vie
     return argc;
 }
 
-std::optional<std::string> RespCommandParser::_parse_argv(std::string_view &buffer) const {
-    // $n\r\nxxxxx\r\n
-    auto num = _parse_num('$', buffer);
-    if (!num) {
-        // Incomplete request.
-        return std::nullopt;
-    }
-
-    auto len = *num;
-
-    if (buffer.size() < len + 2) {
-        return std::nullopt;
-    }
-
-    auto *last = buffer.data() + len;
-    if (*last != '\r' || *(last + 1) != '\n') {
-        throw Error("expect '\\r\\n'");
-    }
-
-    std::string argv(buffer.data(), len);
-
-    buffer.remove_prefix(len + 2);
-
-    return argv;
-}
-
 RespReplyBuilder& RespReplyBuilder::append_bulk_string(const std::string_view &str) {
     // $size\r\nstr\r\n
     auto len = std::to_string(str.size());
@@ -170,15 +239,14 @@ std::string RespResponseBuilder::build(TaskOutput *output) {
     return output->to_resp_reply();
 }
 
-auto RespRequestParser::parse(std::string_view buffer) const
+auto RespRequestParser::parse(const ReadBuffer &buffer)
     -> std::pair<std::vector<TaskUPtr>, std::size_t> {
-    RespCommandParser parser;
-    auto [cmds, len] = parser.parse(buffer);
+    auto [cmds, len] = _parser.parse(buffer);
 
     RespTaskCreator creator;
     std::vector<TaskUPtr> tasks;
     for (auto &cmd : cmds) {
-        auto task = creator.create(cmd);
+        auto task = creator.create(std::move(cmd));
         tasks.push_back(std::move(task));
     }
 
@@ -186,7 +254,13 @@ auto RespRequestParser::parse(std::string_view buffer) const
 }
 
 const RespTaskCreator::CreatorMap RespTaskCreator::_creators = {
-    {"ping", create_resp_task<PingTask>}
+    {"ping", create_resp_task<PingTask>},
+    {"vadd", create_resp_task<VAddTask>},
+    {"vget", create_resp_task<VGetTask>},
+    {"vdel", create_resp_task<VDelTask>},
+    {"vcreate", create_resp_task<VCreateTask>},
+    {"vsim", create_resp_task<VSimTask>},
+    {"vinfo", create_resp_task<VInfoTask>}
 };
 
 TaskUPtr RespTaskCreator::create(RespCommand cmd) {
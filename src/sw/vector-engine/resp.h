@@ -25,34 +25,79 @@
 #include <unordered_map>
 #include <vector>
 #include "sw/vector-engine/protocol.h"
+#include "sw/vector-engine/read_buffer.h"
 
 namespace sw::vengine {
 
 class Task;
 class TaskOutput;
 
-using RespArgs = std::vector<std::string>;
+// Arguments are views into the memory kept alive by RespCommand::pins.
+using RespArgs = std::vector<std::string_view>;
 
 struct RespCommand {
     std::string name;
     RespArgs args;
+    std::vector<BufferPin> pins;
 };
 
+// Incremental parser, which remembers where it stopped, so that each byte of
+// a large request is examined only once, even if it arrives in many reads.
 class RespCommandParser {
 public:
+    // In zero-copy mode, arguments reference chunks of the read buffer directly,
+    // and only arguments spanning chunks are copied. Otherwise, each command
+    // copies its arguments to its own memory block.
+    // Commands larger than `max_size` are rejected by their headers, before any
+    // memory is allocated for them.
+    explicit RespCommandParser(std::size_t max_size, bool zero_copy = true) :
+        _max_size(max_size), _zero_copy(zero_copy) {}
+
+    // Parse complete commands in `buffer`, and remember the state of the trailing
+    // incomplete command. The caller MUST drop the returned number of bytes from
+    // the front of `buffer` before calling `parse` again.
     // @return pair<vector<RespCommand>, number of bytes parsed>
-    auto parse(std::string_view data) const
+    auto parse(const ReadBuffer &buffer)
         -> std::pair<std::vector<RespCommand>, std::size_t>;
 
 private:
+    // *n\r\n or $n\r\n, n has at most 20 digits.
+    static constexpr std::size_t MAX_HEADER_SIZE = 32;
+
+    // Size of the smallest argument, i.e. $0\r\n\r\n.
+    static constexpr std::size_t MIN_ARG_SIZE = 6;
+
+    // Arguments reserved by the header. The header is not trusted, so that more
+    // arguments are only allocated as they arrive.
+    static constexpr std::size_t MAX_RESERVED_ARGS = 64;
+
+    // @return true if a complete command has been parsed.
+    bool _parse_command(const ReadBuffer &buffer);
+
+    RespCommand _make_command(const ReadBuffer &buffer) const;
+
+    // Parse a header at `_pos`, and move `_pos` to the end of it.
+    std::optional<std::size_t> _parse_header(char c, const ReadBuffer &buffer);
+
     std::optional<std::size_t> _parse_num(char c, std::string_view &data) const;
 
-    std::optional<std::size_t> _parse_argc(std::string_view &data) const {
-        // *n\r\n
-        return _parse_num('*', data);
-    }
+    std::size_t _max_size;
+
+    bool _zero_copy;
 
-    std::optional<std::string> _parse_argv(std::string_view &data) const;
+    // State of the incomplete command. Offsets are relative to the beginning of `buffer`.
+
+    // Where to resume parsing.
+    std::size_t _pos = 0;
+
+    // Number of arguments (including command name) of the current command.
+    std::optional<std::size_t> _argc;
+
+    // pair<offset, length> of arguments that have been parsed.
+    std::vector<std::pair<std::size_t, std::size_t>> _argv;
+
+    // Length of the bulk string whose header has been parsed.
+    std::optional<std::size_t> _bulk_len;
 };
 
 using RespReply = std::string;
@@ -109,8 +154,13 @@ public:
 
 class RespRequestParser : public RequestParser {
 public:
-    virtual auto parse(std::string_view buffer) const
+    explicit RespRequestParser(std::size_t max_request_size) : _parser(max_request_size) {}
+
+    virtual auto parse(const ReadBuffer &buffer)
         -> std::pair<std::vector<std::unique_ptr<Task>>, std::size_t> override;
+
+private:
+    RespCommandParser _parser;
 };
 
 template <typename T>
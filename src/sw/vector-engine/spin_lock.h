@@ -0,0 +1,62 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#ifndef SW_VECTOR_ENGINE_SPIN_LOCK_H
+#define SW_VECTOR_ENGINE_SPIN_LOCK_H
+
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace sw::vengine {
+
+// Lock for tiny critical sections, e.g. updating a neighbor list. It's one byte,
+// so that it can be embedded in every node. Meets the Lockable requirement.
+class SpinLock {
+public:
+    void lock() noexcept {
+        while (_locked.exchange(true, std::memory_order_acquire)) {
+            // Spin on load, so that the cache line is not bounced between cores.
+            while (_locked.load(std::memory_order_relaxed)) {
+                _pause();
+            }
+        }
+    }
+
+    bool try_lock() noexcept {
+        return !_locked.load(std::memory_order_relaxed)
+            && !_locked.exchange(true, std::memory_order_acquire);
+    }
+
+    void unlock() noexcept {
+        _locked.store(false, std::memory_order_release);
+    }
+
+private:
+    static void _pause() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#endif
+    }
+
+    std::atomic<bool> _locked{false};
+};
+
+}
+
+#endif // end SW_VECTOR_ENGINE_SPIN_LOCK_H
@@ -0,0 +1,273 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#include "sw/vector-engine/sq8_index.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include "sw/vector-engine/errors.h"
+#include "sw/vector-engine/logger.h"
+
+namespace sw::vengine {
+
+Sq8Index::Sq8Index(const IndexOptions &opts, const VectorStorage &storage, Metric metric) :
+    _storage(storage),
+    _dim(storage.dim()),
+    _metric(metric),
+    _distance(distance_func(metric)),
+    _dot(int8_dot_func()),
+    _per_dim(opts.sq_per_dim),
+    _rerank(opts.rerank) {
+    if (_dim >= (1u << 16)) {
+        throw Error("dimension is too large for SQ8");
+    }
+}
+
+void Sq8Index::add(VectorId id, const float *vec) {
+    assert(vec != nullptr);
+
+    if (id >= _used.size()) {
+        _used.resize(static_cast<std::size_t>(id) + 1, false);
+    }
+
+    if (!_used[id]) {
+        _used[id] = true;
+        ++_size;
+    }
+
+    if (trained()) {
+        _encode(id, vec);
+        return;
+    }
+
+    auto offset = static_cast<std::size_t>(id) * _dim;
+    if (_raw.size() < offset + _dim) {
+        _raw.resize(offset + _dim);
+    }
+    std::copy(vec, vec + _dim, _raw.data() + offset);
+
+    if (_size >= MIN_TRAIN_POINTS) {
+        _train();
+    }
+}
+
+void Sq8Index::remove(VectorId id) {
+    assert(id < _used.size() && _used[id]);
+
+    _used[id] = false;
+    --_size;
+}
+
+std::vector<Neighbor> Sq8Index::search(const float *query, const SearchOptions &opts) const {
+    assert(query != nullptr);
+
+    auto k = opts.k;
+    if (k == 0) {
+        return {};
+    }
+
+    if (!trained()) {
+        return _search_raw(query, k, opts.filter);
+    }
+
+    if (_rerank == 0) {
+        return _search_codes(query, k, opts.filter);
+    }
+
+    auto candidates = _search_codes(query, saturated_mul(k, _rerank), opts.filter);
+    for (auto &candidate : candidates) {
+        candidate.first = _distance(query, _storage.data(candidate.second), _dim);
+    }
+
+    k = std::min(k, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + k, candidates.end());
+    candidates.resize(k);
+
+    return candidates;
+}
+
+std::size_t Sq8Index::memory_usage() const {
+    return _codes.capacity()
+        + (_norms.capacity() + _raw.capacity() + _mins.capacity() + _scales.capacity()) * sizeof(float)
+        + _used.capacity() / 8;
+}
+
+void Sq8Index::reconstruct(VectorId id, float *vec) const {
+    assert(id < _used.size() && _used[id]);
+
+    if (trained()) {
+        _decode(id, vec);
+    } else {
+        const auto *raw = _raw.data() + static_cast<std::size_t>(id) * _dim;
+        std::copy(raw, raw + _dim, vec);
+    }
+}
+
+void Sq8Index::_train() {
+    assert(!trained());
+
+    std::vector<float> mins(_dim, std::numeric_limits<float>::max());
+    std::vector<float> maxs(_dim, std::numeric_limits<float>::lowest());
+    for (std::size_t idx = 0; idx != _used.size(); ++idx) {
+        if (!_used[idx]) {
+            continue;
+        }
+
+        const auto *vec = _raw.data() + idx * _dim;
+        for (std::size_t i = 0; i != _dim; ++i) {
+            mins[i] = std::min(mins[i], vec[i]);
+            maxs[i] = std::max(maxs[i], vec[i]);
+        }
+    }
+
+    if (!_per_dim) {
+        auto min = *std::min_element(mins.begin(), mins.end());
+        auto max = *std::max_element(maxs.begin(), maxs.end());
+        std::fill(mins.begin(), mins.end(), min);
+        std::fill(maxs.begin(), maxs.end(), max);
+    }
+
+    _scales.resize(_dim);
+    for (std::size_t i = 0; i != _dim; ++i) {
+        // A constant dimension is always decoded as min.
+        _scales[i] = maxs[i] > mins[i] ? (maxs[i] - mins[i]) / 255 : 0.0f;
+    }
+    _mins = std::move(mins);
+
+    _codes.resize(_used.size() * _dim);
+    _norms.resize(_used.size());
+    for (std::size_t idx = 0; idx != _used.size(); ++idx) {
+        if (_used[idx]) {
+            _encode(static_cast<VectorId>(idx), _raw.data() + idx * _dim);
+        }
+    }
+
+    _raw.clear();
+    _raw.shrink_to_fit();
+
+    VECTOR_ENGINE_INFO("trained SQ8 with {} vectors", _size);
+}
+
+void Sq8Index::_encode(VectorId id, const float *vec) {
+    auto offset = static_cast<std::size_t>(id) * _dim;
+    if (_codes.size() < offset + _dim) {
+        _codes.resize(offset + _dim);
+        _norms.resize(static_cast<std::size_t>(id) + 1);
+    }
+
+    auto *code = _codes.data() + offset;
+    float norm = 0;
+    for (std::size_t i = 0; i != _dim; ++i) {
+        float val = 0;
+        if (_scales[i] > 0) {
+            val = std::round((vec[i] - _mins[i]) / _scales[i]);
+            val = std::min(std::max(val, 0.0f), 255.0f);
+        }
+        code[i] = static_cast<uint8_t>(val);
+
+        auto decoded = _mins[i] + _scales[i] * val;
+        norm += decoded * decoded;
+    }
+
+    _norms[id] = _metric == Metric::COSINE ? std::sqrt(norm) : norm;
+}
+
+void Sq8Index::_decode(VectorId id, float *vec) const {
+    const auto *code = _codes.data() + static_cast<std::size_t>(id) * _dim;
+    for (std::size_t i = 0; i != _dim; ++i) {
+        vec[i] = _mins[i] + _scales[i] * code[i];
+    }
+}
+
+std::vector<Neighbor> Sq8Index::_search_raw(const float *query,
+                                            std::size_t k,
+                                            const Bitmap *filter) const {
+    NeighborHeap heap;
+    for (std::size_t idx = 0; idx != _used.size(); ++idx) {
+        if (_used[idx] && matches(filter, static_cast<VectorId>(idx))) {
+            push_neighbor(heap, k, _distance(query, _raw.data() + idx * _dim, _dim), static_cast<VectorId>(idx));
+        }
+    }
+
+    return sorted_neighbors(heap);
+}
+
+std::vector<Neighbor> Sq8Index::_search_codes(const float *query,
+                                                std::size_t k,
+                                                const Bitmap *filter) const {
+    std::vector<float> q(query, query + _dim);
+    float q_norm = 0;
+    for (auto val : q) {
+        q_norm += val * val;
+    }
+
+    if (_metric == Metric::COSINE && q_norm > 0) {
+        auto scale = 1.0f / std::sqrt(q_norm);
+        for (auto &val : q) {
+            val *= scale;
+        }
+    }
+
+    // <q, v> = sum of q[i] * min[i] + sum of (q[i] * scale[i]) * code[i], and the latter
+    // is approximated with q[i] * scale[i] quantized to [-127, 127] by `q_scale`.
+    float offset = 0;
+    float max_abs = 0;
+    for (std::size_t i = 0; i != _dim; ++i) {
+        offset += q[i] * _mins[i];
+        q[i] *= _scales[i];
+        max_abs = std::max(max_abs, std::abs(q[i]));
+    }
+
+    auto q_scale = max_abs / 127;
+    std::vector<int8_t> quantized(_dim, 0);
+    if (q_scale > 0) {
+        for (std::size_t i = 0; i != _dim; ++i) {
+            quantized[i] = static_cast<int8_t>(std::lround(q[i] / q_scale));
+        }
+    }
+
+    NeighborHeap heap;
+    for (std::size_t idx = 0; idx != _used.size(); ++idx) {
+        if (!_used[idx] || !matches(filter, static_cast<VectorId>(idx))) {
+            continue;
+        }
+
+        auto ip = offset + q_scale * _dot(_codes.data() + idx * _dim, quantized.data(), _dim);
+        float dist = 0;
+        switch (_metric) {
+        case Metric::L2:
+            dist = q_norm - 2 * ip + _norms[idx];
+            break;
+
+        case Metric::IP:
+            dist = -ip;
+            break;
+
+        default:
+            // Zero vector is orthogonal to any vector.
+            dist = _norms[idx] > 0 ? 1.0f - ip / _norms[idx] : 1.0f;
+            break;
+        }
+
+        push_neighbor(heap, k, dist, static_cast<VectorId>(idx));
+    }
+
+    return sorted_neighbors(heap);
+}
+
+}
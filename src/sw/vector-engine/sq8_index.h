@@ -0,0 +1,107 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#ifndef SW_VECTOR_ENGINE_SQ8_INDEX_H
+#define SW_VECTOR_ENGINE_SQ8_INDEX_H
+
+#include <cstdint>
+#include <vector>
+#include "sw/vector-engine/index.h"
+
+namespace sw::vengine {
+
+// Exhaustive search over vectors quantized to 8-bit codes: each dimension is mapped
+// linearly from [min, max] to [0, 255], where the range is trained per dimension, or
+// globally, once there're enough vectors. Before that, raw vectors are kept in the index,
+// and searched exactly. Values out of the trained range are clamped.
+// A query is quantized to signed 8-bit with the per dimension scales folded in, so that
+// its inner product with a code is a single integer dot product. L2 and COSINE are
+// derived from the inner product and the norm of the decoded vector.
+class Sq8Index : public Index {
+public:
+    Sq8Index(const IndexOptions &opts, const VectorStorage &storage, Metric metric);
+
+    // Raw vectors are only needed for re-ranking.
+    virtual bool needs_raw_vectors() const noexcept override {
+        return _rerank > 0;
+    }
+
+    virtual void add(VectorId id, const float *vec) override;
+
+    virtual void remove(VectorId id) override;
+
+    virtual std::vector<Neighbor> search(const float *query, const SearchOptions &opts) const override;
+
+    virtual std::size_t memory_usage() const override;
+
+    virtual void reconstruct(VectorId id, float *vec) const override;
+
+    bool trained() const noexcept {
+        return !_scales.empty();
+    }
+
+private:
+    // Train the quantizer once there're so many vectors.
+    static constexpr std::size_t MIN_TRAIN_POINTS = 1000;
+
+    void _train();
+
+    void _encode(VectorId id, const float *vec);
+
+    void _decode(VectorId id, float *vec) const;
+
+    std::vector<Neighbor> _search_raw(const float *query, std::size_t k, const Bitmap *filter) const;
+
+    std::vector<Neighbor> _search_codes(const float *query, std::size_t k, const Bitmap *filter) const;
+
+    const VectorStorage &_storage;
+
+    std::size_t _dim;
+
+    Metric _metric;
+
+    DistanceFunc _distance;
+
+    Int8DotFunc _dot;
+
+    bool _per_dim;
+
+    std::size_t _rerank;
+
+    // A dimension is decoded as min + scale * code, and both are empty if not trained.
+    std::vector<float> _mins;
+
+    std::vector<float> _scales;
+
+    // `dim` bytes for each id.
+    std::vector<uint8_t> _codes;
+
+    // Squared norm of the decoded vector for L2, and norm for COSINE.
+    std::vector<float> _norms;
+
+    // `dim` floats for each id before training.
+    std::vector<float> _raw;
+
+    // Whether the id is in use, i.e. not deleted.
+    std::vector<bool> _used;
+
+    std::size_t _size = 0;
+};
+
+}
+
+#endif // end SW_VECTOR_ENGINE_SQ8_INDEX_H
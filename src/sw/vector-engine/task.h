@@ -17,7 +17,9 @@
 #ifndef SW_VECTOR_ENGINE_TASK_H
 #define SW_VECTOR_ENGINE_TASK_H
 
+#include <string>
 #include <unordered_map>
+#include <vector>
 #include "sw/vector-engine/connection.h"
 #include "sw/vector-engine/resp.h"
 #include "sw/vector-engine/json_rpc.h"
@@ -44,6 +46,38 @@ public:
     virtual void from_json_rpc_request(JsonRpcRequest req) = 0;
 
     virtual TaskOutputUPtr run() = 0;
+
+    // Whether the task is expensive enough to be worth handing off to another worker
+    // on its own, e.g. a search. Cheap tasks are only moved in large chunks. Only
+    // read-only tasks are split across workers, see `WorkerPool::submit`.
+    virtual bool heavy() const {
+        return false;
+    }
+
+    // Whether the task doesn't modify any state, e.g. a lookup or a search. Read-only
+    // tasks of a connection might run concurrently, while other tasks run in order
+    // with all tasks of the connection.
+    virtual bool read_only() const {
+        return false;
+    }
+
+    // Tasks with the same non-empty key can be run together by `run_batch`, e.g.
+    // searches on the same collection share a single scan of vectors.
+    virtual std::string batch_key() const {
+        return {};
+    }
+
+    // Run `tasks`, which have the same batch key as this task, and include this task.
+    // @return outputs in the same order as `tasks`.
+    virtual std::vector<TaskOutputUPtr> run_batch(const std::vector<Task*> &tasks) {
+        std::vector<TaskOutputUPtr> outputs;
+        outputs.reserve(tasks.size());
+        for (auto *task : tasks) {
+            outputs.push_back(task->run());
+        }
+
+        return outputs;
+    }
 };
 
 using TaskUPtr = std::unique_ptr<Task>;
@@ -22,6 +22,12 @@ void UnknownTask::from_resp_command(RespCommand cmd) {
     _cmd = std::move(cmd);
 }
 
+void UnknownTask::from_json_rpc_request(JsonRpcRequest req) {
+    if (req.is_object()) {
+        _cmd.name = req.value("method", std::string());
+    }
+}
+
 TaskOutputUPtr UnknownTask::run() {
     return std::make_unique<UnknownOutput>(std::move(_cmd));
 }
@@ -35,4 +41,11 @@ RespReply UnknownOutput::to_resp_reply() {
     return builder.data();
 }
 
+JsonRpcReply UnknownOutput::to_json_rpc_reply() {
+    // -32601: method not found.
+    nlohmann::json error = {{"code", -32601}, {"message", "unknown command: " + _cmd.name}};
+
+    return nlohmann::json{{"error", error}}.dump();
+}
+
 }
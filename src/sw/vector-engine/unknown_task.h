@@ -28,8 +28,14 @@ public:
 
     virtual void from_resp_command(RespCommand cmd) override;
 
+    virtual void from_json_rpc_request(JsonRpcRequest req) override;
+
     virtual TaskOutputUPtr run() override;
 
+    virtual bool read_only() const override {
+        return true;
+    }
+
 private:
     RespCommand _cmd;
 };
@@ -40,6 +46,8 @@ public:
 
     virtual RespReply to_resp_reply() override;
 
+    virtual JsonRpcReply to_json_rpc_reply() override;
+
 private:
     RespCommand _cmd;
 };
@@ -0,0 +1,423 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#include "sw/vector-engine/vector_collection.h"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <cmath>
+#include <mutex>
+#include <queue>
+#include "sw/vector-engine/errors.h"
+#include "sw/vector-engine/logger.h"
+#include "sw/vector-engine/parallel.h"
+
+namespace sw::vengine {
+
+std::string to_string(FilterStrategy strategy) {
+    switch (strategy) {
+    case FilterStrategy::NONE:
+        return "NONE";
+
+    case FilterStrategy::EXACT:
+        return "EXACT";
+
+    case FilterStrategy::FILTERED:
+        return "FILTERED";
+
+    case FilterStrategy::OVERSAMPLE:
+        return "OVERSAMPLE";
+
+    default:
+        throw Error("unknown filter strategy");
+    }
+}
+
+VectorCollection::VectorCollection(std::size_t dim,
+                                    Metric metric,
+                                    const IndexOptions &index_opts,
+                                    ElementType type) :
+    _storage(dim, type),
+    _metric(metric),
+    _index_opts(index_opts),
+    _index(IndexCreator{}.create(index_opts, _storage, metric)),
+    _raw_vectors(_index->needs_raw_vectors()) {}
+
+std::size_t VectorCollection::size() const {
+    std::shared_lock<std::shared_mutex> lock(_mutex);
+
+    return _ids.size();
+}
+
+bool VectorCollection::add(const std::string &key,
+                            const float *vec,
+                            const std::vector<Attribute> *attrs) {
+    assert(vec != nullptr);
+
+    VectorId id = 0;
+    uint64_t generation = 0;
+    auto added = false;
+    {
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+
+        if (attrs != nullptr) {
+            // Check before any change, so that a bad request leaves the collection untouched.
+            _attributes.check(*attrs);
+        }
+
+        auto iter = _ids.find(key);
+        if (iter != _ids.end()) {
+            id = iter->second;
+        } else {
+            id = _alloc_id();
+            _keys[id] = key;
+            _ids.emplace(key, id);
+            added = true;
+        }
+
+        _attributes.add(id);
+        if (attrs != nullptr) {
+            _attributes.set(id, *attrs);
+        }
+
+        if (_raw_vectors) {
+            _storage.set(id, vec);
+        }
+        _index->prepare(id);
+
+        generation = ++_add_cnt;
+        _add_generations[id] = generation;
+
+        if (!_index->concurrent_add()) {
+            _index->add(id, vec);
+
+            auto trainee = _index->start_training();
+            if (trainee) {
+                lock.unlock();
+                _schedule_training(std::move(trainee));
+            }
+
+            return added;
+        }
+    }
+
+    // Storage won't reallocate while we hold the shared lock, so the expensive
+    // part of indexing runs in parallel with other inserts and searches.
+    std::shared_lock<std::shared_mutex> lock(_mutex);
+
+    // Generations only change with exclusive access, so they're stable while we hold
+    // the shared lock. If the id has been updated, removed or reused since the exclusive
+    // phase, the latest add links it, and at most one add links an id at a time.
+    if (_add_generations[id] == generation) {
+        _index->add(id, vec);
+    }
+
+    return added;
+}
+
+std::optional<std::vector<float>> VectorCollection::get(const std::string &key) const {
+    std::shared_lock<std::shared_mutex> lock(_mutex);
+
+    auto iter = _ids.find(key);
+    if (iter == _ids.end()) {
+        return std::nullopt;
+    }
+
+    std::vector<float> vec(_storage.dim());
+    if (_raw_vectors) {
+        _storage.get(iter->second, vec.data());
+    } else {
+        _index->reconstruct(iter->second, vec.data());
+    }
+
+    return vec;
+}
+
+bool VectorCollection::remove(const std::string &key) {
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+
+    auto iter = _ids.find(key);
+    if (iter == _ids.end()) {
+        return false;
+    }
+
+    auto id = iter->second;
+    _ids.erase(iter);
+    _keys[id].clear();
+    _keys[id].shrink_to_fit();
+    _index->remove(id);
+    _attributes.remove(id);
+    _add_generations[id] = 0;
+    _free_ids.push_back(id);
+
+    return true;
+}
+
+std::vector<SearchResult> VectorCollection::search(const float *query,
+                                                    const SearchOptions &opts,
+                                                    const FilterProgram *filter,
+                                                    FilterStrategy *strategy) const {
+    assert(query != nullptr);
+
+    std::shared_lock<std::shared_mutex> lock(_mutex);
+
+    std::vector<Neighbor> neighbors;
+    auto used = FilterStrategy::NONE;
+    if (filter == nullptr) {
+        neighbors = _index->search(query, opts);
+    } else {
+        // Plan with the estimated number of matches, so that OVERSAMPLE, which only
+        // checks its candidates, never builds the bitmap of all matching ids.
+        auto matches = _attributes.estimate(*filter);
+        used = _plan(matches, opts.k);
+        if (used == FilterStrategy::OVERSAMPLE) {
+            neighbors = _search_oversample(query, opts, *filter,
+                    static_cast<double>(matches) / _ids.size());
+            if (neighbors.size() < std::min(opts.k, matches)) {
+                // Too few candidates match, the filter is not as broad around the query.
+                used = FilterStrategy::FILTERED;
+            }
+        }
+
+        if (used != FilterStrategy::OVERSAMPLE) {
+            auto ids = _attributes.evaluate(*filter);
+
+            // The estimate might be off, and the exact number picks between the two.
+            used = _plan(ids.cardinality(), opts.k) == FilterStrategy::EXACT ?
+                FilterStrategy::EXACT : FilterStrategy::FILTERED;
+            if (used == FilterStrategy::EXACT) {
+                neighbors = _search_exact(query, ids, opts.k);
+            } else {
+                auto filtered_opts = opts;
+                filtered_opts.filter = &ids;
+                neighbors = _index->search(query, filtered_opts);
+            }
+        }
+    }
+
+    if (strategy != nullptr) {
+        *strategy = used;
+    }
+
+    std::vector<SearchResult> results;
+    results.reserve(neighbors.size());
+    for (const auto &[dist, id] : neighbors) {
+        results.push_back(SearchResult{_keys[id], dist});
+    }
+
+    return results;
+}
+
+std::vector<std::vector<SearchResult>> VectorCollection::search_batch(
+        const std::vector<const float*> &queries,
+        const std::vector<SearchOptions> &opts) const {
+    assert(queries.size() == opts.size());
+
+    std::shared_lock<std::shared_mutex> lock(_mutex);
+
+    auto batch = _index->search_batch(queries, opts);
+
+    std::vector<std::vector<SearchResult>> results(batch.size());
+    for (std::size_t idx = 0; idx != batch.size(); ++idx) {
+        results[idx].reserve(batch[idx].size());
+        for (const auto &[dist, id] : batch[idx]) {
+            results[idx].push_back(SearchResult{_keys[id], dist});
+        }
+    }
+
+    return results;
+}
+
+std::size_t VectorCollection::memory_usage() const {
+    std::shared_lock<std::shared_mutex> lock(_mutex);
+
+    auto usage = _storage.memory_usage();
+    usage += _free_ids.capacity() * sizeof(VectorId);
+    usage += _keys.capacity() * sizeof(std::string);
+    usage += _add_generations.capacity() * sizeof(uint64_t);
+    usage += _index->memory_usage();
+    usage += _attributes.memory_usage();
+    for (const auto &key : _keys) {
+        if (key.capacity() > sizeof(std::string)) {
+            // Not in the small string buffer.
+            usage += key.capacity();
+        }
+    }
+
+    // Approximate the hash map with a node (key, id, next pointer) and a bucket per element.
+    usage += _ids.size() * (sizeof(std::string) + sizeof(VectorId) + 2 * sizeof(void*));
+    usage += _ids.bucket_count() * sizeof(void*);
+
+    return usage;
+}
+
+FilterStrategy VectorCollection::_plan(std::size_t matches, std::size_t k) const {
+    if (_index_opts.type == IndexType::FLAT) {
+        // The index only visits matching vectors, which is already exact.
+        return FilterStrategy::FILTERED;
+    }
+
+    auto size = static_cast<double>(_ids.size());
+    if (matches <= std::max(EXACT_MAX_MATCHES, k) || matches <= size * EXACT_MAX_SELECTIVITY) {
+        return FilterStrategy::EXACT;
+    }
+
+    if (_index_opts.type == IndexType::HNSW && matches >= size * OVERSAMPLE_MIN_SELECTIVITY) {
+        return FilterStrategy::OVERSAMPLE;
+    }
+
+    return FilterStrategy::FILTERED;
+}
+
+std::vector<Neighbor> VectorCollection::_search_exact(const float *query,
+                                                        const Bitmap &ids,
+                                                        std::size_t k) const {
+    if (k == 0) {
+        return {};
+    }
+
+    // Without raw vectors, compute distances to the ones reconstructed by the index.
+    auto distance = distance_func(_metric, _raw_vectors ? _storage.type() : ElementType::FLOAT32);
+    auto dim = _storage.dim();
+    std::vector<float> buf(_raw_vectors ? 0 : dim);
+
+    // Farthest one is on the top.
+    std::priority_queue<Neighbor> heap;
+    ids.for_each([&](VectorId id) {
+        const void *vec = nullptr;
+        if (_raw_vectors) {
+            vec = _storage.raw(id);
+        } else {
+            _index->reconstruct(id, buf.data());
+            vec = buf.data();
+        }
+
+        auto dist = distance(query, vec, dim);
+        if (heap.size() < k) {
+            heap.emplace(dist, id);
+        } else if (dist < heap.top().first) {
+            heap.pop();
+            heap.emplace(dist, id);
+        }
+    });
+
+    std::vector<Neighbor> neighbors(heap.size());
+    for (auto iter = neighbors.rbegin(); iter != neighbors.rend(); ++iter) {
+        *iter = heap.top();
+        heap.pop();
+    }
+
+    return neighbors;
+}
+
+std::vector<Neighbor> VectorCollection::_search_oversample(const float *query,
+                                                            const SearchOptions &opts,
+                                                            const FilterProgram &filter,
+                                                            double selectivity) const {
+    assert(selectivity > 0);
+
+    // About `k` matching ones are expected in `k / selectivity` candidates,
+    // and HNSW enlarges ef to the new `k` if it's smaller.
+    auto oversample_opts = opts;
+    oversample_opts.k = static_cast<std::size_t>(
+            std::ceil(opts.k / selectivity * OVERSAMPLE_FACTOR));
+
+    auto candidates = _index->search(query, oversample_opts);
+
+    Bitmap candidate_ids;
+    for (const auto &candidate : candidates) {
+        candidate_ids.add(candidate.second);
+    }
+    auto ids = _attributes.evaluate(filter, candidate_ids);
+
+    std::vector<Neighbor> neighbors;
+    neighbors.reserve(opts.k);
+    for (const auto &candidate : candidates) {
+        if (neighbors.size() == opts.k) {
+            break;
+        }
+
+        if (ids.contains(candidate.second)) {
+            neighbors.push_back(candidate);
+        }
+    }
+
+    return neighbors;
+}
+
+void VectorCollection::_schedule_training(IndexUPtr trainee) {
+    auto self = weak_from_this().lock();
+    if (!self) {
+        // Not owned by a std::shared_ptr, so the collection might be gone before the job runs.
+        _train_index(std::move(trainee));
+        return;
+    }
+
+    // std::function must be copyable, so the trainee is moved out of a shared holder.
+    auto holder = std::make_shared<IndexUPtr>(std::move(trainee));
+    post([self, holder]() { self->_train_index(std::move(*holder)); });
+}
+
+void VectorCollection::_train_index(IndexUPtr trainee) noexcept {
+    // Nobody waits for the result, so errors are logged instead of thrown.
+    auto failed = true;
+    try {
+        trainee->train();
+        failed = false;
+    } catch (const std::exception &e) {
+        VECTOR_ENGINE_ERROR("failed to train index: {}", e.what());
+    } catch (...) {
+        VECTOR_ENGINE_ERROR("failed to train index: unknown error");
+    }
+
+    if (failed) {
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+
+        // Keep serving with the untrained index, and training starts over with later adds.
+        _index->finish_training(nullptr);
+
+        return;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+
+    _index->finish_training(trainee.get());
+    _index = std::move(trainee);
+}
+
+VectorId VectorCollection::_alloc_id() {
+    if (!_free_ids.empty()) {
+        auto id = _free_ids.back();
+        _free_ids.pop_back();
+        return id;
+    }
+
+    if (_id_cnt > std::numeric_limits<VectorId>::max()) {
+        throw Error("too many vectors in collection");
+    }
+
+    auto id = static_cast<VectorId>(_id_cnt++);
+    if (_raw_vectors && id >= _storage.capacity()) {
+        _storage.reserve(std::max<std::size_t>(16, _storage.capacity() * 2));
+    }
+
+    _keys.resize(_id_cnt);
+    _add_generations.resize(_id_cnt);
+
+    return id;
+}
+
+}
@@ -0,0 +1,196 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#ifndef SW_VECTOR_ENGINE_VECTOR_COLLECTION_H
+#define SW_VECTOR_ENGINE_VECTOR_COLLECTION_H
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "sw/vector-engine/attribute_index.h"
+#include "sw/vector-engine/distance.h"
+#include "sw/vector-engine/filter_program.h"
+#include "sw/vector-engine/index.h"
+#include "sw/vector-engine/vector_storage.h"
+
+namespace sw::vengine {
+
+struct SearchResult {
+    std::string key;
+    float distance;
+};
+
+// How a filtered search is executed. It's picked by the selectivity of the filter,
+// i.e. the ratio of matching elements.
+enum class FilterStrategy {
+    // No filter.
+    NONE = 0,
+
+    // Compute distances to all matching elements, for very selective filters.
+    EXACT,
+
+    // The index only returns matching elements, e.g. scans skip others,
+    // and HNSW expands through others but doesn't return them.
+    FILTERED,
+
+    // Search the index without filter for more candidates, and drop the non-matching ones.
+    // Only used by HNSW with broad filters, and fall back to FILTERED if too few are left.
+    OVERSAMPLE
+};
+
+std::string to_string(FilterStrategy strategy);
+
+// A set of fixed dimension vectors, each of which is identified by a string key.
+// Keys are mapped to dense internal ids, and ids of deleted vectors are reused.
+// Elements might have typed attributes, and searches can be filtered by them.
+// All methods are thread-safe. Indexes learned from data are trained by the worker
+// pool in background, which holds a reference to the collection if it's owned by
+// a std::shared_ptr, otherwise, they're trained by the `add` that triggers it.
+class VectorCollection : public std::enable_shared_from_this<VectorCollection> {
+public:
+    explicit VectorCollection(std::size_t dim,
+                                Metric metric = Metric::L2,
+                                const IndexOptions &index_opts = {},
+                                ElementType type = ElementType::FLOAT32);
+
+    VectorCollection(const VectorCollection &) = delete;
+    VectorCollection& operator=(const VectorCollection &) = delete;
+
+    VectorCollection(VectorCollection &&) = delete;
+    VectorCollection& operator=(VectorCollection &&) = delete;
+
+    ~VectorCollection() = default;
+
+    std::size_t dim() const noexcept {
+        return _storage.dim();
+    }
+
+    Metric metric() const noexcept {
+        return _metric;
+    }
+
+    ElementType type() const noexcept {
+        return _storage.type();
+    }
+
+    const IndexOptions& index_options() const noexcept {
+        return _index_opts;
+    }
+
+    std::size_t size() const;
+
+    // `vec` must have `dim()` floats. If `attrs` is not nullptr, it replaces attributes
+    // of the element, otherwise, attributes of an existing element are kept.
+    // Throw Error if attributes conflict with types of existing ones.
+    // @return true if it's a new element, false if the vector of an existing element is updated.
+    bool add(const std::string &key, const float *vec, const std::vector<Attribute> *attrs = nullptr);
+
+    std::optional<std::vector<float>> get(const std::string &key) const;
+
+    // @return true if the element exists and has been removed.
+    bool remove(const std::string &key);
+
+    // @return at most `opts.k` nearest elements which match `filter`, sorted by distance
+    //         in ascending order. The search is exact or approximate, depending on the index type.
+    // If `strategy` is not nullptr, it's set to the strategy used for the filter.
+    std::vector<SearchResult> search(const float *query,
+                                        const SearchOptions &opts,
+                                        const FilterProgram *filter = nullptr,
+                                        FilterStrategy *strategy = nullptr) const;
+
+    // Search a batch of queries under a single lock, and `opts[i]` is the options of
+    // `queries[i]`. FLAT and IVF indexes scan vectors once for all queries.
+    std::vector<std::vector<SearchResult>> search_batch(const std::vector<const float*> &queries,
+                                                        const std::vector<SearchOptions> &opts) const;
+
+    // Bytes used by vectors, keys, index and bookkeeping.
+    std::size_t memory_usage() const;
+
+private:
+    // Matching elements no more than this number, or this ratio of all elements,
+    // are searched exactly, since that costs fewer distances than a filtered index search.
+    static constexpr std::size_t EXACT_MAX_MATCHES = 2048;
+    static constexpr double EXACT_MAX_SELECTIVITY = 0.02;
+
+    // HNSW oversamples filters which match at least this ratio of elements.
+    static constexpr double OVERSAMPLE_MIN_SELECTIVITY = 0.5;
+
+    // Extra candidates searched by OVERSAMPLE, besides the expected `k / selectivity` ones.
+    static constexpr double OVERSAMPLE_FACTOR = 1.5;
+
+    VectorId _alloc_id();
+
+    // Train `trainee` in background, without blocking the add that triggers it.
+    void _schedule_training(IndexUPtr trainee);
+
+    // Train a copy of the index without the lock, and replace the index with it.
+    // If training fails, the error is logged, and the index is kept untrained.
+    void _train_index(IndexUPtr trainee) noexcept;
+
+    FilterStrategy _plan(std::size_t matches, std::size_t k) const;
+
+    std::vector<Neighbor> _search_exact(const float *query, const Bitmap &ids, std::size_t k) const;
+
+    // Search without filter for more candidates, and drop the ones not matching `filter`.
+    std::vector<Neighbor> _search_oversample(const float *query,
+                                                const SearchOptions &opts,
+                                                const FilterProgram &filter,
+                                                double selectivity) const;
+
+    mutable std::shared_mutex _mutex;
+
+    VectorStorage _storage;
+
+    Metric _metric;
+
+    IndexOptions _index_opts;
+
+    IndexUPtr _index;
+
+    AttributeIndex _attributes;
+
+    // Whether raw vectors are kept in `_storage`. If not, vectors are reconstructed by the index.
+    bool _raw_vectors;
+
+    // Number of ids that have ever been allocated.
+    std::size_t _id_cnt = 0;
+
+    // Ids of deleted vectors, which can be reused.
+    std::vector<VectorId> _free_ids;
+
+    // id -> key, and key of a deleted id is cleared.
+    std::vector<std::string> _keys;
+
+    // Number of adds, which numbers generations of ids.
+    uint64_t _add_cnt = 0;
+
+    // id -> generation of its latest add, and 0 if the id is deleted.
+    // A concurrent add only links an id whose generation is still its own.
+    std::vector<uint64_t> _add_generations;
+
+    // key -> id
+    std::unordered_map<std::string, VectorId> _ids;
+};
+
+using VectorCollectionSPtr = std::shared_ptr<VectorCollection>;
+
+}
+
+#endif // end SW_VECTOR_ENGINE_VECTOR_COLLECTION_H
@@ -0,0 +1,127 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#include "sw/vector-engine/vector_storage.h"
+#include <algorithm>
+#include <cassert>
+#include <new>
+#include "sw/vector-engine/errors.h"
+
+namespace sw::vengine {
+
+namespace {
+
+unsigned char* alloc_bytes(std::size_t num) {
+    return static_cast<unsigned char*>(::operator new(num, std::align_val_t(VectorStorage::ALIGNMENT)));
+}
+
+void free_bytes(unsigned char *data) noexcept {
+    ::operator delete(data, std::align_val_t(VectorStorage::ALIGNMENT));
+}
+
+}
+
+VectorStorage::VectorStorage(std::size_t dim, ElementType type) :
+    _dim(dim),
+    _type(type),
+    _element_size(element_size(type)) {
+    if (_dim == 0) {
+        throw Error("dimension of vector must larger than 0");
+    }
+
+    auto elements_per_line = ALIGNMENT / _element_size;
+    _stride = (_dim + elements_per_line - 1) / elements_per_line * elements_per_line;
+}
+
+VectorStorage::~VectorStorage() {
+    if (_data != nullptr) {
+        free_bytes(_data);
+    }
+}
+
+void VectorStorage::reserve(std::size_t capacity) {
+    if (capacity <= _capacity) {
+        return;
+    }
+
+    auto vector_size = _stride * _element_size;
+    auto *data = alloc_bytes(capacity * vector_size);
+    if (_data != nullptr) {
+        std::copy(_data, _data + _capacity * vector_size, data);
+        free_bytes(_data);
+    }
+
+    // Padding must be zero, so that kernels can scan the whole stride.
+    // All-zero bits are 0.0 of all element types.
+    std::fill(data + _capacity * vector_size, data + capacity * vector_size, 0);
+
+    _data = data;
+    _capacity = capacity;
+}
+
+void VectorStorage::set(VectorId id, const float *vec) {
+    assert(id < _capacity && vec != nullptr);
+
+    switch (_type) {
+    case ElementType::FLOAT16: {
+        auto *out = static_cast<uint16_t*>(raw(id));
+        for (std::size_t i = 0; i != _dim; ++i) {
+            out[i] = float_to_fp16(vec[i]);
+        }
+        break;
+    }
+
+    case ElementType::BFLOAT16: {
+        auto *out = static_cast<uint16_t*>(raw(id));
+        for (std::size_t i = 0; i != _dim; ++i) {
+            out[i] = float_to_bf16(vec[i]);
+        }
+        break;
+    }
+
+    default:
+        std::copy(vec, vec + _dim, data(id));
+        break;
+    }
+}
+
+void VectorStorage::get(VectorId id, float *vec) const {
+    assert(id < _capacity && vec != nullptr);
+
+    switch (_type) {
+    case ElementType::FLOAT16: {
+        const auto *in = static_cast<const uint16_t*>(raw(id));
+        for (std::size_t i = 0; i != _dim; ++i) {
+            vec[i] = fp16_to_float(in[i]);
+        }
+        break;
+    }
+
+    case ElementType::BFLOAT16: {
+        const auto *in = static_cast<const uint16_t*>(raw(id));
+        for (std::size_t i = 0; i != _dim; ++i) {
+            vec[i] = bf16_to_float(in[i]);
+        }
+        break;
+    }
+
+    default:
+        std::copy(data(id), data(id) + _dim, vec);
+        break;
+    }
+}
+
+}
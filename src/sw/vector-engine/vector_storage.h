@@ -0,0 +1,114 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#ifndef SW_VECTOR_ENGINE_VECTOR_STORAGE_H
+#define SW_VECTOR_ENGINE_VECTOR_STORAGE_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include "sw/vector-engine/element_type.h"
+
+namespace sw::vengine {
+
+using VectorId = uint32_t;
+
+// Contiguous storage of fixed dimension vectors indexed by dense ids. Elements are
+// float32, or half precision types, which are converted from float32 when set.
+// Each vector is padded with zeros to a multiple of 64 bytes, so that every
+// vector starts at a 64-byte aligned address.
+class VectorStorage {
+public:
+    static constexpr std::size_t ALIGNMENT = 64;
+
+    explicit VectorStorage(std::size_t dim, ElementType type = ElementType::FLOAT32);
+
+    VectorStorage(const VectorStorage &) = delete;
+    VectorStorage& operator=(const VectorStorage &) = delete;
+
+    VectorStorage(VectorStorage &&) = delete;
+    VectorStorage& operator=(VectorStorage &&) = delete;
+
+    ~VectorStorage();
+
+    std::size_t dim() const noexcept {
+        return _dim;
+    }
+
+    ElementType type() const noexcept {
+        return _type;
+    }
+
+    // Number of elements between the beginning of two consecutive vectors.
+    std::size_t stride() const noexcept {
+        return _stride;
+    }
+
+    std::size_t capacity() const noexcept {
+        return _capacity;
+    }
+
+    // Grow the storage to hold at least `capacity` vectors. Pointers returned
+    // by `data` are invalidated if it reallocates.
+    void reserve(std::size_t capacity);
+
+    // Only for FLOAT32 storage.
+    float* data(VectorId id) noexcept {
+        assert(_type == ElementType::FLOAT32);
+        return reinterpret_cast<float*>(raw(id));
+    }
+
+    const float* data(VectorId id) const noexcept {
+        assert(_type == ElementType::FLOAT32);
+        return reinterpret_cast<const float*>(raw(id));
+    }
+
+    // Vector of any element type.
+    void* raw(VectorId id) noexcept {
+        return _data + static_cast<std::size_t>(id) * _stride * _element_size;
+    }
+
+    const void* raw(VectorId id) const noexcept {
+        return _data + static_cast<std::size_t>(id) * _stride * _element_size;
+    }
+
+    // Convert `dim` floats to the element type, and store them.
+    void set(VectorId id, const float *vec);
+
+    // Widen the vector to `dim` floats.
+    void get(VectorId id, float *vec) const;
+
+    std::size_t memory_usage() const noexcept {
+        return _capacity * _stride * _element_size;
+    }
+
+private:
+    std::size_t _dim;
+
+    ElementType _type;
+
+    std::size_t _element_size;
+
+    std::size_t _stride;
+
+    std::size_t _capacity = 0;
+
+    unsigned char *_data = nullptr;
+};
+
+}
+
+#endif // end SW_VECTOR_ENGINE_VECTOR_STORAGE_H
@@ -0,0 +1,628 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#include "sw/vector-engine/vector_task.h"
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include "sw/vector-engine/collection_manager.h"
+#include "sw/vector-engine/errors.h"
+#include "sw/vector-engine/str_utils.h"
+
+namespace sw::vengine {
+
+namespace {
+
+std::size_t parse_uint(std::string_view arg, const std::string &name) {
+    std::size_t num = 0;
+    auto *last = arg.data() + arg.size();
+    auto [ptr, err] = std::from_chars(arg.data(), last, num);
+    if (err != std::errc() || ptr != last) {
+        throw Error("invalid " + name + ": " + std::string(arg));
+    }
+
+    return num;
+}
+
+std::size_t parse_uint(std::string_view arg, const std::string &name, std::size_t max) {
+    auto num = parse_uint(arg, name);
+    if (num > max) {
+        throw Error(name + " must be at most " + std::to_string(max));
+    }
+
+    return num;
+}
+
+float parse_float(std::string_view arg) {
+    float num = 0;
+    auto *last = arg.data() + arg.size();
+    auto [ptr, err] = std::from_chars(arg.data(), last, num);
+    if (err != std::errc() || ptr != last) {
+        throw Error("invalid float: " + std::string(arg));
+    }
+
+    return num;
+}
+
+Attribute parse_attribute(AttributeType type, std::string_view name, std::string_view val) {
+    Attribute attr;
+    attr.name = std::string(name);
+    attr.type = type;
+
+    auto *last = val.data() + val.size();
+    switch (type) {
+    case AttributeType::TAG:
+        attr.tag = std::string(val);
+        break;
+
+    case AttributeType::INT: {
+        auto [ptr, err] = std::from_chars(val.data(), last, attr.integer);
+        if (err != std::errc() || ptr != last) {
+            throw Error("invalid INT attribute: " + std::string(val));
+        }
+        break;
+    }
+
+    default: {
+        auto [ptr, err] = std::from_chars(val.data(), last, attr.number);
+        if (err != std::errc() || ptr != last || !std::isfinite(attr.number)) {
+            throw Error("invalid FLOAT attribute: " + std::string(val));
+        }
+        break;
+    }
+    }
+
+    return attr;
+}
+
+void append_float(RespReplyBuilder &builder, float val) {
+    char buf[32];
+    auto [ptr, err] = std::to_chars(buf, buf + sizeof(buf), val);
+    assert(err == std::errc());
+    builder.append_bulk_string(std::string_view(buf, ptr - buf));
+}
+
+void check_argc(const RespCommand &cmd, std::size_t argc) {
+    if (cmd.args.size() != argc) {
+        throw Error("wrong number of arguments for '" + str::to_lower(cmd.name) + "' command");
+    }
+}
+
+}
+
+void VectorTask::from_resp_command(RespCommand cmd) {
+    try {
+        _parse(cmd);
+    } catch (const std::exception &e) {
+        _error = e.what();
+    }
+}
+
+void VectorTask::from_json_rpc_request(JsonRpcRequest /*req*/) {
+    _error = "JSON-RPC is not supported for vector commands";
+}
+
+TaskOutputUPtr VectorTask::run() {
+    if (_error) {
+        return std::make_unique<ErrorOutput>(*_error);
+    }
+
+    try {
+        return _run();
+    } catch (const std::exception &e) {
+        return std::make_unique<ErrorOutput>(e.what());
+    }
+}
+
+JsonRpcReply VectorTaskOutput::to_json_rpc_reply() {
+    throw Error("JSON-RPC is not supported for vector commands");
+}
+
+void VectorArg::parse(const RespCommand &cmd, std::size_t &idx) {
+    const auto &args = cmd.args;
+    if (idx >= args.size()) {
+        throw Error("expect VALUES, FP32, FP16 or BF16");
+    }
+
+    auto format = str::to_lower(args[idx++]);
+    if (format == "fp32" || format == "fp16" || format == "bf16") {
+        if (idx >= args.size()) {
+            throw Error("expect blob of vector");
+        }
+
+        _type = parse_element_type(format);
+        _blob = args[idx++];
+
+        auto size = element_size(_type);
+        if (_blob.empty() || _blob.size() % size != 0) {
+            throw Error("invalid length of " + to_string(_type) + " blob: "
+                    + std::to_string(_blob.size()));
+        }
+        _size = _blob.size() / size;
+    } else if (format == "values") {
+        if (idx >= args.size()) {
+            throw Error("expect number of values");
+        }
+        auto num = parse_uint(args[idx++], "number of values");
+        if (num == 0) {
+            throw Error("number of values must larger than 0");
+        }
+
+        if (args.size() - idx < num) {
+            throw Error("not enough values");
+        }
+
+        _values.assign(args.begin() + idx, args.begin() + idx + num);
+        idx += num;
+        _size = num;
+    } else {
+        throw Error("expect VALUES, FP32, FP16 or BF16");
+    }
+
+    _pins = cmd.pins;
+}
+
+void VectorArg::decode() {
+    if (_data != nullptr) {
+        return;
+    }
+
+    if (!_values.empty()) {
+        _vec.reserve(_values.size());
+        for (const auto &val : _values) {
+            _vec.push_back(parse_float(val));
+        }
+        _data = _vec.data();
+    } else if (_type == ElementType::FLOAT32) {
+        _decode_fp32_blob();
+    } else {
+        _decode_half_blob();
+    }
+}
+
+void VectorArg::_decode_fp32_blob() {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    if (reinterpret_cast<std::uintptr_t>(_blob.data()) % alignof(float) == 0) {
+        _data = reinterpret_cast<const float*>(_blob.data());
+        return;
+    }
+
+    _vec.resize(_size);
+    std::memcpy(_vec.data(), _blob.data(), _blob.size());
+#else
+    _vec.resize(_size);
+    const auto *bytes = reinterpret_cast<const unsigned char*>(_blob.data());
+    for (std::size_t i = 0; i != _size; ++i) {
+        uint32_t bits = 0;
+        for (std::size_t b = 0; b != sizeof(float); ++b) {
+            bits |= static_cast<uint32_t>(bytes[i * sizeof(float) + b]) << (8 * b);
+        }
+        std::memcpy(&_vec[i], &bits, sizeof(float));
+    }
+#endif
+
+    _data = _vec.data();
+}
+
+void VectorArg::_decode_half_blob() {
+    _vec.resize(_size);
+    const auto *bytes = reinterpret_cast<const unsigned char*>(_blob.data());
+    for (std::size_t i = 0; i != _size; ++i) {
+        auto val = static_cast<uint16_t>(bytes[2 * i] | (bytes[2 * i + 1] << 8));
+        _vec[i] = _type == ElementType::FLOAT16 ? fp16_to_float(val) : bf16_to_float(val);
+    }
+
+    _data = _vec.data();
+}
+
+RespReply ErrorOutput::to_resp_reply() {
+    RespReplyBuilder builder;
+    builder.append_error("ERR " + _err);
+
+    return builder.data();
+}
+
+RespReply IntegerOutput::to_resp_reply() {
+    RespReplyBuilder builder;
+    builder.append_integer(_num);
+
+    return builder.data();
+}
+
+void VAddTask::_parse(RespCommand &cmd) {
+    const auto &args = cmd.args;
+    if (args.empty()) {
+        throw Error("wrong number of arguments for 'vadd' command");
+    }
+
+    std::size_t idx = 0;
+    _key = std::string(args[idx++]);
+    _vec.parse(cmd, idx);
+
+    if (idx >= args.size()) {
+        throw Error("wrong number of arguments for 'vadd' command");
+    }
+    _element = std::string(args[idx++]);
+
+    while (idx < args.size()) {
+        auto opt = str::to_lower(args[idx++]);
+        if (opt != "tag" && opt != "int" && opt != "float") {
+            throw Error("unknown option: " + opt);
+        }
+
+        if (idx + 2 > args.size()) {
+            throw Error("expect name and value of " + opt + " attribute");
+        }
+
+        _attr_args.emplace_back(parse_attribute_type(opt), args[idx], args[idx + 1]);
+        idx += 2;
+    }
+}
+
+TaskOutputUPtr VAddTask::_run() {
+    // Decode arguments before creating the collection, so that a bad request changes nothing.
+    _vec.decode();
+
+    std::optional<std::vector<Attribute>> attrs;
+    if (!_attr_args.empty()) {
+        attrs.emplace();
+        attrs->reserve(_attr_args.size());
+        for (const auto &[type, name, val] : _attr_args) {
+            attrs->push_back(parse_attribute(type, name, val));
+        }
+    }
+
+    auto collection = CollectionManager::instance().get_or_create(_key, _vec.size());
+    auto added = collection->add(_element, _vec.data(), attrs ? &*attrs : nullptr);
+
+    return std::make_unique<IntegerOutput>(added ? 1 : 0);
+}
+
+void VGetTask::_parse(RespCommand &cmd) {
+    check_argc(cmd, 2);
+
+    _key = std::string(cmd.args[0]);
+    _element = std::string(cmd.args[1]);
+}
+
+TaskOutputUPtr VGetTask::_run() {
+    auto collection = CollectionManager::instance().get(_key);
+    if (!collection) {
+        return std::make_unique<VGetOutput>(std::nullopt);
+    }
+
+    return std::make_unique<VGetOutput>(collection->get(_element));
+}
+
+RespReply VGetOutput::to_resp_reply() {
+    RespReplyBuilder builder;
+    if (!_vec) {
+        builder.append_nil();
+        return builder.data();
+    }
+
+    builder.append_array(_vec->size());
+    for (auto val : *_vec) {
+        append_float(builder, val);
+    }
+
+    return builder.data();
+}
+
+void VDelTask::_parse(RespCommand &cmd) {
+    check_argc(cmd, 2);
+
+    _key = std::string(cmd.args[0]);
+    _element = std::string(cmd.args[1]);
+}
+
+TaskOutputUPtr VDelTask::_run() {
+    auto collection = CollectionManager::instance().get(_key);
+    if (!collection) {
+        return std::make_unique<IntegerOutput>(0);
+    }
+
+    return std::make_unique<IntegerOutput>(collection->remove(_element) ? 1 : 0);
+}
+
+void VCreateTask::_parse(RespCommand &cmd) {
+    const auto &args = cmd.args;
+    if (args.size() < 3) {
+        throw Error("wrong number of arguments for 'vcreate' command");
+    }
+
+    _key = std::string(args[0]);
+
+    if (str::to_lower(args[1]) != "dim") {
+        throw Error("expect DIM");
+    }
+    _dim = parse_uint(args[2], "dimension");
+    if (_dim == 0) {
+        throw Error("dimension must larger than 0");
+    }
+
+    for (std::size_t idx = 3; idx < args.size(); idx += 2) {
+        auto opt = str::to_lower(args[idx]);
+        if (idx + 1 >= args.size()) {
+            throw Error("expect value for " + opt);
+        }
+
+        const auto &val = args[idx + 1];
+        if (opt == "metric") {
+            _metric = parse_metric(val);
+        } else if (opt == "type") {
+            _type = parse_element_type(val);
+        } else if (opt == "index") {
+            _index_opts.type = parse_index_type(val);
+        } else if (opt == "m") {
+            _index_opts.m = parse_uint(val, "M");
+        } else if (opt == "ef_construction") {
+            _index_opts.ef_construction = parse_uint(val, "EF_CONSTRUCTION");
+        } else if (opt == "nlist") {
+            _index_opts.nlist = parse_uint(val, "NLIST", MAX_NLIST);
+        } else if (opt == "nprobe") {
+            _index_opts.nprobe = parse_uint(val, "NPROBE", MAX_NLIST);
+        } else if (opt == "pq_m") {
+            _index_opts.pq_m = parse_uint(val, "PQ_M", MAX_PQ_M);
+        } else if (opt == "pq_bits") {
+            _index_opts.pq_bits = parse_uint(val, "PQ_BITS");
+            if (_index_opts.pq_bits != 8 && _index_opts.pq_bits != 4) {
+                throw Error("PQ_BITS must be 8 or 4");
+            }
+        } else if (opt == "sq_range") {
+            auto range = str::to_lower(val);
+            if (range == "per_dim") {
+                _index_opts.sq_per_dim = true;
+            } else if (range == "global") {
+                _index_opts.sq_per_dim = false;
+            } else {
+                throw Error("SQ_RANGE must be PER_DIM or GLOBAL");
+            }
+        } else if (opt == "oversample") {
+            _index_opts.oversample = parse_uint(val, "OVERSAMPLE", MAX_FACTOR);
+        } else if (opt == "rerank") {
+            _index_opts.rerank = parse_uint(val, "RERANK", MAX_FACTOR);
+        } else {
+            throw Error("unknown option: " + opt);
+        }
+    }
+}
+
+TaskOutputUPtr VCreateTask::_run() {
+    if (!CollectionManager::instance().create(_key, _dim, _metric, _index_opts, _type)) {
+        throw Error("collection already exists");
+    }
+
+    return std::make_unique<OkOutput>();
+}
+
+RespReply OkOutput::to_resp_reply() {
+    RespReplyBuilder builder;
+    builder.append_ok();
+
+    return builder.data();
+}
+
+void VSimTask::_parse(RespCommand &cmd) {
+    const auto &args = cmd.args;
+    if (args.empty()) {
+        throw Error("wrong number of arguments for 'vsim' command");
+    }
+
+    std::size_t idx = 0;
+    _key = std::string(args[idx++]);
+    _query.parse(cmd, idx);
+
+    while (idx < args.size()) {
+        auto opt = str::to_lower(args[idx++]);
+        if (opt == "count") {
+            if (idx >= args.size()) {
+                throw Error("expect value for COUNT");
+            }
+            _opts.k = parse_uint(args[idx++], "count");
+            if (_opts.k > MAX_COUNT) {
+                throw Error("COUNT must be at most " + std::to_string(MAX_COUNT));
+            }
+        } else if (opt == "ef") {
+            if (idx >= args.size()) {
+                throw Error("expect value for EF");
+            }
+            _opts.ef = parse_uint(args[idx++], "EF");
+        } else if (opt == "nprobe") {
+            if (idx >= args.size()) {
+                throw Error("expect value for NPROBE");
+            }
+            _opts.nprobe = parse_uint(args[idx++], "NPROBE");
+        } else if (opt == "filter") {
+            if (idx >= args.size()) {
+                throw Error("expect value for FILTER");
+            }
+            _filter_expr = args[idx++];
+        } else if (opt == "withscores") {
+            _with_scores = true;
+        } else if (opt == "withplan") {
+            _with_plan = true;
+        } else {
+            throw Error("unknown option: " + opt);
+        }
+    }
+}
+
+TaskOutputUPtr VSimTask::_run() {
+    _query.decode();
+
+    FilterProgramSPtr filter;
+    if (_filter_expr) {
+        filter = FilterProgramCache::instance().get(*_filter_expr);
+    }
+
+    auto collection = CollectionManager::instance().get(_key);
+    if (!collection) {
+        std::optional<FilterStrategy> plan;
+        if (_with_plan) {
+            plan = FilterStrategy::NONE;
+        }
+
+        return std::make_unique<VSimOutput>(std::vector<SearchResult>{}, _with_scores, plan);
+    }
+
+    if (collection->dim() != _query.size()) {
+        throw Error("dimension mismatch, expect " + std::to_string(collection->dim())
+                + ", got " + std::to_string(_query.size()));
+    }
+
+    auto opts = _opts;
+    opts.k = std::min(opts.k, collection->size());
+
+    auto strategy = FilterStrategy::NONE;
+    auto results = collection->search(_query.data(), opts, filter.get(), &strategy);
+
+    std::optional<FilterStrategy> plan;
+    if (_with_plan) {
+        plan = strategy;
+    }
+
+    return std::make_unique<VSimOutput>(std::move(results), _with_scores, plan);
+}
+
+std::vector<TaskOutputUPtr> VSimTask::run_batch(const std::vector<Task*> &tasks) {
+    assert(!tasks.empty());
+
+    auto collection = CollectionManager::instance().get(_key);
+    if (!collection) {
+        return VectorTask::run_batch(tasks);
+    }
+
+    // Tasks with the wrong dimension run alone, and fail with their own error.
+    std::vector<TaskOutputUPtr> outputs(tasks.size());
+    std::vector<std::size_t> members;
+    std::vector<const float*> queries;
+    std::vector<SearchOptions> opts;
+    auto size = collection->size();
+    for (std::size_t idx = 0; idx != tasks.size(); ++idx) {
+        auto *task = static_cast<VSimTask*>(tasks[idx]);
+        if (task->_query.size() != collection->dim()) {
+            outputs[idx] = task->run();
+            continue;
+        }
+
+        try {
+            task->_query.decode();
+        } catch (const std::exception &e) {
+            outputs[idx] = std::make_unique<ErrorOutput>(e.what());
+            continue;
+        }
+
+        members.push_back(idx);
+        queries.push_back(task->_query.data());
+        opts.push_back(task->_opts);
+        opts.back().k = std::min(opts.back().k, size);
+    }
+
+    if (members.empty()) {
+        return outputs;
+    }
+
+    try {
+        auto results = collection->search_batch(queries, opts);
+        for (std::size_t idx = 0; idx != members.size(); ++idx) {
+            auto *task = static_cast<VSimTask*>(tasks[members[idx]]);
+            std::optional<FilterStrategy> plan;
+            if (task->_with_plan) {
+                // Batched searches have no filter.
+                plan = FilterStrategy::NONE;
+            }
+
+            outputs[members[idx]] = std::make_unique<VSimOutput>(std::move(results[idx]),
+                    task->_with_scores, plan);
+        }
+    } catch (const std::exception &e) {
+        for (auto idx : members) {
+            outputs[idx] = std::make_unique<ErrorOutput>(e.what());
+        }
+    }
+
+    return outputs;
+}
+
+RespReply VSimOutput::to_resp_reply() {
+    RespReplyBuilder builder;
+    auto size = _with_scores ? _results.size() * 2 : _results.size();
+    if (_plan) {
+        builder.append_array(size + 1);
+        builder.append_bulk_string(to_string(*_plan));
+    } else {
+        builder.append_array(size);
+    }
+
+    for (const auto &result : _results) {
+        builder.append_bulk_string(result.key);
+        if (_with_scores) {
+            append_float(builder, result.distance);
+        }
+    }
+
+    return builder.data();
+}
+
+void VInfoTask::_parse(RespCommand &cmd) {
+    check_argc(cmd, 1);
+
+    _key = std::string(cmd.args[0]);
+}
+
+TaskOutputUPtr VInfoTask::_run() {
+    auto collection = CollectionManager::instance().get(_key);
+    if (!collection) {
+        return std::make_unique<VInfoOutput>(std::nullopt);
+    }
+
+    CollectionInfo info;
+    info.dim = collection->dim();
+    info.metric = collection->metric();
+    info.type = collection->type();
+    info.index = collection->index_options().type;
+    info.size = collection->size();
+    info.memory_usage = collection->memory_usage();
+
+    return std::make_unique<VInfoOutput>(info);
+}
+
+RespReply VInfoOutput::to_resp_reply() {
+    RespReplyBuilder builder;
+    if (!_info) {
+        builder.append_nil();
+        return builder.data();
+    }
+
+    builder.append_array(14);
+    builder.append_bulk_string("dim").append_integer(_info->dim);
+    builder.append_bulk_string("metric").append_bulk_string(to_string(_info->metric));
+    builder.append_bulk_string("type").append_bulk_string(to_string(_info->type));
+    builder.append_bulk_string("index").append_bulk_string(to_string(_info->index));
+    builder.append_bulk_string("size").append_integer(_info->size);
+    builder.append_bulk_string("memory").append_integer(_info->memory_usage);
+    builder.append_bulk_string("bytes_per_vector")
+        .append_integer(_info->size == 0 ? 0 : _info->memory_usage / _info->size);
+
+    return builder.data();
+}
+
+}
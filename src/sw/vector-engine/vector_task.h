@@ -0,0 +1,356 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#ifndef SW_VECTOR_ENGINE_VECTOR_TASK_H
+#define SW_VECTOR_ENGINE_VECTOR_TASK_H
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+#include "sw/vector-engine/task.h"
+#include "sw/vector-engine/resp.h"
+#include "sw/vector-engine/distance.h"
+#include "sw/vector-engine/vector_collection.h"
+
+namespace sw::vengine {
+
+// Base class of vector commands. Invalid arguments and failures are replied
+// as errors, instead of closing the connection.
+class VectorTask : public Task {
+public:
+    virtual void from_resp_command(RespCommand cmd) override;
+
+    virtual void from_json_rpc_request(JsonRpcRequest req) override;
+
+    virtual TaskOutputUPtr run() override;
+
+    // Invalid commands are never batched.
+    virtual std::string batch_key() const override {
+        return _error ? std::string() : _batch_key();
+    }
+
+protected:
+    // Throw Error if the command is invalid.
+    virtual void _parse(RespCommand &cmd) = 0;
+
+    virtual TaskOutputUPtr _run() = 0;
+
+    virtual std::string _batch_key() const {
+        return {};
+    }
+
+private:
+    std::optional<std::string> _error;
+};
+
+class VectorTaskOutput : public TaskOutput {
+public:
+    virtual JsonRpcReply to_json_rpc_reply() override;
+};
+
+class ErrorOutput : public VectorTaskOutput {
+public:
+    explicit ErrorOutput(std::string err) : _err(std::move(err)) {}
+
+    virtual RespReply to_resp_reply() override;
+
+private:
+    std::string _err;
+};
+
+class IntegerOutput : public VectorTaskOutput {
+public:
+    explicit IntegerOutput(long long num) : _num(num) {}
+
+    virtual RespReply to_resp_reply() override;
+
+private:
+    long long _num;
+};
+
+// Vector argument of commands, in one of the following forms:
+//      VALUES num v1 v2 ... vnum
+//      FP32|FP16|BF16 blob
+// The blob is the raw vector of little-endian floats, which is only validated by length.
+// `parse` runs on the reactor thread, and only slices arguments, while `decode` parses,
+// widens or copies them on the worker. Until then, the arguments are kept alive by the
+// pins of the command. FP32 blob is the fast path: if it's aligned, it's used in place
+// without copy. Otherwise, it's copied once.
+class VectorArg {
+public:
+    VectorArg() = default;
+
+    VectorArg(const VectorArg &) = delete;
+    VectorArg& operator=(const VectorArg &) = delete;
+
+    VectorArg(VectorArg &&) = delete;
+    VectorArg& operator=(VectorArg &&) = delete;
+
+    ~VectorArg() = default;
+
+    // Slice the vector at `idx` of `cmd`, and move `idx` to the next argument.
+    void parse(const RespCommand &cmd, std::size_t &idx);
+
+    // Throw Error if a value is invalid. Calling it more than once is a no-op.
+    void decode();
+
+    // Only valid after `decode`.
+    const float* data() const noexcept {
+        return _data;
+    }
+
+    // Number of elements, which is known after `parse`.
+    std::size_t size() const noexcept {
+        return _size;
+    }
+
+private:
+    void _decode_fp32_blob();
+
+    void _decode_half_blob();
+
+    ElementType _type = ElementType::FLOAT32;
+
+    // Either `_values` or `_blob` is set by `parse`.
+    RespArgs _values;
+
+    std::string_view _blob;
+
+    // Parsed, or copied, floats.
+    std::vector<float> _vec;
+
+    const float *_data = nullptr;
+
+    std::size_t _size = 0;
+
+    // Keep the sliced arguments, and the in-place blob, alive.
+    std::vector<BufferPin> _pins;
+};
+
+// VADD key VALUES num v1 v2 ... vnum|FP32 blob|FP16 blob|BF16 blob element
+//      [TAG name value] [INT name value] [FLOAT name value] ...
+// If any attribute is given, attributes of the element are replaced, otherwise, kept.
+class VAddTask : public VectorTask {
+public:
+    // Inserts search the index, e.g. HNSW.
+    virtual bool heavy() const override {
+        return true;
+    }
+
+protected:
+    virtual void _parse(RespCommand &cmd) override;
+
+    virtual TaskOutputUPtr _run() override;
+
+private:
+    std::string _key;
+
+    VectorArg _vec;
+
+    std::string _element;
+
+    // Type, name and value of each attribute, which are parsed by `_run`.
+    std::vector<std::tuple<AttributeType, std::string_view, std::string_view>> _attr_args;
+};
+
+// VGET key element
+class VGetTask : public VectorTask {
+public:
+    virtual bool read_only() const override {
+        return true;
+    }
+
+protected:
+    virtual void _parse(RespCommand &cmd) override;
+
+    virtual TaskOutputUPtr _run() override;
+
+private:
+    std::string _key;
+
+    std::string _element;
+};
+
+class VGetOutput : public VectorTaskOutput {
+public:
+    explicit VGetOutput(std::optional<std::vector<float>> vec) : _vec(std::move(vec)) {}
+
+    virtual RespReply to_resp_reply() override;
+
+private:
+    std::optional<std::vector<float>> _vec;
+};
+
+// VDEL key element
+class VDelTask : public VectorTask {
+protected:
+    virtual void _parse(RespCommand &cmd) override;
+
+    virtual TaskOutputUPtr _run() override;
+
+private:
+    std::string _key;
+
+    std::string _element;
+};
+
+// VCREATE key DIM dim [METRIC L2|IP|COSINE] [TYPE FP32|FP16|BF16]
+//      [INDEX FLAT|HNSW|IVF|IVF_PQ|SQ8|BINARY] [M m] [EF_CONSTRUCTION ef] [NLIST nlist] [NPROBE nprobe] [PQ_M m] [PQ_BITS 8|4]
+//      [SQ_RANGE PER_DIM|GLOBAL] [OVERSAMPLE factor] [RERANK factor]
+// NLIST and NPROBE are at most MAX_NLIST, PQ_M is at most MAX_PQ_M, and OVERSAMPLE
+// and RERANK are at most MAX_FACTOR, since indexes size centroids, codebooks and
+// candidate lists by them.
+class VCreateTask : public VectorTask {
+public:
+    static constexpr std::size_t MAX_NLIST = 65536;
+
+    static constexpr std::size_t MAX_PQ_M = 1024;
+
+    static constexpr std::size_t MAX_FACTOR = 100;
+
+protected:
+    virtual void _parse(RespCommand &cmd) override;
+
+    virtual TaskOutputUPtr _run() override;
+
+private:
+    std::string _key;
+
+    std::size_t _dim = 0;
+
+    Metric _metric = Metric::L2;
+
+    IndexOptions _index_opts;
+
+    ElementType _type = ElementType::FLOAT32;
+};
+
+class OkOutput : public VectorTaskOutput {
+public:
+    virtual RespReply to_resp_reply() override;
+};
+
+// VSIM key VALUES num v1 v2 ... vnum|FP32 blob|FP16 blob|BF16 blob
+//      [COUNT k] [EF ef] [NPROBE nprobe] [FILTER expr] [WITHSCORES] [WITHPLAN]
+// COUNT is at most MAX_COUNT, and larger ones are rejected, since searches size
+// their heaps and candidate lists by it. It's also capped by the collection size.
+// Scores are distances of the collection metric, i.e. smaller is closer.
+// See filter.h for the syntax of FILTER expressions, which are compiled once and cached
+// by their text. With WITHPLAN, the first element of the reply is the filter strategy,
+// i.e. NONE, EXACT, FILTERED or OVERSAMPLE.
+// Searches on the same collection without filter are batched, and share a single
+// scan of vectors.
+class VSimTask : public VectorTask {
+public:
+    virtual std::vector<TaskOutputUPtr> run_batch(const std::vector<Task*> &tasks) override;
+
+    virtual bool heavy() const override {
+        return true;
+    }
+
+    virtual bool read_only() const override {
+        return true;
+    }
+
+    static constexpr std::size_t MAX_COUNT = 10000;
+
+protected:
+    virtual void _parse(RespCommand &cmd) override;
+
+    virtual TaskOutputUPtr _run() override;
+
+    virtual std::string _batch_key() const override {
+        return _filter_expr ? std::string() : "vsim:" + _key;
+    }
+
+private:
+    std::string _key;
+
+    VectorArg _query;
+
+    SearchOptions _opts;
+
+    // It's compiled, or fetched from the cache, by `_run`. Kept alive by the pins of `_query`.
+    std::optional<std::string_view> _filter_expr;
+
+    bool _with_scores = false;
+
+    bool _with_plan = false;
+};
+
+class VSimOutput : public VectorTaskOutput {
+public:
+    // If `plan` is std::nullopt, the strategy is not replied.
+    VSimOutput(std::vector<SearchResult> results,
+                bool with_scores,
+                std::optional<FilterStrategy> plan = std::nullopt) :
+        _results(std::move(results)), _with_scores(with_scores), _plan(plan) {}
+
+    virtual RespReply to_resp_reply() override;
+
+private:
+    std::vector<SearchResult> _results;
+
+    bool _with_scores;
+
+    std::optional<FilterStrategy> _plan;
+};
+
+// VINFO key
+class VInfoTask : public VectorTask {
+public:
+    virtual bool read_only() const override {
+        return true;
+    }
+
+protected:
+    virtual void _parse(RespCommand &cmd) override;
+
+    virtual TaskOutputUPtr _run() override;
+
+private:
+    std::string _key;
+};
+
+struct CollectionInfo {
+    std::size_t dim = 0;
+
+    Metric metric = Metric::L2;
+
+    ElementType type = ElementType::FLOAT32;
+
+    IndexType index = IndexType::FLAT;
+
+    std::size_t size = 0;
+
+    std::size_t memory_usage = 0;
+};
+
+class VInfoOutput : public VectorTaskOutput {
+public:
+    explicit VInfoOutput(std::optional<CollectionInfo> info) : _info(std::move(info)) {}
+
+    virtual RespReply to_resp_reply() override;
+
+private:
+    std::optional<CollectionInfo> _info;
+};
+
+}
+
+#endif // end SW_VECTOR_ENGINE_VECTOR_TASK_H
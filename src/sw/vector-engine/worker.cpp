@@ -15,119 +15,541 @@
  *************************************************************************/
 
 #include "sw/vector-engine/worker.h"
+#include <algorithm>
+#include <cassert>
 #include <cctype>
+#include <exception>
+#include <iterator>
 #include "sw/vector-engine/resp.h"
 #include "sw/vector-engine/reactor.h"
 
 namespace sw::vengine {
 
-Worker::Worker() {
-    _worker = std::thread([this]() { this->_run(); });
+namespace {
+
+thread_local WorkerPool *current_pool = nullptr;
+
+// Index of the calling worker in `current_pool`.
+thread_local std::size_t current_index = 0;
+
 }
 
+Worker::Worker(WorkerPool &pool, std::size_t index) : _pool(pool), _index(index) {}
+
 Worker::~Worker() {
-    stop();
+    join();
+}
 
-    if (_worker.joinable()) {
-        _worker.join();
-    }
+void Worker::start() {
+    _worker = std::thread([this]() { this->_run(); });
 }
 
-void Worker::submit(BatchTask batch_task) {
-    {
-        std::lock_guard<std::mutex> lock(_mutex);
+void Worker::submit(WorkItem item) {
+    std::lock_guard<std::mutex> lock(_mutex);
 
-        _tasks.push_back(std::move(batch_task));
+    _tasks.push_back(std::move(item));
+}
+
+std::optional<WorkItem> Worker::pop() {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (_tasks.empty()) {
+        return std::nullopt;
     }
 
-    _cv.notify_one();
+    auto task = std::move(_tasks.front());
+    _tasks.pop_front();
+
+    return task;
 }
 
-void Worker::stop() {
-    BatchTask task;
-    task.reactor = nullptr;
+std::size_t Worker::pop_batches(const std::string &key,
+                                std::size_t max_tasks,
+                                std::vector<BatchTask> &batches) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    std::size_t num = 0;
+    while (!_tasks.empty()) {
+        auto &item = _tasks.front();
+        if (item.job || item.batch.tasks.empty()
+                || item.batch.tasks.size() > max_tasks
+                || item.batch.tasks.front()->batch_key() != key) {
+            break;
+        }
+
+        max_tasks -= item.batch.tasks.size();
+        batches.push_back(std::move(item.batch));
+        _tasks.pop_front();
+        ++num;
+    }
+
+    return num;
+}
 
-    submit(std::move(task));
+void Worker::join() {
+    if (_worker.joinable()) {
+        _worker.join();
+    }
 }
 
 void Worker::_run() {
+    current_pool = &_pool;
+    current_index = _index;
+
     while (true) {
-        auto tasks = _fetch_tasks();
-
-        bool stop_thread = false;
-        std::vector<Reply> replies;
-        replies.reserve(tasks.size());
-        for (auto &batch_task : tasks) {
-            if (batch_task.reactor == nullptr) {
-                stop_thread = true;
+        auto item = _pool._fetch(_index);
+        if (!item) {
+            // Pool has been stopped.
+            break;
+        }
+
+        if (item->job) {
+            item->job();
+            continue;
+        }
+
+        std::vector<BatchTask> batches;
+        batches.push_back(std::move(item->batch));
+
+        const auto &tasks = batches.front().tasks;
+        auto key = tasks.empty() ? std::string() : tasks.front()->batch_key();
+        if (!key.empty() && tasks.size() < MAX_COALESCED_TASKS) {
+            // Batches are queued only if all workers are busy, since idle ones steal them.
+            // So taking them from the queue does not hurt parallelism.
+            auto num = pop_batches(key, MAX_COALESCED_TASKS - tasks.size(), batches);
+            _pool._pending.fetch_sub(num);
+        }
+
+        auto replies = _run_batch_tasks(batches);
+
+        // Effects of the tasks are visible, so that stages waiting for them can start.
+        for (const auto &batch : batches) {
+            _pool._finish(batch);
+        }
+
+        // Send replies of the same reactor together.
+        for (std::size_t idx = 0; idx != batches.size(); ++idx) {
+            auto *reactor = batches[idx].reactor;
+            if (reactor == nullptr) {
+                // Already sent with a previous batch.
                 continue;
             }
-            auto reply = _run_batch_task(batch_task);
-            replies.emplace_back(std::move(reply));
 
-            batch_task.reactor->send(std::move(replies));
+            std::vector<Reply> reactor_replies;
+            for (auto other = idx; other != batches.size(); ++other) {
+                if (batches[other].reactor == reactor) {
+                    reactor_replies.push_back(std::move(replies[other]));
+                    batches[other].reactor = nullptr;
+                }
+            }
+
+            reactor->send(std::move(reactor_replies));
         }
+    }
+}
 
-        if (stop_thread) {
-            break;
+std::vector<Reply> Worker::_run_batch_tasks(std::vector<BatchTask> &batches) {
+    std::vector<Reply> replies(batches.size());
+    for (std::size_t idx = 0; idx != batches.size(); ++idx) {
+        assert(batches[idx].reactor != nullptr);
+
+        auto &reply = replies[idx];
+        reply.connection_id = batches[idx].connection_id;
+        reply.seq = batches[idx].seq;
+        reply.num = batches[idx].tasks.size();
+    }
+
+    // Index of the next task to run of each batch.
+    std::vector<std::size_t> cursors(batches.size(), 0);
+    for (std::size_t idx = 0; idx != batches.size(); ++idx) {
+        auto &batch_task = batches[idx];
+        auto &cursor = cursors[idx];
+        while (cursor < batch_task.tasks.size()) {
+            auto &task = batch_task.tasks[cursor];
+            auto key = task->batch_key();
+            if (key.empty()) {
+                auto output = task->run();
+                replies[idx].reply += batch_task.response_builder->build(output.get());
+                ++cursor;
+                continue;
+            }
+
+            // Collect consecutive tasks with the same key at the front of each batch,
+            // so that tasks of a batch still run in order.
+            std::vector<Task*> group;
+            std::vector<std::size_t> owners;
+            for (auto other = idx; other != batches.size(); ++other) {
+                auto &other_tasks = batches[other].tasks;
+                auto &other_cursor = cursors[other];
+                while (other_cursor < other_tasks.size()
+                        && other_tasks[other_cursor]->batch_key() == key) {
+                    group.push_back(other_tasks[other_cursor].get());
+                    owners.push_back(other);
+                    ++other_cursor;
+                }
+            }
+
+            std::vector<TaskOutputUPtr> outputs;
+            if (group.size() == 1) {
+                outputs.push_back(group.front()->run());
+            } else {
+                outputs = group.front()->run_batch(group);
+            }
+
+            assert(outputs.size() == group.size());
+
+            for (std::size_t pos = 0; pos != group.size(); ++pos) {
+                auto owner = owners[pos];
+                replies[owner].reply += batches[owner].response_builder->build(outputs[pos].get());
+            }
         }
     }
+
+    return replies;
+}
+
+std::size_t hardware_concurrency() noexcept {
+    return std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+WorkerPool::WorkerPool(std::size_t num) {
+    if (num == 0) {
+        num = hardware_concurrency();
+    }
+
+    _workers.reserve(num);
+    for (auto idx = 0U; idx != num; ++idx) {
+        _workers.push_back(std::make_unique<Worker>(*this, idx));
+    }
+
+    for (auto &worker : _workers) {
+        worker->start();
+    }
 }
 
-std::vector<BatchTask> Worker::_fetch_tasks() {
-    std::vector<BatchTask> tasks;
+void WorkerPool::submit(BatchTask task) {
+    if (_stopped) {
+        throw Error("worker pool has been stopped");
+    }
+
+    assert(!_workers.empty());
+
+    auto num = task.tasks.size();
+    if (num == 0) {
+        return;
+    }
+
+    if (!task.order) {
+        task.order = std::make_shared<TaskOrder>();
+    }
+
+    auto make_chunk = [&task](std::size_t first, std::size_t last) {
+        BatchTask chunk;
+        chunk.tasks.reserve(last - first);
+        chunk.tasks.insert(chunk.tasks.end(),
+                std::make_move_iterator(task.tasks.begin() + first),
+                std::make_move_iterator(task.tasks.begin() + last));
+        chunk.connection_id = task.connection_id;
+        chunk.seq = task.seq + first;
+        chunk.response_builder = task.response_builder;
+        chunk.reactor = task.reactor;
+        chunk.order = task.order;
+
+        return chunk;
+    };
+
+    // Tasks in [first, pos) run in order in a single chunk, and runs of read-only
+    // tasks worth splitting are split into stages of their own.
+    std::vector<TaskOrder::Stage> stages;
+    std::size_t first = 0;
+    auto read_only = true;
+    for (std::size_t pos = 0; pos < num; ) {
+        if (!task.tasks[pos]->read_only()) {
+            read_only = false;
+            ++pos;
+            continue;
+        }
+
+        auto last = pos;
+        auto heavy = false;
+        for (; last < num && task.tasks[last]->read_only(); ++last) {
+            heavy = heavy || task.tasks[last]->heavy();
+        }
+
+        auto run = last - pos;
+        auto chunks = std::min(run, _workers.size());
+        if (!heavy) {
+            chunks = std::min(chunks, run / MIN_CHUNK_TASKS);
+        }
+
+        if (chunks > 1) {
+            if (first < pos) {
+                stages.push_back({{}, read_only});
+                stages.back().chunks.push_back(make_chunk(first, pos));
+            }
+
+            TaskOrder::Stage stage{{}, true};
+            auto chunk_size = (run + chunks - 1) / chunks;
+            for (auto offset = pos; offset < last; offset += chunk_size) {
+                stage.chunks.push_back(make_chunk(offset, std::min(offset + chunk_size, last)));
+            }
+            stages.push_back(std::move(stage));
+
+            first = last;
+            read_only = true;
+        }
+
+        pos = last;
+    }
+
+    if (first == 0) {
+        // Not split at all.
+        stages.push_back({{}, read_only});
+        stages.back().chunks.push_back(std::move(task));
+    } else if (first < num) {
+        stages.push_back({{}, read_only});
+        stages.back().chunks.push_back(make_chunk(first, num));
+    }
+
+    auto home = stages.front().chunks.front().connection_id % _workers.size();
+    auto order = stages.front().chunks.front().order;
+
+    std::vector<BatchTask> ready;
     {
-        std::unique_lock<std::mutex> lock(_mutex);
+        std::lock_guard<std::mutex> lock(order->mutex);
 
-        if (_tasks.empty()) {
-            _cv.wait(lock, [this]() { return !(this->_tasks).empty(); });
+        for (auto &stage : stages) {
+            order->waiting.push_back(std::move(stage));
         }
 
-        tasks.swap(_tasks);
+        _advance(*order, ready);
     }
 
-    return tasks;
+    _start(std::move(ready), home);
 }
 
-Reply Worker::_run_batch_task(BatchTask &batch_task) {
-    Reply reply;
-    reply.connection_id = batch_task.connection_id;
-    for (const auto &task : batch_task.tasks) {
-        auto output = task->run();
-        reply.reply += batch_task.response_builder->build(output.get());
+void WorkerPool::_advance(TaskOrder &order, std::vector<BatchTask> &ready) {
+    while (!order.waiting.empty()) {
+        auto &stage = order.waiting.front();
+        if (order.running > 0 && !(order.read_only && stage.read_only)) {
+            break;
+        }
+
+        order.read_only = order.running == 0 ? stage.read_only : true;
+        order.running += stage.chunks.size();
+        for (auto &chunk : stage.chunks) {
+            ready.push_back(std::move(chunk));
+        }
+
+        order.waiting.pop_front();
     }
+}
 
-    return reply;
+void WorkerPool::_start(std::vector<BatchTask> chunks, std::size_t home) {
+    for (std::size_t idx = 0; idx != chunks.size(); ++idx) {
+        _submit(WorkItem{std::move(chunks[idx]), {}}, (home + idx) % _workers.size());
+    }
 }
 
-WorkerPool::WorkerPool(std::size_t num) {
+void WorkerPool::_finish(const BatchTask &chunk) {
+    if (!chunk.order) {
+        return;
+    }
+
+    auto &order = *chunk.order;
+    std::vector<BatchTask> ready;
+    {
+        std::lock_guard<std::mutex> lock(order.mutex);
+
+        assert(order.running > 0);
+        --order.running;
+
+        _advance(order, ready);
+    }
+
+    _start(std::move(ready), chunk.connection_id % _workers.size());
+}
+
+void WorkerPool::parallel_for(std::size_t num,
+                                const std::function<void (std::size_t, std::size_t)> &fn) {
     if (num == 0) {
-        throw Error("size of worker pool must larger than 0");
+        return;
     }
 
-    _workers.reserve(num);
-    for (auto idx = 0U; idx != num; ++idx) {
-        _workers.push_back(std::make_unique<Worker>());
+    // A few ranges per worker, so that fast workers can help slow ones.
+    _parallel_for(num, _workers.size() * 4, _workers.size() - 1, fn);
+}
+
+void WorkerPool::adaptive_parallel_for(std::size_t num,
+                                        std::size_t grain,
+                                        const std::function<void (std::size_t, std::size_t)> &fn) {
+    if (num == 0) {
+        return;
+    }
+
+    // If there're queued items, idle workers are about to take them.
+    auto helpers = _pending > 0 ? 0 : std::min(idle(), _workers.size() - 1);
+    auto chunks = std::min(helpers + 1, num / std::max<std::size_t>(grain, 1));
+
+    _parallel_for(num, chunks, helpers, fn);
+}
+
+void WorkerPool::_parallel_for(std::size_t num,
+                                std::size_t chunks,
+                                std::size_t helpers,
+                                const std::function<void (std::size_t, std::size_t)> &fn) {
+    auto chunk_size = chunks <= 1 ? num : (num + chunks - 1) / chunks;
+    chunks = (num + chunk_size - 1) / chunk_size;
+    if (chunks == 1 || helpers == 0 || _stopped) {
+        fn(0, num);
+        return;
+    }
+
+    struct State {
+        std::atomic<std::size_t> next{0};
+
+        // Following members are protected by `mutex`.
+        std::size_t finished = 0;
+        std::exception_ptr error;
+
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+
+    auto state = std::make_shared<State>();
+
+    // Ranges are claimed dynamically. A job that runs after all ranges have been
+    // claimed returns without touching `fn`, which might have been destroyed.
+    auto job = [state, &fn, num, chunks, chunk_size]() {
+        std::size_t done = 0;
+        std::exception_ptr error;
+        while (true) {
+            auto idx = state->next.fetch_add(1);
+            if (idx >= chunks) {
+                break;
+            }
+
+            if (!error) {
+                try {
+                    fn(idx * chunk_size, std::min(num, (idx + 1) * chunk_size));
+                } catch (...) {
+                    error = std::current_exception();
+                }
+            }
+            ++done;
+        }
+
+        if (done == 0) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(state->mutex);
+
+        state->finished += done;
+        if (error && !state->error) {
+            state->error = error;
+        }
+
+        if (state->finished == chunks) {
+            state->cv.notify_all();
+        }
+    };
+
+    helpers = std::min(helpers, chunks - 1);
+    auto first = _next_worker();
+    for (std::size_t idx = 0; idx != helpers; ++idx) {
+        _submit(WorkItem{{}, job}, (first + idx) % _workers.size());
+    }
+
+    job();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->cv.wait(lock, [&state, chunks]() { return state->finished == chunks; });
+
+    if (state->error) {
+        std::rethrow_exception(state->error);
     }
 }
 
-Worker& WorkerPool::fetch(uint64_t id) {
-    assert(_workers.size() > 0);
+void WorkerPool::post(std::function<void ()> job) {
+    if (_stopped) {
+        return;
+    }
+
+    assert(!_workers.empty());
+
+    _submit(WorkItem{{}, std::move(job)}, _next_worker());
+}
+
+WorkerPool* WorkerPool::current() noexcept {
+    return current_pool;
+}
+
+std::size_t WorkerPool::_next_worker() const noexcept {
+    if (current_pool != this) {
+        return 0;
+    }
+
+    return (current_index + 1) % _workers.size();
+}
+
+void WorkerPool::_submit(WorkItem item, std::size_t index) {
+    assert(index < _workers.size());
+
+    // Count it before it's visible to other workers, so that the counter never underflows.
+    _pending.fetch_add(1);
+
+    _workers[index]->submit(std::move(item));
 
-    auto &worker = _workers[id % _workers.size()];
-    if (worker) {
-        return *worker;
-    } else {
-        throw Error("worker has been stopped");
+    {
+        // Ensure idle workers either see the task or get the notification.
+        std::lock_guard<std::mutex> lock(_mutex);
     }
+
+    // Wake up an idle worker. If the owner is busy, it steals the task.
+    _cv.notify_one();
 }
 
 void WorkerPool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        if (_stopped) {
+            return;
+        }
+
+        _stopped = true;
+    }
+
+    _cv.notify_all();
+
     for (auto &worker : _workers) {
-        if (worker) {
-            worker->stop();
-            worker = nullptr;
+        worker->join();
+    }
+}
+
+std::optional<WorkItem> WorkerPool::_fetch(std::size_t index) {
+    assert(index < _workers.size());
+
+    while (true) {
+        if (_stopped) {
+            return std::nullopt;
         }
+
+        auto task = _workers[index]->pop();
+        for (auto cnt = 1U; !task && cnt < _workers.size(); ++cnt) {
+            task = _workers[(index + cnt) % _workers.size()]->steal();
+        }
+
+        if (task) {
+            _pending.fetch_sub(1);
+            return task;
+        }
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        ++_idle;
+        _cv.wait(lock, [this]() { return this->_stopped || this->_pending > 0; });
+        --_idle;
     }
 }
 
@@ -18,11 +18,15 @@
 #define SW_VECTOR_ENGINE_WORKER_H
 
 #include <vector>
+#include <deque>
+#include <optional>
 #include <mutex>
 #include <atomic>
 #include <memory>
+#include <string>
 #include <thread>
 #include <condition_variable>
+#include <functional>
 #include "sw/vector-engine/resp.h"
 #include "sw/vector-engine/task.h"
 #include "sw/vector-engine/protocol.h"
@@ -31,66 +35,232 @@ namespace sw::vengine {
 
 class Reactor;
 
+struct TaskOrder;
+
+using TaskOrderSPtr = std::shared_ptr<TaskOrder>;
+
 struct BatchTask {
     std::vector<TaskUPtr> tasks;
 
     uint64_t connection_id;
 
-    ResponseBuilderUPtr response_builder;
+    // Sequence number of the first task in its connection, and other tasks are
+    // numbered consecutively. Tasks of a connection might run on different workers,
+    // and the connection reorders replies by it.
+    uint64_t seq;
+
+    ResponseBuilderSPtr response_builder;
 
     Reactor *reactor;
+
+    // Shared by all batches of the connection, and nullptr means tasks are only
+    // ordered with those of the same batch.
+    TaskOrderSPtr order;
 };
 
-struct Reply {
-    uint64_t connection_id;
+// Orders tasks of a connection. Its tasks are split into stages, and a stage starts
+// after all previous stages of the connection finish, except that stages of read-only
+// tasks run concurrently with each other. So a read always sees previous writes of the
+// connection, even if it's pipelined behind them, or comes with a later batch.
+struct TaskOrder {
+    struct Stage {
+        // Chunks of the stage, which might run on different workers.
+        std::vector<BatchTask> chunks;
+
+        bool read_only;
+    };
+
+    std::mutex mutex;
 
-    std::string reply;
+    // Following members are protected by `mutex`.
+
+    // Number of queued or running chunks of started stages.
+    std::size_t running = 0;
+
+    // Whether all started stages are read-only.
+    bool read_only = true;
+
+    // Stages waiting for started ones.
+    std::deque<Stage> waiting;
 };
 
+// Item queued to workers: either a batch of tasks from a connection,
+// or a job posted by `WorkerPool::parallel_for`.
+struct WorkItem {
+    BatchTask batch;
+
+    std::function<void ()> job;
+};
+
+class WorkerPool;
+
+// Each worker has its own task queue. When the queue is empty, the worker steals
+// tasks from other workers, so that a heavy client cannot starve the others.
+// Before running a batch, the worker coalesces batches queued behind it, whose
+// leading tasks have the same batch key, e.g. searches on the same collection,
+// so that they're run together with `Task::run_batch`. Each batch still gets
+// its own reply.
 class Worker {
 public:
-    Worker();
+    Worker(WorkerPool &pool, std::size_t index);
+
+    Worker(const Worker &) = delete;
+    Worker& operator=(const Worker &) = delete;
+
+    Worker(Worker &&) = delete;
+    Worker& operator=(Worker &&) = delete;
 
     ~Worker();
 
-    void submit(BatchTask task);
+    // Start the worker thread. It's called after all workers of the pool have
+    // been created, since a worker might steal from any of them.
+    void start();
 
-    void stop();
+    void submit(WorkItem item);
+
+    // Called by the owner thread.
+    std::optional<WorkItem> pop();
+
+    // Called by other workers. Take the oldest task, since the owner is busy.
+    std::optional<WorkItem> steal() {
+        return pop();
+    }
+
+    // Called by the owner thread. Pop leading batches of the queue, whose first task
+    // has the batch `key`, as long as the total number of tasks is at most `max_tasks`.
+    // @return number of popped batches.
+    std::size_t pop_batches(const std::string &key,
+                            std::size_t max_tasks,
+                            std::vector<BatchTask> &batches);
+
+    void join();
 
 private:
+    // Max number of tasks coalesced into a run.
+    static constexpr std::size_t MAX_COALESCED_TASKS = 64;
+
     void _run();
 
-    std::vector<BatchTask> _fetch_tasks();
+    // Run tasks of batches in order, while leading tasks with the same batch key
+    // of all batches are run together.
+    std::vector<Reply> _run_batch_tasks(std::vector<BatchTask> &batches);
 
-    Reply _run_batch_task(BatchTask &batch_task);
+    WorkerPool &_pool;
 
-    void _run_task(Task *task);
+    std::size_t _index;
 
-    std::thread _worker;
-
-    std::vector<BatchTask> _tasks;
+    std::deque<WorkItem> _tasks;
 
     std::mutex _mutex;
 
-    std::condition_variable _cv;
+    std::thread _worker;
 };
 
 using WorkerUPtr = std::unique_ptr<Worker>;
 
+// Number of cores, and at least 1 if it cannot be detected.
+std::size_t hardware_concurrency() noexcept;
+
 class WorkerPool {
 public:
-    explicit WorkerPool(std::size_t num);
+    // `num` of 0 means `hardware_concurrency()` workers.
+    explicit WorkerPool(std::size_t num = 0);
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool& operator=(const WorkerPool &) = delete;
+
+    WorkerPool(WorkerPool &&) = delete;
+    WorkerPool& operator=(WorkerPool &&) = delete;
 
     ~WorkerPool() {
         stop();
     }
 
-    Worker& fetch(uint64_t id);
+    // Split the batch into stages at writes, i.e. tasks which are not read-only, and run
+    // stages in order with those of previous batches of the connection, see TaskOrder.
+    // A run of read-only tasks is split into at most `size()` chunks, which are queued
+    // to different workers, so that a single pipelining client can use all workers.
+    // Idle workers might also steal queued chunks. Runs of cheap tasks are only split
+    // into chunks of at least `MIN_CHUNK_TASKS` tasks, since a handoff costs more than
+    // running a few of them. Other tasks run in order in a single chunk.
+    void submit(BatchTask task);
+
+    // Call `fn(begin, end)` on sub-ranges of [0, num) with workers of the pool, and
+    // block until all ranges are done. The calling thread runs ranges too, so that it
+    // can be called by a worker, e.g. a task building an index, without deadlock.
+    // The first exception thrown by `fn` is rethrown.
+    void parallel_for(std::size_t num, const std::function<void (std::size_t, std::size_t)> &fn);
+
+    // Same as `parallel_for`, but only fan out to idle workers, and each range has at
+    // least `grain` items. So that a single query can use the whole pool at low load,
+    // while it does not delay other tasks at high load.
+    void adaptive_parallel_for(std::size_t num,
+                                std::size_t grain,
+                                const std::function<void (std::size_t, std::size_t)> &fn);
+
+    // Queue `job` without waiting for it, e.g. background work triggered by a task.
+    // It's dropped if the pool is stopped before it runs. The job must not throw.
+    void post(std::function<void ()> job);
+
+    // @return the pool of the calling worker thread, or nullptr if it's not a worker.
+    static WorkerPool* current() noexcept;
 
     void stop();
 
+    std::size_t size() const noexcept {
+        return _workers.size();
+    }
+
+    // Number of workers waiting for items.
+    std::size_t idle() const noexcept {
+        return _idle.load(std::memory_order_relaxed);
+    }
+
 private:
+    friend class Worker;
+
+    static constexpr std::size_t MIN_CHUNK_TASKS = 32;
+
+    // Run `fn` on `chunks` ranges of [0, num) with at most `helpers` other workers.
+    void _parallel_for(std::size_t num,
+                        std::size_t chunks,
+                        std::size_t helpers,
+                        const std::function<void (std::size_t, std::size_t)> &fn);
+
+    void _submit(WorkItem item, std::size_t index);
+
+    // Start waiting stages of `order`, which don't have to wait for running ones.
+    // Chunks of started stages are moved to `ready`. The caller must lock `order.mutex`.
+    static void _advance(TaskOrder &order, std::vector<BatchTask> &ready);
+
+    // Queue chunks of started stages to workers starting from `home`.
+    void _start(std::vector<BatchTask> chunks, std::size_t home);
+
+    // Called after a chunk has run, and start stages waiting for it.
+    void _finish(const BatchTask &chunk);
+
+    // Index of the worker after the calling one, or 0 if it's not called by a worker.
+    // Jobs posted by a worker are queued from there, so that they don't wait behind
+    // the caller, which stays busy until they're done.
+    std::size_t _next_worker() const noexcept;
+
+    // Fetch an item from the worker's own queue, or steal one from others.
+    // Block if there's no item, and return std::nullopt if the pool has been stopped.
+    std::optional<WorkItem> _fetch(std::size_t index);
+
     std::vector<WorkerUPtr> _workers;
+
+    // Number of items queued in all workers.
+    std::atomic<std::size_t> _pending{0};
+
+    std::atomic<std::size_t> _idle{0};
+
+    std::atomic<bool> _stopped{false};
+
+    // Protects sleeping of idle workers.
+    std::mutex _mutex;
+
+    std::condition_variable _cv;
 };
 
 using WorkerPoolSPtr = std::shared_ptr<WorkerPool>;
@@ -0,0 +1,257 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#include "distance_test.h"
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "sw/vector-engine/distance.h"
+#include "sw/vector-engine/element_type.h"
+#include "utils.h"
+
+namespace {
+
+using sw::vengine::Metric;
+
+// Odd sizes check the tails of SIMD loops, and sizes around multiples of
+// 8 and 16 check the boundaries of AVX2 and AVX-512 registers.
+const std::size_t DIMS[] = {1, 3, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100, 128, 257, 768};
+
+const Metric METRICS[] = {Metric::L2, Metric::IP, Metric::COSINE};
+
+struct Reference {
+    double distance;
+
+    // Scale of rounding errors, i.e. sum of absolute values of terms.
+    double scale;
+};
+
+Reference reference(Metric metric, const float *a, const float *b, std::size_t dim) {
+    double dot = 0;
+    double norm_a = 0;
+    double norm_b = 0;
+    double l2 = 0;
+    double scale = 1;
+    for (std::size_t i = 0; i != dim; ++i) {
+        double x = a[i];
+        double y = b[i];
+        dot += x * y;
+        norm_a += x * x;
+        norm_b += y * y;
+        l2 += (x - y) * (x - y);
+        scale += std::abs(x * y) + (x - y) * (x - y);
+    }
+
+    switch (metric) {
+    case Metric::L2:
+        return {l2, scale};
+
+    case Metric::IP:
+        return {-dot, scale};
+
+    default:
+        if (norm_a * norm_b <= 0) {
+            return {1, 1};
+        }
+
+        // Cosine is normalized, and its error doesn't grow with the scale.
+        return {1 - dot / std::sqrt(norm_a * norm_b), 1};
+    }
+}
+
+void check(Metric metric, float dist, const Reference &ref, double eps, const std::string &kernel, std::size_t dim) {
+    VECTOR_ENGINE_ASSERT(std::abs(dist - ref.distance) <= eps * ref.scale,
+            kernel + " of " + sw::vengine::to_string(metric) + " is " + std::to_string(dist)
+            + ", expect " + std::to_string(ref.distance) + ", dim: " + std::to_string(dim));
+}
+
+}
+
+namespace sw::vengine::test {
+
+void DistanceTest::run() {
+    const auto &tables = detail::kernel_tables();
+    VECTOR_ENGINE_ASSERT(!tables.empty() && std::string(tables.front().name) == "scalar",
+            "scalar kernels are not supported");
+    VECTOR_ENGINE_ASSERT(std::string(tables.back().name) == simd_level(),
+            "kernels in use are not the fastest ones");
+
+    for (const auto &kernels : tables) {
+        _test_float(kernels);
+
+        _test_stored(kernels);
+
+        _test_int8_dot(kernels);
+
+        _test_hamming(kernels);
+
+        _test_dot_block(kernels);
+    }
+}
+
+void DistanceTest::_test_float(const detail::KernelTable &kernels) {
+    for (auto dim : DIMS) {
+        // Offset vectors by a float, so that they're not aligned to registers.
+        auto vecs = random_vectors(2, dim + 1, dim);
+        const auto *a = vecs.data() + 1;
+        const auto *b = vecs.data() + dim + 2;
+
+        std::vector<float> zero(dim, 0.0f);
+
+        for (auto metric : METRICS) {
+            auto func = kernels.distance[static_cast<std::size_t>(metric)];
+            std::string name = kernels.name;
+
+            check(metric, func(a, b, dim), reference(metric, a, b, dim), 1e-5, name + " distance", dim);
+            check(metric, func(a, a, dim), reference(metric, a, a, dim), 1e-5, name + " distance to itself", dim);
+            check(metric, func(a, zero.data(), dim), reference(metric, a, zero.data(), dim), 1e-5,
+                    name + " distance to zero vector", dim);
+
+            // Distances from inner products and norms, which are used by batched scans.
+            auto ip = kernels.distance[static_cast<std::size_t>(Metric::IP)];
+            auto dot = -ip(a, b, dim);
+            auto norm_a = -ip(a, a, dim);
+            auto norm_b = -ip(b, b, dim);
+            check(metric, distance_from_dot(metric, dot, norm_a, norm_b), reference(metric, a, b, dim), 1e-4,
+                    name + " distance_from_dot", dim);
+        }
+    }
+}
+
+void DistanceTest::_test_stored(const detail::KernelTable &kernels) {
+    for (auto dim : DIMS) {
+        auto vecs = random_vectors(2, dim, dim);
+        const auto *query = vecs.data();
+
+        for (auto type : {ElementType::FLOAT32, ElementType::FLOAT16, ElementType::BFLOAT16}) {
+            // Stored vector, and its elements widened back to float32, which the kernel should see.
+            std::vector<uint16_t> half(dim + 1);
+            std::vector<float> widened(dim);
+            const void *stored = vecs.data() + dim;
+            if (type == ElementType::FLOAT32) {
+                widened.assign(vecs.begin() + dim, vecs.end());
+            } else {
+                for (std::size_t i = 0; i != dim; ++i) {
+                    if (type == ElementType::FLOAT16) {
+                        half[i + 1] = float_to_fp16(vecs[dim + i]);
+                        widened[i] = fp16_to_float(half[i + 1]);
+                    } else {
+                        half[i + 1] = float_to_bf16(vecs[dim + i]);
+                        widened[i] = bf16_to_float(half[i + 1]);
+                    }
+                }
+
+                // Not aligned to registers.
+                stored = half.data() + 1;
+            }
+
+            for (auto metric : METRICS) {
+                auto func = kernels.stored[static_cast<std::size_t>(type)][static_cast<std::size_t>(metric)];
+                check(metric, func(query, stored, dim), reference(metric, query, widened.data(), dim), 1e-5,
+                        std::string(kernels.name) + " distance to " + to_string(type), dim);
+            }
+        }
+    }
+}
+
+void DistanceTest::_test_int8_dot(const detail::KernelTable &kernels) {
+    auto func = kernels.int8_dot;
+    std::string name = kernels.name;
+
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<int> dist(0, 255);
+
+    auto expect = [&func, &name](const std::vector<uint8_t> &a, const std::vector<int8_t> &b) {
+        int64_t sum = 0;
+        for (std::size_t i = 0; i != a.size(); ++i) {
+            sum += static_cast<int64_t>(a[i]) * b[i];
+        }
+
+        VECTOR_ENGINE_ASSERT(func(a.data(), b.data(), a.size()) == sum,
+                "wrong " + name + " int8 dot product, dim: " + std::to_string(a.size()));
+    };
+
+    for (auto dim : DIMS) {
+        std::vector<uint8_t> a(dim);
+        std::vector<int8_t> b(dim);
+        for (std::size_t i = 0; i != dim; ++i) {
+            a[i] = static_cast<uint8_t>(dist(gen));
+            b[i] = static_cast<int8_t>(dist(gen) - 128);
+        }
+
+        expect(a, b);
+    }
+
+    // Extreme values, which must not saturate intermediate sums.
+    for (auto val : {-128, 127}) {
+        std::vector<uint8_t> a(4096, 255);
+        std::vector<int8_t> b(4096, static_cast<int8_t>(val));
+        expect(a, b);
+    }
+}
+
+void DistanceTest::_test_hamming(const detail::KernelTable &kernels) {
+    auto func = kernels.hamming;
+    std::string name = kernels.name;
+
+    std::mt19937_64 gen(0);
+    for (std::size_t words : {1, 2, 3, 7, 8, 9, 16, 17, 33}) {
+        std::vector<uint64_t> a(words);
+        std::vector<uint64_t> b(words);
+        uint32_t expected = 0;
+        for (std::size_t i = 0; i != words; ++i) {
+            a[i] = gen();
+            b[i] = gen();
+            for (auto diff = a[i] ^ b[i]; diff != 0; diff &= diff - 1) {
+                ++expected;
+            }
+        }
+
+        VECTOR_ENGINE_ASSERT(func(a.data(), b.data(), words) == expected,
+                "wrong " + name + " hamming distance, words: " + std::to_string(words));
+        VECTOR_ENGINE_ASSERT(func(a.data(), a.data(), words) == 0, "non-zero " + name + " hamming distance to itself");
+    }
+}
+
+void DistanceTest::_test_dot_block(const detail::KernelTable &kernels) {
+    auto func = kernels.dot_block;
+
+    for (std::size_t dim : {1, 3, 16, 17, 100}) {
+        // Rows are padded, and only the first `dim` floats of each row are used.
+        auto stride = dim + 3;
+        for (std::size_t nq : {1, 2, 3, 5, 8}) {
+            for (std::size_t nv : {1, 7, 16, 33}) {
+                auto queries = random_vectors(nq, stride, 1);
+                auto vecs = random_vectors(nv, stride, 2);
+
+                std::vector<float> out(nq * nv);
+                func(queries.data(), nq, vecs.data(), nv, dim, stride, out.data());
+
+                for (std::size_t i = 0; i != nq; ++i) {
+                    for (std::size_t j = 0; j != nv; ++j) {
+                        auto ref = reference(Metric::IP, queries.data() + i * stride, vecs.data() + j * stride, dim);
+                        ref.distance = -ref.distance;
+                        check(Metric::IP, out[i * nv + j], ref, 1e-5, std::string(kernels.name) + " dot block", dim);
+                    }
+                }
+            }
+        }
+    }
+}
+
+}
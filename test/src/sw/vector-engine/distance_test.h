@@ -0,0 +1,44 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#ifndef SW_VECTOR_ENGINE_TEST_DISTANCE_TEST_H
+#define SW_VECTOR_ENGINE_TEST_DISTANCE_TEST_H
+
+#include "sw/vector-engine/distance.h"
+
+namespace sw::vengine::test {
+
+// Check kernels of every instruction set supported by the running CPU, including
+// the scalar ones, against scalar code in double precision, or exact integer results.
+class DistanceTest {
+public:
+    void run();
+
+private:
+    void _test_float(const detail::KernelTable &kernels);
+
+    void _test_stored(const detail::KernelTable &kernels);
+
+    void _test_int8_dot(const detail::KernelTable &kernels);
+
+    void _test_hamming(const detail::KernelTable &kernels);
+
+    void _test_dot_block(const detail::KernelTable &kernels);
+};
+
+}
+
+#endif // end SW_VECTOR_ENGINE_TEST_DISTANCE_TEST_H
@@ -0,0 +1,348 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#include "filter_test.h"
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+#include "sw/vector-engine/bitmap.h"
+#include "sw/vector-engine/errors.h"
+#include "sw/vector-engine/filter_program.h"
+#include "utils.h"
+
+namespace {
+
+// Enough ids for many batches, so that selective conjuncts are answered
+// with inverted indexes, and others run over columns.
+const std::size_t NUM_IDS = 5000;
+
+const char* const LANGS[] = {"en", "fr", "de"};
+
+// Expressions mixing attributes, which are missing for some ids, i.e. unknown.
+const char* const EXPRS[] = {
+    "lang == \"en\"",
+    "lang != \"en\"",
+    "not lang == \"en\"",
+    "lang == \"zh\"",
+    "lang != \"zh\"",
+    "lang in [\"en\", \"fr\"]",
+    "not lang in [\"en\", \"zh\"]",
+    "year == 2000",
+    "year != 2000",
+    "not year == 2000",
+    "year < 2000.5 and year > 1995",
+    "year >= 2024 or year <= 1991",
+    "year == 2001 or year == 2002 or year == 2003",
+    "year in [1990, 2000, 2010.5]",
+    "score < 0.25",
+    "not score >= 0.25",
+    "score > 0.2 && score < 0.4 || !(year >= 2000)",
+    "lang == \"en\" and year >= 2010",
+    "lang == \"en\" and (year >= 2020 or lang in [\"fr\", \"de\"]) and not score < 0.5",
+    "not (lang == \"en\" or score < 0.5)",
+    "not (lang == \"de\" and year < 2000)",
+    "missing == 1",
+    "not missing == 1",
+    "missing == 1 or lang == \"de\"",
+    "missing == 1 and lang == \"de\"",
+    "not (missing == 1 and lang == \"de\")",
+    "not (missing == 1 or lang == \"de\")",
+    "year >= 1990"
+};
+
+// Number of programs kept by FilterProgramCache.
+const std::size_t CACHE_CAPACITY = 1024;
+
+bool compare(sw::vengine::FilterOp op, double lhs, double rhs) {
+    switch (op) {
+    case sw::vengine::FilterOp::EQ:
+        return lhs == rhs;
+
+    case sw::vengine::FilterOp::NE:
+        return lhs != rhs;
+
+    case sw::vengine::FilterOp::LT:
+        return lhs < rhs;
+
+    case sw::vengine::FilterOp::LE:
+        return lhs <= rhs;
+
+    case sw::vengine::FilterOp::GT:
+        return lhs > rhs;
+
+    default:
+        return lhs >= rhs;
+    }
+}
+
+}
+
+namespace sw::vengine::test {
+
+void FilterTest::run() {
+    AttributeIndex index;
+    Attributes attrs(NUM_IDS);
+
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<double> score(0, 1);
+    for (VectorId id = 0; id != NUM_IDS; ++id) {
+        auto &attr = attrs[id];
+        if (id % 5 != 0) {
+            Attribute lang;
+            lang.name = "lang";
+            lang.type = AttributeType::TAG;
+            lang.tag = LANGS[gen() % 3];
+            attr.push_back(lang);
+        }
+
+        if (id % 7 != 0) {
+            Attribute year;
+            year.name = "year";
+            year.type = AttributeType::INT;
+            year.integer = 1990 + gen() % 36;
+            attr.push_back(year);
+        }
+
+        if (id % 3 != 0) {
+            Attribute val;
+            val.name = "score";
+            val.type = AttributeType::FLOAT;
+            val.number = score(gen);
+            attr.push_back(val);
+        }
+
+        index.add(id);
+        index.check(attr);
+        index.set(id, attr);
+    }
+
+    // Removed ids are never matched.
+    for (VectorId id = 0; id < NUM_IDS; id += 11) {
+        index.remove(id);
+        attrs[id].clear();
+    }
+
+    _test_evaluate(index, attrs);
+
+    _test_type_errors(index);
+
+    _test_program();
+
+    _test_cache();
+}
+
+void FilterTest::_test_evaluate(const AttributeIndex &index, const Attributes &attrs) {
+    // Candidates, including ids that don't exist.
+    Bitmap candidates;
+    for (VectorId id = 0; id < NUM_IDS + 100; id += 4) {
+        candidates.add(id);
+    }
+
+    for (const auto *expr : EXPRS) {
+        FilterProgram program(expr);
+        auto tree = parse_filter(expr);
+
+        Bitmap expected;
+        Bitmap expected_candidates;
+        for (VectorId id = 0; id != NUM_IDS; ++id) {
+            if (_expect(*tree, attrs[id]) == std::optional<bool>(true)) {
+                expected.add(id);
+                if (candidates.contains(id)) {
+                    expected_candidates.add(id);
+                }
+            }
+        }
+
+        VECTOR_ENGINE_ASSERT(index.evaluate(program).to_vector() == expected.to_vector(),
+                std::string("wrong result of ") + expr);
+
+        VECTOR_ENGINE_ASSERT(index.evaluate(program, candidates).to_vector() == expected_candidates.to_vector(),
+                std::string("wrong result of ") + expr + " on candidates");
+    }
+}
+
+void FilterTest::_test_type_errors(const AttributeIndex &index) {
+    // Some errors are found by the parser, and others by attribute types.
+    for (const auto *expr : {"lang > \"a\"", "lang == 1", "year == \"2000\"", "score in [0.5, \"a\"]"}) {
+        auto thrown = false;
+        try {
+            index.evaluate(FilterProgram(expr));
+        } catch (const Error &) {
+            thrown = true;
+        }
+        VECTOR_ENGINE_ASSERT(thrown, std::string("type error is not detected: ") + expr);
+    }
+}
+
+void FilterTest::_test_program() {
+    FilterProgram program("lang in [\"en\", \"fr\"] and not (year == 2000 or lang == \"en\")");
+
+    // IN is expanded into ORs of EQs, and attributes and literals are deduplicated.
+    VECTOR_ENGINE_ASSERT(program.attrs() == std::vector<std::string>({"lang", "year"}), "wrong attributes");
+
+    const auto &literals = program.literals();
+    VECTOR_ENGINE_ASSERT(literals.size() == 3
+            && literals[0].is_string && literals[0].str == "en"
+            && literals[1].is_string && literals[1].str == "fr"
+            && !literals[2].is_string && literals[2].num == 2000, "wrong literals");
+
+    // pair<opcode, pair<attr, literal>> in postfix order.
+    using Instruction = std::pair<FilterOpcode, std::pair<uint32_t, uint32_t>>;
+    const std::vector<Instruction> expected = {
+        {FilterOpcode::COMPARE, {0, 0}},
+        {FilterOpcode::COMPARE, {0, 1}},
+        {FilterOpcode::OR, {0, 0}},
+        {FilterOpcode::COMPARE, {1, 2}},
+        {FilterOpcode::COMPARE, {0, 0}},
+        {FilterOpcode::OR, {0, 0}},
+        {FilterOpcode::NOT, {0, 0}},
+        {FilterOpcode::AND, {0, 0}}
+    };
+
+    std::vector<Instruction> code;
+    for (const auto &instruction : program.code()) {
+        VECTOR_ENGINE_ASSERT(instruction.opcode != FilterOpcode::COMPARE || instruction.op == FilterOp::EQ,
+                "wrong operator");
+        code.emplace_back(instruction.opcode, std::make_pair(instruction.attr, instruction.literal));
+    }
+    VECTOR_ENGINE_ASSERT(code == expected, "wrong code");
+
+    VECTOR_ENGINE_ASSERT(program.max_depth() == 3, "wrong max depth of stack");
+}
+
+void FilterTest::_test_cache() {
+    auto &cache = FilterProgramCache::instance();
+
+    // Expressions that are not used by other tests.
+    auto expr = [](std::size_t idx) {
+        return "cache_test == " + std::to_string(idx);
+    };
+
+    auto first = cache.get(expr(0));
+    auto second = cache.get(expr(1));
+    VECTOR_ENGINE_ASSERT(first && first != second, "different expressions share a program");
+    VECTOR_ENGINE_ASSERT(cache.get(expr(0)) == first, "cached program is compiled again");
+
+    // Fill the cache, and touch the first expression, so that the second one is the least recently used.
+    for (std::size_t idx = 2; idx != CACHE_CAPACITY; ++idx) {
+        cache.get(expr(idx));
+    }
+    VECTOR_ENGINE_ASSERT(cache.get(expr(0)) == first, "recently used program is evicted");
+
+    cache.get(expr(CACHE_CAPACITY));
+    VECTOR_ENGINE_ASSERT(cache.get(expr(1)) != second, "least recently used program is not evicted");
+    VECTOR_ENGINE_ASSERT(cache.get(expr(0)) == first, "recently used program is evicted");
+
+    // Invalid expressions throw every time.
+    for (auto round = 0; round != 2; ++round) {
+        auto thrown = false;
+        try {
+            cache.get("year >=");
+        } catch (const Error &) {
+            thrown = true;
+        }
+        VECTOR_ENGINE_ASSERT(thrown, "invalid expression is accepted");
+    }
+}
+
+std::optional<bool> FilterTest::_expect(const FilterExpr &expr, const std::vector<Attribute> &attrs) const {
+    switch (expr.op) {
+    case FilterOp::AND: {
+        // False if any operand is false, otherwise, unknown if any operand is unknown.
+        std::optional<bool> result = true;
+        for (const auto &child : expr.children) {
+            auto val = _expect(*child, attrs);
+            if (val == std::optional<bool>(false)) {
+                return false;
+            }
+
+            if (!val) {
+                result.reset();
+            }
+        }
+        return result;
+    }
+
+    case FilterOp::OR: {
+        std::optional<bool> result = false;
+        for (const auto &child : expr.children) {
+            auto val = _expect(*child, attrs);
+            if (val == std::optional<bool>(true)) {
+                return true;
+            }
+
+            if (!val) {
+                result.reset();
+            }
+        }
+        return result;
+    }
+
+    case FilterOp::NOT: {
+        auto val = _expect(*expr.children.front(), attrs);
+        if (!val) {
+            return std::nullopt;
+        }
+        return !*val;
+    }
+
+    case FilterOp::IN: {
+        std::optional<bool> result = false;
+        for (const auto &literal : expr.values) {
+            auto val = _expect_compare(FilterOp::EQ, expr.attr, literal, attrs);
+            if (val == std::optional<bool>(true)) {
+                return true;
+            }
+
+            if (!val) {
+                result.reset();
+            }
+        }
+        return result;
+    }
+
+    default:
+        return _expect_compare(expr.op, expr.attr, expr.values.front(), attrs);
+    }
+}
+
+std::optional<bool> FilterTest::_expect_compare(FilterOp op,
+                                                const std::string &name,
+                                                const FilterLiteral &literal,
+                                                const std::vector<Attribute> &attrs) const {
+    for (const auto &attr : attrs) {
+        if (attr.name != name) {
+            continue;
+        }
+
+        switch (attr.type) {
+        case AttributeType::TAG:
+            return op == FilterOp::EQ ? attr.tag == literal.str : attr.tag != literal.str;
+
+        case AttributeType::INT:
+            return compare(op, static_cast<double>(attr.integer), literal.num);
+
+        default:
+            return compare(op, attr.number, literal.num);
+        }
+    }
+
+    // Comparisons on a missing attribute are unknown.
+    return std::nullopt;
+}
+
+}
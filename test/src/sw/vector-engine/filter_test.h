@@ -0,0 +1,57 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#ifndef SW_VECTOR_ENGINE_TEST_FILTER_TEST_H
+#define SW_VECTOR_ENGINE_TEST_FILTER_TEST_H
+
+#include <optional>
+#include <string>
+#include <vector>
+#include "sw/vector-engine/attribute_index.h"
+#include "sw/vector-engine/filter.h"
+
+namespace sw::vengine::test {
+
+// Check filters evaluated by the attribute index against a naive evaluation of
+// the expression tree on each id, which follows the three-valued logic in filter.h.
+class FilterTest {
+public:
+    void run();
+
+private:
+    // Attributes of ids, and removed ids have no attribute.
+    using Attributes = std::vector<std::vector<Attribute>>;
+
+    void _test_evaluate(const AttributeIndex &index, const Attributes &attrs);
+
+    void _test_type_errors(const AttributeIndex &index);
+
+    void _test_program();
+
+    void _test_cache();
+
+    // @return true, false or unknown, i.e. std::nullopt.
+    std::optional<bool> _expect(const FilterExpr &expr, const std::vector<Attribute> &attrs) const;
+
+    std::optional<bool> _expect_compare(FilterOp op,
+                                        const std::string &name,
+                                        const FilterLiteral &literal,
+                                        const std::vector<Attribute> &attrs) const;
+};
+
+}
+
+#endif // end SW_VECTOR_ENGINE_TEST_FILTER_TEST_H
@@ -0,0 +1,378 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#include "index_test.h"
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include "sw/vector-engine/errors.h"
+#include "sw/vector-engine/hnsw_index.h"
+#include "sw/vector-engine/ivf_index.h"
+#include "utils.h"
+
+namespace {
+
+const std::size_t DIM = 32;
+
+const std::size_t NUM_VECTORS = 3000;
+
+const std::size_t NUM_QUERIES = 100;
+
+// Vectors around `clusters` random centers, which are what IVF is designed for.
+std::vector<float> clustered_vectors(std::size_t num, std::size_t clusters, uint32_t seed) {
+    auto centers = sw::vengine::test::random_vectors(clusters, DIM, 0);
+
+    std::mt19937 gen(seed);
+    std::normal_distribution<float> noise(0.0f, 0.2f);
+
+    std::vector<float> vecs(num * DIM);
+    for (std::size_t idx = 0; idx != num; ++idx) {
+        const auto *center = centers.data() + (idx % clusters) * DIM;
+        for (std::size_t i = 0; i != DIM; ++i) {
+            vecs[idx * DIM + i] = center[i] + noise(gen);
+        }
+    }
+
+    return vecs;
+}
+
+}
+
+namespace sw::vengine::test {
+
+void IndexTest::run() {
+    _test_hnsw();
+
+    _test_ivf();
+
+    _test_sq8();
+
+    _test_binary();
+
+    _test_search_batch();
+
+    _test_training_backoff();
+
+    _test_invalid_options();
+}
+
+void IndexTest::_test_hnsw() {
+    auto vecs = random_vectors(NUM_VECTORS, DIM, 1);
+    auto queries = random_vectors(NUM_QUERIES, DIM, 2);
+
+    for (auto metric : {Metric::L2, Metric::COSINE}) {
+        IndexOptions hnsw_opts;
+        hnsw_opts.type = IndexType::HNSW;
+
+        VectorCollection exact(DIM, metric);
+        VectorCollection hnsw(DIM, metric, hnsw_opts);
+        _add(vecs, {&exact, &hnsw});
+
+        SearchOptions opts;
+        opts.k = 10;
+        opts.ef = 64;
+
+        auto recall = _recall(exact, hnsw, queries, opts);
+        VECTOR_ENGINE_ASSERT(recall >= 0.95, "low recall of HNSW: " + std::to_string(recall));
+
+        // Larger ef finds more neighbors.
+        opts.ef = 256;
+        VECTOR_ENGINE_ASSERT(_recall(exact, hnsw, queries, opts) >= recall, "recall drops with larger ef");
+
+        // Deleted nodes are still traversed, but never returned.
+        for (std::size_t idx = 0; idx < NUM_VECTORS; idx += 2) {
+            auto key = std::to_string(idx);
+            exact.remove(key);
+            hnsw.remove(key);
+        }
+
+        opts.ef = 64;
+        recall = _recall(exact, hnsw, queries, opts);
+        VECTOR_ENGINE_ASSERT(recall >= 0.9, "low recall of HNSW with deleted nodes: " + std::to_string(recall));
+    }
+}
+
+void IndexTest::_test_ivf() {
+    IndexOptions ivf_opts;
+    ivf_opts.type = IndexType::IVF;
+    ivf_opts.nlist = 16;
+
+    // The index is trained once there're enough vectors, i.e. in the middle of adds.
+    auto vecs = clustered_vectors(NUM_VECTORS, ivf_opts.nlist, 1);
+    auto queries = clustered_vectors(NUM_QUERIES, ivf_opts.nlist, 2);
+
+    VectorCollection exact(DIM);
+    VectorCollection ivf(DIM, Metric::L2, ivf_opts);
+    _add(vecs, {&exact, &ivf});
+
+    SearchOptions opts;
+    opts.k = 10;
+
+    // Probing all lists is exhaustive.
+    opts.nprobe = ivf_opts.nlist;
+    VECTOR_ENGINE_ASSERT(_recall(exact, ivf, queries, opts) == 1, "probing all lists misses neighbors");
+
+    // Probing a single list misses a few neighbors near the boundaries of clusters,
+    // while an untrained index searches all vectors.
+    opts.nprobe = 1;
+    auto recall = _recall(exact, ivf, queries, opts);
+    VECTOR_ENGINE_ASSERT(recall < 1, "IVF is not trained");
+
+    opts.nprobe = 4;
+    auto more = _recall(exact, ivf, queries, opts);
+    VECTOR_ENGINE_ASSERT(more > recall && more >= 0.99, "low recall of IVF: " + std::to_string(more));
+
+    // Vectors added and removed after training are assigned to and erased from lists.
+    auto extra = clustered_vectors(NUM_VECTORS / 4, ivf_opts.nlist, 3);
+    for (std::size_t idx = 0; idx * DIM < extra.size(); ++idx) {
+        auto key = "extra-" + std::to_string(idx);
+        exact.add(key, extra.data() + idx * DIM);
+        ivf.add(key, extra.data() + idx * DIM);
+    }
+
+    for (std::size_t idx = 0; idx < NUM_VECTORS; idx += 3) {
+        auto key = std::to_string(idx);
+        exact.remove(key);
+        ivf.remove(key);
+    }
+
+    opts.nprobe = ivf_opts.nlist;
+    VECTOR_ENGINE_ASSERT(_recall(exact, ivf, queries, opts) == 1, "probing all lists misses updated neighbors");
+}
+
+void IndexTest::_test_sq8() {
+    auto vecs = random_vectors(NUM_VECTORS, DIM, 1);
+    auto queries = random_vectors(NUM_QUERIES, DIM, 2);
+
+    SearchOptions opts;
+    opts.k = 10;
+
+    for (auto metric : {Metric::L2, Metric::IP, Metric::COSINE}) {
+        VectorCollection exact(DIM, metric);
+        _add(vecs, {&exact});
+
+        for (auto per_dim : {true, false}) {
+            IndexOptions sq8_opts;
+            sq8_opts.type = IndexType::SQ8;
+            sq8_opts.sq_per_dim = per_dim;
+
+            VectorCollection sq8(DIM, metric, sq8_opts);
+
+            sq8_opts.rerank = 4;
+            VectorCollection reranked(DIM, metric, sq8_opts);
+            _add(vecs, {&sq8, &reranked});
+
+            // Distances of codes are approximate, and re-ranked ones are exact.
+            auto recall = _recall(exact, sq8, queries, opts, 0.02);
+            VECTOR_ENGINE_ASSERT(recall >= 0.95, "low recall of SQ8: " + std::to_string(recall));
+
+            recall = _recall(exact, reranked, queries, opts);
+            VECTOR_ENGINE_ASSERT(recall >= 0.99, "low recall of SQ8 with re-ranking: " + std::to_string(recall));
+
+            // Without re-ranking, raw vectors are not kept, and codes take 1 byte per dimension.
+            VECTOR_ENGINE_ASSERT(sq8.memory_usage() + NUM_VECTORS * DIM * (sizeof(float) - 1) <= exact.memory_usage(),
+                    "SQ8 does not save memory");
+        }
+    }
+}
+
+void IndexTest::_test_binary() {
+    // Sign bits approximate angles, and need more dimensions than other indexes.
+    const std::size_t dim = 256;
+    auto vecs = random_vectors(NUM_VECTORS, dim, 1);
+    auto queries = random_vectors(NUM_QUERIES, dim, 2);
+
+    SearchOptions opts;
+    opts.k = 10;
+
+    for (auto metric : {Metric::L2, Metric::IP, Metric::COSINE}) {
+        VectorCollection exact(dim, metric);
+        _add(vecs, {&exact});
+
+        // Candidates are re-scored with exact distances, and more candidates find more
+        // neighbors. Re-scoring all vectors is exhaustive.
+        double last = 0;
+        for (std::size_t oversample : {std::size_t(8), std::size_t(64), NUM_VECTORS}) {
+            IndexOptions binary_opts;
+            binary_opts.type = IndexType::BINARY;
+            binary_opts.oversample = oversample;
+
+            VectorCollection binary(dim, metric, binary_opts);
+            _add(vecs, {&binary});
+
+            auto recall = _recall(exact, binary, queries, opts);
+            VECTOR_ENGINE_ASSERT(recall >= last, "recall drops with larger oversample");
+            last = recall;
+
+            if (oversample == 64) {
+                VECTOR_ENGINE_ASSERT(recall >= 0.9, "low recall of BINARY: " + std::to_string(recall));
+            }
+        }
+
+        VECTOR_ENGINE_ASSERT(last == 1, "re-scoring all vectors misses neighbors");
+    }
+}
+
+void IndexTest::_test_search_batch() {
+    IndexOptions ivf_opts;
+    ivf_opts.type = IndexType::IVF;
+    ivf_opts.nlist = 16;
+
+    auto vecs = clustered_vectors(NUM_VECTORS, ivf_opts.nlist, 1);
+    auto queries = clustered_vectors(NUM_QUERIES, ivf_opts.nlist, 2);
+
+    // Queries of a batch have their own k and nprobe.
+    std::vector<const float*> batch;
+    std::vector<SearchOptions> opts(NUM_QUERIES);
+    for (std::size_t idx = 0; idx != NUM_QUERIES; ++idx) {
+        batch.push_back(queries.data() + idx * DIM);
+        opts[idx].k = 1 + idx % 20;
+        opts[idx].nprobe = 1 + idx % 4;
+    }
+
+    for (auto metric : {Metric::L2, Metric::IP, Metric::COSINE}) {
+        VectorCollection flat(DIM, metric);
+        VectorCollection ivf(DIM, metric, ivf_opts);
+        _add(vecs, {&flat, &ivf});
+
+        // A batch is scanned with blocked inner products, and finds the same neighbors
+        // as searching queries one by one.
+        for (const auto *collection : {&flat, &ivf}) {
+            auto results = collection->search_batch(batch, opts);
+            VECTOR_ENGINE_ASSERT(results.size() == NUM_QUERIES, "wrong number of batch results");
+
+            for (std::size_t idx = 0; idx != NUM_QUERIES; ++idx) {
+                auto expected = collection->search(batch[idx], opts[idx]);
+                const auto &res = results[idx];
+                VECTOR_ENGINE_ASSERT(res.size() == expected.size(), "wrong number of results in batch");
+
+                for (std::size_t pos = 0; pos != res.size(); ++pos) {
+                    VECTOR_ENGINE_ASSERT(res[pos].key == expected[pos].key,
+                            "batch finds different neighbors of " + to_string(metric));
+                    VECTOR_ENGINE_ASSERT(std::abs(res[pos].distance - expected[pos].distance)
+                                <= 1e-4 * (1 + std::abs(expected[pos].distance)),
+                            "wrong distance in batch of " + to_string(metric));
+                }
+            }
+        }
+    }
+}
+
+void IndexTest::_test_training_backoff() {
+    IndexOptions opts;
+    opts.type = IndexType::IVF;
+    opts.nlist = 2;
+
+    const std::size_t train_size = 78;
+    auto vecs = random_vectors(train_size * 2, DIM, 3);
+    IvfFlatIndex index(opts, DIM, Metric::L2);
+    auto add = [&](std::size_t id) {
+        index.add(static_cast<VectorId>(id), vecs.data() + id * DIM);
+        return index.start_training() != nullptr;
+    };
+
+    for (std::size_t id = 0; id + 1 < train_size; ++id) {
+        VECTOR_ENGINE_ASSERT(!add(id), "training starts with too few vectors");
+    }
+    VECTOR_ENGINE_ASSERT(add(train_size - 1), "training does not start with enough vectors");
+
+    // After a failed training, the next one waits until the index has doubled.
+    index.finish_training(nullptr);
+    for (auto id = train_size; id + 1 < train_size * 2; ++id) {
+        VECTOR_ENGINE_ASSERT(!add(id), "training restarts right after a failure");
+    }
+    VECTOR_ENGINE_ASSERT(add(train_size * 2 - 1), "training does not restart after a failure");
+    index.finish_training(nullptr);
+}
+
+void IndexTest::_test_invalid_options() {
+    IndexOptions opts;
+    opts.type = IndexType::HNSW;
+    opts.m = 4000000000;
+    _expect_invalid(opts, "huge M of HNSW");
+
+    opts = IndexOptions{};
+    opts.type = IndexType::HNSW;
+    opts.ef_construction = HnswIndex::MAX_EF_CONSTRUCTION + 1;
+    _expect_invalid(opts, "huge EF_CONSTRUCTION of HNSW");
+
+    opts = IndexOptions{};
+    opts.type = IndexType::IVF_PQ;
+    opts.pq_bits = 64;
+    _expect_invalid(opts, "64-bit PQ codes");
+}
+
+void IndexTest::_expect_invalid(const IndexOptions &opts, const std::string &what) const {
+    try {
+        VectorCollection collection(DIM, Metric::L2, opts);
+    } catch (const Error &) {
+        return;
+    }
+
+    VECTOR_ENGINE_ASSERT(false, "accept " + what);
+}
+
+void IndexTest::_add(const std::vector<float> &vecs, std::vector<VectorCollection*> collections) const {
+    for (auto *collection : collections) {
+        auto dim = collection->dim();
+        for (std::size_t idx = 0; idx * dim < vecs.size(); ++idx) {
+            collection->add(std::to_string(idx), vecs.data() + idx * dim);
+        }
+    }
+}
+
+double IndexTest::_recall(const VectorCollection &exact,
+                            const VectorCollection &approx,
+                            const std::vector<float> &queries,
+                            const SearchOptions &opts,
+                            double distance_error) const {
+    auto dim = exact.dim();
+    std::size_t found = 0;
+    std::size_t total = 0;
+    for (std::size_t idx = 0; idx * dim < queries.size(); ++idx) {
+        const auto *query = queries.data() + idx * dim;
+
+        // key -> exact distance
+        std::unordered_map<std::string, float> neighbors;
+        for (const auto &res : exact.search(query, opts)) {
+            neighbors.emplace(res.key, res.distance);
+        }
+
+        auto results = approx.search(query, opts);
+        VECTOR_ENGINE_ASSERT(results.size() == neighbors.size(), "wrong number of results");
+
+        for (std::size_t pos = 0; pos != results.size(); ++pos) {
+            const auto &res = results[pos];
+            VECTOR_ENGINE_ASSERT(approx.get(res.key).has_value(), "deleted vector is returned: " + res.key);
+            VECTOR_ENGINE_ASSERT(pos == 0 || results[pos - 1].distance <= res.distance, "results are not sorted");
+
+            auto iter = neighbors.find(res.key);
+            if (iter != neighbors.end()) {
+                VECTOR_ENGINE_ASSERT(std::abs(iter->second - res.distance) <= distance_error * (1 + std::abs(res.distance)),
+                        "wrong distance of " + res.key);
+                ++found;
+            }
+        }
+
+        total += neighbors.size();
+    }
+
+    return total == 0 ? 1 : static_cast<double>(found) / total;
+}
+
+}
@@ -0,0 +1,67 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#ifndef SW_VECTOR_ENGINE_TEST_INDEX_TEST_H
+#define SW_VECTOR_ENGINE_TEST_INDEX_TEST_H
+
+#include <string>
+#include <vector>
+#include "sw/vector-engine/index.h"
+#include "sw/vector-engine/vector_collection.h"
+
+namespace sw::vengine::test {
+
+// Check approximate indexes against exact results of a FLAT index on the same vectors.
+class IndexTest {
+public:
+    void run();
+
+private:
+    void _test_hnsw();
+
+    void _test_ivf();
+
+    void _test_sq8();
+
+    void _test_binary();
+
+    // Batched searches of FLAT and IVF match searches of each query.
+    void _test_search_batch();
+
+    // A failed training is not retried by every following add.
+    void _test_training_backoff();
+
+    // Out of range options are rejected, instead of allocating by them.
+    void _test_invalid_options();
+
+    void _expect_invalid(const IndexOptions &opts, const std::string &what) const;
+
+    // Add `vecs` to collections as keys "0", "1", ...
+    void _add(const std::vector<float> &vecs, std::vector<VectorCollection*> collections) const;
+
+    // @return average ratio of the exact `opts.k` nearest neighbors of `queries`
+    //         found by `approx`. Also check results of `approx` are sorted, and
+    //         distances match the exact ones within a relative `distance_error`.
+    double _recall(const VectorCollection &exact,
+                    const VectorCollection &approx,
+                    const std::vector<float> &queries,
+                    const SearchOptions &opts,
+                    double distance_error = 1e-4) const;
+};
+
+}
+
+#endif // end SW_VECTOR_ENGINE_TEST_INDEX_TEST_H
@@ -0,0 +1,117 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+#include "mpsc_queue_test.h"
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include "sw/vector-engine/mpsc_queue.h"
+#include "utils.h"
+
+namespace sw::vengine::test {
+
+void MpscQueueTest::run() {
+    _test_capacity();
+
+    _test_fifo();
+
+    _test_producers();
+}
+
+void MpscQueueTest::_test_capacity() {
+    VECTOR_ENGINE_ASSERT(MpscQueue<int>(1).capacity() == 1, "failed to create queue of 1 cell");
+    VECTOR_ENGINE_ASSERT(MpscQueue<int>(5).capacity() == 8, "capacity is not rounded up to power of 2");
+    VECTOR_ENGINE_ASSERT(MpscQueue<int>(64).capacity() == 64, "capacity of power of 2 is changed");
+
+    bool thrown = false;
+    try {
+        MpscQueue<int> queue(0);
+    } catch (const Error &) {
+        thrown = true;
+    }
+    VECTOR_ENGINE_ASSERT(thrown, "queue of 0 capacity is created");
+}
+
+void MpscQueueTest::_test_fifo() {
+    MpscQueue<std::string> queue(4);
+    VECTOR_ENGINE_ASSERT(queue.empty(), "new queue is not empty");
+
+    // Wrap around the cells a few times.
+    for (auto round = 0; round != 3; ++round) {
+        for (auto idx = 0; idx != 4; ++idx) {
+            auto item = std::to_string(round * 4 + idx);
+            VECTOR_ENGINE_ASSERT(queue.try_push(item), "failed to push to non-full queue");
+        }
+
+        std::string item = "rejected";
+        VECTOR_ENGINE_ASSERT(!queue.try_push(item), "pushed to full queue");
+        VECTOR_ENGINE_ASSERT(item == "rejected", "rejected item is moved");
+
+        for (auto idx = 0; idx != 4; ++idx) {
+            VECTOR_ENGINE_ASSERT(!queue.empty(), "non-empty queue is empty");
+            VECTOR_ENGINE_ASSERT(queue.try_pop(item), "failed to pop from non-empty queue");
+            VECTOR_ENGINE_ASSERT(item == std::to_string(round * 4 + idx), "items are out of order");
+        }
+
+        VECTOR_ENGINE_ASSERT(queue.empty(), "drained queue is not empty");
+        VECTOR_ENGINE_ASSERT(!queue.try_pop(item), "popped from empty queue");
+    }
+}
+
+void MpscQueueTest::_test_producers() {
+    constexpr uint64_t PRODUCERS = 4;
+    constexpr uint64_t ITEMS = 100000;
+
+    // A small queue, so that producers often find it full and contend for cells.
+    MpscQueue<uint64_t> queue(16);
+
+    std::vector<std::thread> producers;
+    for (uint64_t producer = 0; producer != PRODUCERS; ++producer) {
+        producers.emplace_back([&queue, producer]() {
+            for (uint64_t seq = 0; seq != ITEMS; ++seq) {
+                auto item = (producer << 32) | seq;
+                while (!queue.try_push(item)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Items of each producer must arrive in order, and exactly once.
+    std::vector<uint64_t> next(PRODUCERS, 0);
+    for (uint64_t cnt = 0; cnt != PRODUCERS * ITEMS; ) {
+        uint64_t item = 0;
+        if (!queue.try_pop(item)) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        auto producer = item >> 32;
+        VECTOR_ENGINE_ASSERT(producer < PRODUCERS, "unknown producer");
+        VECTOR_ENGINE_ASSERT((item & 0xFFFFFFFF) == next[producer], "items of a producer are lost or out of order");
+
+        ++next[producer];
+        ++cnt;
+    }
+
+    for (auto &producer : producers) {
+        producer.join();
+    }
+
+    VECTOR_ENGINE_ASSERT(queue.empty(), "queue is not empty after all items are popped");
+}
+
+}
@@ -0,0 +1,143 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#include "pq_fast_scan_test.h"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "sw/vector-engine/pq_fast_scan.h"
+#include "utils.h"
+
+namespace sw::vengine::test {
+
+void PqFastScanTest::run() {
+    _test_layout();
+
+    // A partial block, and blocks with few and many sub-quantizers. Sums of more
+    // than 256 sub-quantizers overflow uint16, if they're not widened. `m` of multiple
+    // of 4 runs the full kernels, and others run the pair kernels.
+    _test_scan(1, 2);
+    _test_scan(FAST_SCAN_BLOCK * 3 + 5, 2);
+    _test_scan(FAST_SCAN_BLOCK * 2, 16);
+    _test_scan(FAST_SCAN_BLOCK * 2, 18);
+    _test_scan(FAST_SCAN_BLOCK + 17, 64);
+    _test_scan(FAST_SCAN_BLOCK * 2, 600);
+    _test_scan(FAST_SCAN_BLOCK * 2, 602);
+}
+
+void PqFastScanTest::_test_layout() {
+    const std::size_t m = 4;
+    std::vector<uint8_t> block(fast_scan_block_size(m), 0);
+
+    // Different codes for vector `lane` and vector `lane + 16`.
+    auto code_of = [](std::size_t lane, std::size_t sub) {
+        return static_cast<uint8_t>((lane + lane / 16 * 7 + sub) % 16);
+    };
+
+    for (std::size_t lane = 0; lane != FAST_SCAN_BLOCK; ++lane) {
+        for (std::size_t sub = 0; sub != m; ++sub) {
+            fast_scan_set_code(block.data(), lane, sub, code_of(lane, sub));
+        }
+    }
+
+    // Vector `lane` and vector `lane + 16` share a byte of each sub-quantizer.
+    for (std::size_t sub = 0; sub != m; ++sub) {
+        for (std::size_t lane = 0; lane != 16; ++lane) {
+            auto byte = block[sub * 16 + lane];
+            VECTOR_ENGINE_ASSERT((byte & 0x0F) == code_of(lane, sub), "wrong low nibble");
+            VECTOR_ENGINE_ASSERT((byte >> 4) == code_of(lane + 16, sub), "wrong high nibble");
+        }
+    }
+
+    // Overwriting a code keeps the code of the other vector in the byte.
+    fast_scan_set_code(block.data(), 3, 1, 0x0F);
+    VECTOR_ENGINE_ASSERT(block[16 + 3] == (code_of(3 + 16, 1) << 4 | 0x0F), "overwriting a code changes its neighbor");
+
+    fast_scan_set_code(block.data(), 3 + 16, 1, 0);
+    VECTOR_ENGINE_ASSERT(block[16 + 3] == 0x0F, "overwriting a code changes its neighbor");
+}
+
+void PqFastScanTest::_test_scan(std::size_t num, std::size_t m) {
+    std::mt19937 gen(static_cast<uint32_t>(num * m));
+    std::uniform_int_distribution<int> dist(0, 255);
+
+    std::vector<uint8_t> lut(m * 16);
+    for (auto &entry : lut) {
+        entry = static_cast<uint8_t>(dist(gen));
+    }
+
+    // Entries of the largest values, which are most likely to overflow.
+    for (std::size_t sub = 0; sub != m; ++sub) {
+        lut[sub * 16 + 15] = 255;
+    }
+
+    auto num_blocks = (num + FAST_SCAN_BLOCK - 1) / FAST_SCAN_BLOCK;
+    std::vector<uint8_t> blocks(num_blocks * fast_scan_block_size(m), 0);
+
+    // Codes of vectors, and padding vectors of the last block have code 0.
+    std::vector<uint8_t> codes(num_blocks * FAST_SCAN_BLOCK * m, 0);
+    for (std::size_t idx = 0; idx != num; ++idx) {
+        auto *block = blocks.data() + idx / FAST_SCAN_BLOCK * fast_scan_block_size(m);
+        for (std::size_t sub = 0; sub != m; ++sub) {
+            // Half of the vectors take the largest entries.
+            auto code = static_cast<uint8_t>(idx % 2 == 0 ? 15 : dist(gen) % 16);
+            codes[idx * m + sub] = code;
+            fast_scan_set_code(block, idx % FAST_SCAN_BLOCK, sub, code);
+        }
+    }
+
+    std::vector<uint32_t> expected(num_blocks * FAST_SCAN_BLOCK, 0);
+    for (std::size_t idx = 0; idx != expected.size(); ++idx) {
+        for (std::size_t sub = 0; sub != m; ++sub) {
+            expected[idx] += lut[sub * 16 + codes[idx * m + sub]];
+        }
+    }
+
+    auto check = [&](const std::vector<uint32_t> &dists, const std::string &kernel) {
+        for (std::size_t idx = 0; idx != dists.size(); ++idx) {
+            VECTOR_ENGINE_ASSERT(dists[idx] == expected[idx], "wrong distance of vector " + std::to_string(idx)
+                    + " by " + kernel + ", m: " + std::to_string(m));
+        }
+    };
+
+    std::vector<uint32_t> dists(expected.size());
+    fast_scan(blocks.data(), num_blocks, lut.data(), m, dists.data());
+    check(dists, "fast_scan");
+
+    // Kernels of every supported instruction set. Pair kernels work with any even `m`.
+    auto block_size = fast_scan_block_size(m);
+    for (const auto &kernels : detail::fast_scan_kernels()) {
+        std::vector<std::pair<detail::FastScanFunc, std::string>> funcs = {
+            {kernels.pair, std::string(kernels.name) + " pair kernel"}
+        };
+        if (m % 4 == 0) {
+            funcs.emplace_back(kernels.full, std::string(kernels.name) + " full kernel");
+        }
+
+        for (const auto &[func, name] : funcs) {
+            std::fill(dists.begin(), dists.end(), 0);
+            for (std::size_t idx = 0; idx != num_blocks; ++idx) {
+                func(blocks.data() + idx * block_size, lut.data(), m, dists.data() + idx * FAST_SCAN_BLOCK);
+            }
+            check(dists, name);
+        }
+    }
+}
+
+}
@@ -0,0 +1,178 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#include "read_buffer_test.h"
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include "sw/vector-engine/buffer_pool.h"
+#include "sw/vector-engine/read_buffer.h"
+#include "utils.h"
+
+namespace {
+
+const std::size_t CHUNK_SIZE = 8;
+
+// Append `data` with reads no larger than chunks.
+void append(sw::vengine::ReadBuffer &buffer, std::string_view data) {
+    while (!data.empty()) {
+        auto [ptr, size] = buffer.alloc(data.size());
+        VECTOR_ENGINE_ASSERT(size > 0, "read buffer is full");
+
+        auto len = std::min(size, data.size());
+        data.copy(ptr, len);
+        buffer.occupy(len);
+        data.remove_prefix(len);
+    }
+}
+
+std::string make_data(std::size_t size) {
+    std::string data;
+    for (std::size_t idx = 0; idx != size; ++idx) {
+        data.push_back(static_cast<char>('a' + idx % 26));
+    }
+
+    return data;
+}
+
+}
+
+namespace sw::vengine::test {
+
+void ReadBufferTest::run() {
+    _test_access();
+
+    _test_view();
+
+    _test_dealloc();
+
+    _test_max_size();
+}
+
+void ReadBufferTest::_test_access() {
+    auto pool = std::make_shared<BufferPool>(CHUNK_SIZE, 16);
+    ReadBuffer buffer(pool, 1024);
+
+    auto data = make_data(CHUNK_SIZE * 3 + 5);
+    append(buffer, data);
+    VECTOR_ENGINE_ASSERT(buffer.size() == data.size(), "wrong size");
+
+    // Consume a few bytes, so that positions no longer start at the beginning of a chunk.
+    const std::size_t consumes[] = {0, 3, 2, CHUNK_SIZE};
+    for (auto consumed : consumes) {
+        if (consumed > 0) {
+            buffer.dealloc(consumed);
+            data.erase(0, consumed);
+        }
+
+        VECTOR_ENGINE_ASSERT(buffer.size() == data.size(), "wrong size after dealloc");
+
+        // Absolute offset of the first byte in the first chunk.
+        auto begin = (CHUNK_SIZE * 4 + 5 - data.size()) % CHUNK_SIZE;
+
+        for (std::size_t pos = 0; pos != data.size(); ++pos) {
+            VECTOR_ENGINE_ASSERT(buffer.at(pos) == data[pos], "wrong byte at " + std::to_string(pos));
+
+            // Views end at the end of the chunk containing `pos`.
+            auto len = std::min(CHUNK_SIZE - (begin + pos) % CHUNK_SIZE, data.size() - pos);
+            VECTOR_ENGINE_ASSERT(buffer.contiguous(pos) == std::string_view(data).substr(pos, len),
+                    "wrong contiguous view at " + std::to_string(pos));
+
+            for (std::size_t copy_len = 0; pos + copy_len <= data.size(); ++copy_len) {
+                std::string out(copy_len, '\0');
+                buffer.copy(pos, copy_len, out.data());
+                VECTOR_ENGINE_ASSERT(out == data.substr(pos, copy_len), "wrong copy of a range spanning chunks");
+            }
+        }
+
+        VECTOR_ENGINE_ASSERT(buffer.contiguous(data.size()).empty(), "non-empty view at the end");
+    }
+}
+
+void ReadBufferTest::_test_view() {
+    auto pool = std::make_shared<BufferPool>(CHUNK_SIZE, 16);
+    ReadBuffer buffer(pool, 1024);
+
+    auto data = make_data(CHUNK_SIZE * 2);
+    append(buffer, data);
+
+    // Ranges inside a chunk reference it without copy, and share its pin.
+    auto [first, first_pin] = buffer.view(0, 4);
+    auto [second, second_pin] = buffer.view(4, 4);
+    VECTOR_ENGINE_ASSERT(first == data.substr(0, 4) && second == data.substr(4, 4), "wrong view in a chunk");
+    VECTOR_ENGINE_ASSERT(first.data() + 4 == second.data(), "view in a chunk is copied");
+    VECTOR_ENGINE_ASSERT(first_pin == second_pin, "views in a chunk pin different memory");
+
+    // Ranges spanning chunks are copied.
+    auto [spanned, spanned_pin] = buffer.view(6, 4);
+    VECTOR_ENGINE_ASSERT(spanned == data.substr(6, 4), "wrong view spanning chunks");
+    VECTOR_ENGINE_ASSERT(spanned_pin != first_pin, "view spanning chunks references a chunk");
+
+    // Views stay valid after the buffer drops the data.
+    buffer.dealloc(data.size());
+    VECTOR_ENGINE_ASSERT(first == data.substr(0, 4) && spanned == data.substr(6, 4),
+            "pinned view is changed after dealloc");
+}
+
+void ReadBufferTest::_test_dealloc() {
+    auto pool = std::make_shared<BufferPool>(CHUNK_SIZE, 16);
+    ReadBuffer buffer(pool, 1024);
+
+    append(buffer, make_data(CHUNK_SIZE * 3));
+    VECTOR_ENGINE_ASSERT(pool->stats().used_chunks == 3, "wrong number of chunks");
+
+    auto pin = buffer.view(0, 2).second;
+
+    // Consumed chunks go back to the pool, unless they're pinned.
+    buffer.dealloc(CHUNK_SIZE * 2);
+    auto stats = pool->stats();
+    VECTOR_ENGINE_ASSERT(stats.used_chunks == 2 && stats.free_chunks == 1, "consumed chunk is not released");
+
+    pin.reset();
+    stats = pool->stats();
+    VECTOR_ENGINE_ASSERT(stats.used_chunks == 1 && stats.free_chunks == 2, "unpinned chunk is not released");
+
+    buffer.dealloc(CHUNK_SIZE);
+    VECTOR_ENGINE_ASSERT(buffer.size() == 0 && pool->stats().used_chunks == 0, "empty buffer holds chunks");
+
+    // Reads reuse cached chunks, and an empty read doesn't hold the chunk.
+    auto hits = pool->stats().hits;
+    buffer.alloc(CHUNK_SIZE);
+    stats = pool->stats();
+    VECTOR_ENGINE_ASSERT(stats.used_chunks == 1 && stats.hits == hits + 1, "cached chunk is not reused");
+
+    buffer.shrink();
+    VECTOR_ENGINE_ASSERT(pool->stats().used_chunks == 0, "shrink doesn't release the empty chunk");
+}
+
+void ReadBufferTest::_test_max_size() {
+    auto pool = std::make_shared<BufferPool>(CHUNK_SIZE, 16);
+    ReadBuffer buffer(pool, CHUNK_SIZE * 2 + 4);
+
+    append(buffer, make_data(CHUNK_SIZE * 2));
+
+    auto size = buffer.alloc(CHUNK_SIZE).second;
+    VECTOR_ENGINE_ASSERT(size == 4, "allocated space beyond the max size");
+
+    buffer.occupy(size);
+    VECTOR_ENGINE_ASSERT(buffer.alloc(CHUNK_SIZE).second == 0, "allocated space in a full buffer");
+
+    // Space is available again once data is consumed.
+    buffer.dealloc(CHUNK_SIZE);
+    VECTOR_ENGINE_ASSERT(buffer.alloc(CHUNK_SIZE).second == 4, "no space after dealloc");
+}
+
+}
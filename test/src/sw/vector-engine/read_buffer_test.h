@@ -0,0 +1,38 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+#ifndef SW_VECTOR_ENGINE_TEST_READ_BUFFER_TEST_H
+#define SW_VECTOR_ENGINE_TEST_READ_BUFFER_TEST_H
+
+namespace sw::vengine::test {
+
+class ReadBufferTest {
+public:
+    void run();
+
+private:
+    void _test_access();
+
+    void _test_view();
+
+    void _test_dealloc();
+
+    void _test_max_size();
+};
+
+}
+
+#endif // end SW_VECTOR_ENGINE_TEST_READ_BUFFER_TEST_H
@@ -0,0 +1,179 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+#include "resp_test.h"
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include "sw/vector-engine/buffer_pool.h"
+#include "sw/vector-engine/errors.h"
+#include "sw/vector-engine/read_buffer.h"
+#include "sw/vector-engine/resp.h"
+#include "utils.h"
+
+namespace {
+
+const std::size_t MAX_REQUEST_SIZE = 1024 * 1024;
+
+void append(sw::vengine::ReadBuffer &buffer, std::string_view data) {
+    while (!data.empty()) {
+        auto [ptr, size] = buffer.alloc(data.size());
+        VECTOR_ENGINE_ASSERT(size > 0, "read buffer is full");
+
+        auto len = std::min(size, data.size());
+        data.copy(ptr, len);
+        buffer.occupy(len);
+        data.remove_prefix(len);
+    }
+}
+
+std::string to_resp(const std::vector<std::string> &cmd) {
+    auto req = "*" + std::to_string(cmd.size()) + "\r\n";
+    for (const auto &arg : cmd) {
+        req += "$" + std::to_string(arg.size()) + "\r\n" + arg + "\r\n";
+    }
+
+    return req;
+}
+
+}
+
+namespace sw::vengine::test {
+
+void RespTest::run() {
+    _test_split();
+
+    _test_incomplete();
+
+    _test_invalid();
+}
+
+void RespTest::_test_split() {
+    const std::vector<Command> cmds = {
+        {"PING"},
+        {"VADD", "key", "VALUES", "3", "1", "2", "3", "elem"},
+        // Empty argument, and binary argument which looks like the end of an argument.
+        {"SET", "", std::string("a\r\n$1\r\n\0b", 10)},
+        {"ECHO", std::string(300, 'x')}
+    };
+
+    std::string req;
+    for (const auto &cmd : cmds) {
+        req += to_resp(cmd);
+    }
+
+    for (auto zero_copy : {true, false}) {
+        // Small chunks, so that headers and arguments span chunks.
+        for (auto chunk_size : {7, 64, 4096}) {
+            VECTOR_ENGINE_ASSERT(_parse({req}, chunk_size, zero_copy) == cmds,
+                    "failed to parse a pipeline");
+
+            // Split the request at every byte.
+            for (std::size_t pos = 0; pos <= req.size(); ++pos) {
+                std::string_view data(req);
+                VECTOR_ENGINE_ASSERT(_parse({data.substr(0, pos), data.substr(pos)}, chunk_size, zero_copy) == cmds,
+                        "failed to parse a request split at " + std::to_string(pos));
+            }
+
+            // Feed one byte at a time.
+            std::vector<std::string_view> pieces;
+            for (std::size_t pos = 0; pos != req.size(); ++pos) {
+                pieces.push_back(std::string_view(req).substr(pos, 1));
+            }
+            VECTOR_ENGINE_ASSERT(_parse(pieces, chunk_size, zero_copy) == cmds,
+                    "failed to parse a request fed byte by byte");
+        }
+    }
+}
+
+void RespTest::_test_incomplete() {
+    auto pool = std::make_shared<BufferPool>(64, 16);
+    ReadBuffer buffer(pool, MAX_REQUEST_SIZE);
+    RespCommandParser parser(MAX_REQUEST_SIZE);
+
+    auto req = to_resp({"GET", "key"});
+    append(buffer, std::string_view(req).substr(0, req.size() - 1));
+
+    auto [cmds, parsed] = parser.parse(buffer);
+    VECTOR_ENGINE_ASSERT(cmds.empty() && parsed == 0, "parsed an incomplete request");
+
+    // Parsing again without new data is a no-op.
+    std::tie(cmds, parsed) = parser.parse(buffer);
+    VECTOR_ENGINE_ASSERT(cmds.empty() && parsed == 0, "parsed an incomplete request twice");
+
+    append(buffer, std::string_view(req).substr(req.size() - 1));
+    std::tie(cmds, parsed) = parser.parse(buffer);
+    VECTOR_ENGINE_ASSERT(cmds.size() == 1 && parsed == req.size(), "failed to complete a request");
+    VECTOR_ENGINE_ASSERT(cmds.front().name == "GET"
+            && cmds.front().args == RespArgs{"key"}, "wrong command");
+}
+
+void RespTest::_test_invalid() {
+    auto expect_error = [](std::size_t max_size, std::string_view req, const std::string &msg) {
+        auto pool = std::make_shared<BufferPool>(64, 16);
+        ReadBuffer buffer(pool, MAX_REQUEST_SIZE);
+        RespCommandParser parser(max_size);
+        append(buffer, req);
+
+        auto thrown = false;
+        try {
+            parser.parse(buffer);
+        } catch (const Error &) {
+            thrown = true;
+        }
+        VECTOR_ENGINE_ASSERT(thrown, msg);
+    };
+
+    expect_error(MAX_REQUEST_SIZE, "*0\r\n", "accepted a command without argument");
+    expect_error(MAX_REQUEST_SIZE, "+PING\r\n", "accepted a non-array request");
+    expect_error(MAX_REQUEST_SIZE, "*1\r\n$-1\r\n", "accepted a negative length");
+    expect_error(MAX_REQUEST_SIZE, "*1\r\n$4\r\nPINGXX", "accepted an argument without CRLF");
+    expect_error(MAX_REQUEST_SIZE, "*1\r\n$4x\r\nPING\r\n", "accepted a header without CRLF");
+
+    // Oversized requests are rejected by headers, before their payload arrives.
+    expect_error(64, "*1\r\n$100\r\n", "accepted a too long argument");
+    expect_error(64, "*100\r\n", "accepted too many arguments");
+}
+
+auto RespTest::_parse(const std::vector<std::string_view> &pieces,
+                        std::size_t chunk_size,
+                        bool zero_copy) const -> std::vector<Command> {
+    auto pool = std::make_shared<BufferPool>(chunk_size, 16);
+    ReadBuffer buffer(pool, MAX_REQUEST_SIZE);
+    RespCommandParser parser(MAX_REQUEST_SIZE, zero_copy);
+
+    std::vector<Command> result;
+    for (const auto &piece : pieces) {
+        append(buffer, piece);
+
+        auto [cmds, parsed] = parser.parse(buffer);
+        if (parsed > 0) {
+            buffer.dealloc(parsed);
+        }
+
+        // Arguments are pinned by commands, even if the buffer has dropped them.
+        for (const auto &cmd : cmds) {
+            Command command = {cmd.name};
+            command.insert(command.end(), cmd.args.begin(), cmd.args.end());
+            result.push_back(std::move(command));
+        }
+    }
+
+    VECTOR_ENGINE_ASSERT(buffer.size() == 0, "request is not fully parsed");
+
+    return result;
+}
+
+}
@@ -0,0 +1,48 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+#ifndef SW_VECTOR_ENGINE_TEST_RESP_TEST_H
+#define SW_VECTOR_ENGINE_TEST_RESP_TEST_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sw::vengine::test {
+
+class RespTest {
+public:
+    void run();
+
+private:
+    // Name and arguments of a parsed command.
+    using Command = std::vector<std::string>;
+
+    void _test_split();
+
+    void _test_incomplete();
+
+    void _test_invalid();
+
+    // Feed `pieces` one by one to a parser, and drop parsed bytes after each one.
+    std::vector<Command> _parse(const std::vector<std::string_view> &pieces,
+                                std::size_t chunk_size,
+                                bool zero_copy) const;
+};
+
+}
+
+#endif // end SW_VECTOR_ENGINE_TEST_RESP_TEST_H
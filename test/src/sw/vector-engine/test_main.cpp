@@ -0,0 +1,104 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "sw/vector-engine/errors.h"
+#include "sw/vector-engine/logger.h"
+#include "mpsc_queue_test.h"
+#include "resp_test.h"
+#include "read_buffer_test.h"
+#include "distance_test.h"
+#include "index_test.h"
+#include "pq_fast_scan_test.h"
+#include "filter_test.h"
+#include "worker_test.h"
+
+namespace {
+
+template <typename Test>
+void run_test() {
+    Test test;
+    test.run();
+}
+
+using TestFunc = void (*)();
+
+// pair<name, test>, and names are also the names of ctest tests.
+const std::vector<std::pair<std::string, TestFunc>> TESTS = {
+    {"mpsc_queue", run_test<sw::vengine::test::MpscQueueTest>},
+    {"resp", run_test<sw::vengine::test::RespTest>},
+    {"read_buffer", run_test<sw::vengine::test::ReadBufferTest>},
+    {"distance", run_test<sw::vengine::test::DistanceTest>},
+    {"index", run_test<sw::vengine::test::IndexTest>},
+    {"pq_fast_scan", run_test<sw::vengine::test::PqFastScanTest>},
+    {"filter", run_test<sw::vengine::test::FilterTest>},
+    {"worker", run_test<sw::vengine::test::WorkerTest>}
+};
+
+void print_help() {
+    std::cerr << "Usage: vector-engine-test [test name]\n";
+    std::cerr << "Run all tests if no name is specified. Tests:\n";
+    for (const auto &test : TESTS) {
+        std::cerr << "    " << test.first << "\n";
+    }
+}
+
+}
+
+int main(int argc, char **argv) {
+    if (argc > 2) {
+        print_help();
+        return 1;
+    }
+
+    std::string name;
+    if (argc == 2) {
+        name = argv[1];
+    }
+
+    try {
+        sw::vengine::LoggerOptions logger_opts;
+        logger_opts.path = "logs/vector-engine-test.log";
+        sw::vengine::Logger::instance().init(logger_opts);
+
+        auto found = false;
+        for (const auto &[test_name, test] : TESTS) {
+            if (!name.empty() && name != test_name) {
+                continue;
+            }
+
+            found = true;
+            test();
+
+            std::cout << "Pass " << test_name << " test" << std::endl;
+        }
+
+        if (!found) {
+            print_help();
+            return 1;
+        }
+    } catch (const sw::vengine::Error &e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    } catch (const std::exception &e) {
+        std::cerr << "Test failed with unexpected exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,56 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+#ifndef SW_VECTOR_ENGINE_TEST_UTILS_H
+#define SW_VECTOR_ENGINE_TEST_UTILS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "sw/vector-engine/errors.h"
+
+#define VECTOR_ENGINE_ASSERT(condition, msg) \
+    sw::vengine::test::vector_engine_assert((condition), (msg), __FILE__, __LINE__)
+
+namespace sw::vengine::test {
+
+inline void vector_engine_assert(bool condition,
+                                    const std::string &msg,
+                                    const std::string &file,
+                                    int line) {
+    if (!condition) {
+        throw Error("ASSERT: " + msg + ". " + file + ":" + std::to_string(line));
+    }
+}
+
+// @return `num` vectors of `dim` floats uniformly distributed in [-1, 1), which are
+//         stored one after another. The same seed always generates the same vectors.
+inline std::vector<float> random_vectors(std::size_t num, std::size_t dim, uint32_t seed = 0) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+    std::vector<float> vecs(num * dim);
+    for (auto &val : vecs) {
+        val = dist(gen);
+    }
+
+    return vecs;
+}
+
+}
+
+#endif // end SW_VECTOR_ENGINE_TEST_UTILS_H
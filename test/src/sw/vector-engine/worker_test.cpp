@@ -0,0 +1,219 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#include "worker_test.h"
+#include <arpa/inet.h>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "sw/vector-engine/reactor.h"
+#include "sw/vector-engine/worker.h"
+#include "utils.h"
+
+namespace {
+
+const int PORT = 17777;
+
+const std::size_t NUM_WORKERS = 4;
+
+const std::size_t NUM_ROUNDS = 300;
+
+const char *const KEY = "worker_test";
+
+std::string command(const std::vector<std::string> &args) {
+    std::string request = "*" + std::to_string(args.size()) + "\r\n";
+    for (const auto &arg : args) {
+        request += "$" + std::to_string(arg.size()) + "\r\n" + arg + "\r\n";
+    }
+
+    return request;
+}
+
+std::string vadd(std::size_t idx) {
+    auto val = std::to_string(idx);
+    return command({"VADD", KEY, "VALUES", "2", val, val, "e" + val});
+}
+
+std::string vget(std::size_t idx) {
+    return command({"VGET", KEY, "e" + std::to_string(idx)});
+}
+
+std::string vsim(std::size_t idx) {
+    auto val = std::to_string(idx);
+    return command({"VSIM", KEY, "VALUES", "2", val, val, "COUNT", "1"});
+}
+
+std::string vdel(std::size_t idx) {
+    return command({"VDEL", KEY, "e" + std::to_string(idx)});
+}
+
+}
+
+namespace sw::vengine::test {
+
+void WorkerTest::run() {
+    auto pool = std::make_shared<WorkerPool>(NUM_WORKERS);
+
+    ReactorOptions opts;
+    opts.tcp_opts.ip = "127.0.0.1";
+    opts.tcp_opts.port = PORT;
+    opts.tcp_opts.backlog = 16;
+    opts.tcp_opts.keepalive = std::chrono::seconds(30);
+    opts.tcp_opts.nodelay = true;
+    opts.connection_opts.read_buf_chunk_size = 64 * 1024;
+    opts.connection_opts.read_buf_max_size = 20 * 1024 * 1024;
+    opts.connection_opts.read_buf_pool_size = 16;
+    opts.protocol_opts.type = ProtocolType::RESP;
+    opts.reply_queue_size = 1024;
+    opts.num_loops = 2;
+    ReactorGroup reactors(opts, pool);
+
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(PORT);
+    inet_pton(AF_INET, opts.tcp_opts.ip.c_str(), &addr.sin_addr);
+
+    auto fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    VECTOR_ENGINE_ASSERT(fd >= 0, "failed to create socket");
+
+    try {
+        VECTOR_ENGINE_ASSERT(::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0,
+                "failed to connect to the server");
+
+        int flag = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+
+        _send(fd, command({"VCREATE", KEY, "DIM", "2"}));
+        VECTOR_ENGINE_ASSERT(_recv(fd, 1).front() == "+OK", "failed to create collection");
+
+        _test_pipelined_batch(fd);
+
+        _test_separate_batches(fd);
+    } catch (...) {
+        ::close(fd);
+        reactors.stop();
+        throw;
+    }
+
+    ::close(fd);
+    reactors.stop();
+}
+
+void WorkerTest::_test_pipelined_batch(int fd) {
+    // Each write is followed by reads, including searches, which are heavy and
+    // split across workers, if they're not ordered behind the write.
+    std::string batch;
+    for (std::size_t idx = 0; idx != NUM_ROUNDS; ++idx) {
+        batch += vadd(idx) + vget(idx) + vsim(idx) + vsim(idx) + vget(idx);
+    }
+
+    // Removed elements are not seen by reads after the removal.
+    for (std::size_t idx = 0; idx != NUM_ROUNDS; idx += 3) {
+        batch += vget(idx) + vdel(idx) + vget(idx) + vadd(idx);
+    }
+
+    _send(fd, batch);
+
+    auto replies = _recv(fd, NUM_ROUNDS * 5 + (NUM_ROUNDS + 2) / 3 * 4);
+    std::size_t pos = 0;
+    for (std::size_t idx = 0; idx != NUM_ROUNDS; ++idx, pos += 5) {
+        VECTOR_ENGINE_ASSERT(replies[pos] == ":1", "wrong reply of VADD: " + replies[pos]);
+        VECTOR_ENGINE_ASSERT(replies[pos + 1] == "*2" && replies[pos + 4] == "*2",
+                "VGET does not see the VADD before it: e" + std::to_string(idx));
+    }
+
+    for (std::size_t idx = 0; idx != NUM_ROUNDS; idx += 3, pos += 4) {
+        VECTOR_ENGINE_ASSERT(replies[pos] == "*2", "VGET does not see the element: e" + std::to_string(idx));
+        VECTOR_ENGINE_ASSERT(replies[pos + 2] == "$-1",
+                "VGET does not see the VDEL before it: e" + std::to_string(idx));
+    }
+}
+
+void WorkerTest::_test_separate_batches(int fd) {
+    for (std::size_t idx = 0; idx != NUM_ROUNDS; ++idx) {
+        _send(fd, vdel(idx));
+        _send(fd, vget(idx));
+        _send(fd, vadd(idx));
+        _send(fd, vget(idx));
+    }
+
+    auto replies = _recv(fd, NUM_ROUNDS * 4);
+    for (std::size_t idx = 0; idx != NUM_ROUNDS; ++idx) {
+        VECTOR_ENGINE_ASSERT(replies[idx * 4 + 1] == "$-1",
+                "VGET does not see the VDEL sent before it: e" + std::to_string(idx));
+        VECTOR_ENGINE_ASSERT(replies[idx * 4 + 3] == "*2",
+                "VGET does not see the VADD sent before it: e" + std::to_string(idx));
+    }
+}
+
+void WorkerTest::_send(int fd, const std::string &data) {
+    std::size_t sent = 0;
+    while (sent < data.size()) {
+        auto len = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        VECTOR_ENGINE_ASSERT(len > 0, "failed to send requests");
+        sent += static_cast<std::size_t>(len);
+    }
+}
+
+std::vector<std::string> WorkerTest::_recv(int fd, std::size_t num) {
+    std::vector<std::string> replies;
+
+    // Number of lines to skip, i.e. elements of the current array reply.
+    std::size_t skip = 0;
+    std::size_t pos = 0;
+    while (replies.size() < num || skip > 0) {
+        auto end = _buffer.find("\r\n", pos);
+        if (end == std::string::npos) {
+            _buffer.erase(0, pos);
+            pos = 0;
+
+            char buf[64 * 1024];
+            auto len = ::recv(fd, buf, sizeof(buf), 0);
+            VECTOR_ENGINE_ASSERT(len > 0, "failed to receive replies");
+            _buffer.append(buf, static_cast<std::size_t>(len));
+            continue;
+        }
+
+        auto line = _buffer.substr(pos, end - pos);
+        pos = end + 2;
+
+        // Bulk strings of replies are short, i.e. no "\r\n" inside.
+        if (skip > 0) {
+            if (line[0] != '$' || line == "$-1") {
+                --skip;
+            }
+            continue;
+        }
+
+        replies.push_back(line);
+        if (line[0] == '*') {
+            // Elements of arrays in replies of this test are bulk strings, i.e. 2 lines each.
+            skip = std::strtoull(line.c_str() + 1, nullptr, 10);
+        }
+    }
+
+    _buffer.erase(0, pos);
+
+    return replies;
+}
+
+}
@@ -0,0 +1,49 @@
+/**************************************************************************
+   Copyright (c) 2025 sewenew
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ *************************************************************************/
+
+
+#ifndef SW_VECTOR_ENGINE_TEST_WORKER_TEST_H
+#define SW_VECTOR_ENGINE_TEST_WORKER_TEST_H
+
+#include <string>
+#include <vector>
+
+namespace sw::vengine::test {
+
+// Run a server with several loops and workers, and check that pipelined reads
+// see writes sent before them by the same connection.
+class WorkerTest {
+public:
+    void run();
+
+private:
+    // Writes and reads in a single pipelined batch.
+    void _test_pipelined_batch(int fd);
+
+    // Writes and reads sent separately without waiting for replies.
+    void _test_separate_batches(int fd);
+
+    void _send(int fd, const std::string &data);
+
+    // @return the first line of each of `num` replies, e.g. "*2" or "$-1".
+    std::vector<std::string> _recv(int fd, std::size_t num);
+
+    std::string _buffer;
+};
+
+}
+
+#endif // end SW_VECTOR_ENGINE_TEST_WORKER_TEST_H